@@ -0,0 +1,289 @@
+/*
+ * Benchmark - modo de execução sem janela visível para medir o desempenho das cenas
+ *
+ * Com "--benchmark N" na linha de comando, o exemplo:
+ *   - cria a janela GLFW invisível; se não houver display (DISPLAY/WAYLAND_DISPLAY),
+ *     usa a plataforma nula da GLFW 3.4 com contexto EGL "surfaceless" (funciona com o
+ *     llvmpipe do Mesa, sem GPU) e, se o EGL falhar, OSMesa;
+ *   - desenha num FBO do tamanho da cena em vez do framebuffer da janela;
+ *   - desliga o vsync, roda exatamente N frames seguindo um roteiro fixo (progress() vai
+ *     de 0 a 1; as cenas 3D usam orbitCamera) e grava as estatísticas de tempo do
+ *     FrameProfiler em JSON (--bench-out arquivo.json; sem ele, na saída padrão).
+ * Sem "--benchmark" o exemplo roda normalmente: running() só consulta a janela e
+ * beginFrame()/endFrame() apenas repassam para o profiler.
+ *
+ * Opções: --benchmark N   --bench-out arquivo.json   --bench-size LxA
+ *
+ * Teste de imagem (GoldenImage.h): com "--golden ref.png", o frame --capture-frame K
+ * (padrão: o último) é copiado para um PBO e, no final, comparado com a referência;
+ * finish() retorna false se a imagem diferir (sem arquivo de referência, o teste é pulado
+ * com um aviso). "--update-golden" grava a captura como nova referência. Tolerâncias:
+ * --golden-tolerance (por pixel, padrão 0.02) e --golden-max-fraction (fração de pixels
+ * diferentes aceita, padrão 0.001).
+ */
+
+#pragma once
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <glm/glm.hpp>
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include "FrameProfiler.h"
+#include "GoldenImage.h"
+
+class BenchmarkHarness
+{
+public:
+    BenchmarkHarness(FrameProfiler &profiler)
+        : profiler(profiler), active(false), headless(false), totalFrames(0), frame(0), width(0), height(0),
+          fbo(0), colorRB(0), depthRB(0), startTime(0.0), captureFrame(-1), updateGolden(false),
+          goldenTolerance(0.02), goldenMaxFraction(0.001)
+    {
+    }
+
+    // Lê as opções da linha de comando. Retorna false se houver opção inválida (número de
+    // frames que não é um inteiro positivo, tamanho fora do formato LxA, opção sem valor).
+    // Opções desconhecidas são ignoradas: outras classes (FramePacer) leem a mesma linha.
+    bool parseArgs(int argc, char **argv)
+    {
+        static const char *withValue[] = {"--benchmark", "--bench-out", "--bench-size", "--golden", "--capture-frame",
+                                          "--golden-tolerance", "--golden-max-fraction"};
+        for (int i = 1; i < argc; i++)
+        {
+            for (const char *opt : withValue)
+                if (strcmp(argv[i], opt) == 0 && i + 1 >= argc)
+                {
+                    fprintf(stderr, "Benchmark: %s precisa de um valor\n", opt);
+                    return false;
+                }
+            if (strcmp(argv[i], "--benchmark") == 0 && i + 1 < argc)
+            {
+                char *end = nullptr;
+                long n = strtol(argv[++i], &end, 10);
+                if (*end != '\0' || n <= 0)
+                {
+                    fprintf(stderr, "Benchmark: numero de frames invalido: %s\n", argv[i]);
+                    return false;
+                }
+                totalFrames = (int)n;
+                active = true;
+            }
+            else if (strcmp(argv[i], "--bench-out") == 0 && i + 1 < argc)
+                outputPath = argv[++i];
+            else if (strcmp(argv[i], "--bench-size") == 0 && i + 1 < argc)
+            {
+                if (sscanf(argv[++i], "%dx%d", &width, &height) != 2 || width <= 0 || height <= 0)
+                {
+                    fprintf(stderr, "Benchmark: tamanho invalido: %s (use LxA)\n", argv[i]);
+                    return false;
+                }
+            }
+            else if (strcmp(argv[i], "--golden") == 0 && i + 1 < argc)
+                goldenPath = argv[++i];
+            else if (strcmp(argv[i], "--update-golden") == 0)
+                updateGolden = true;
+            else if (strcmp(argv[i], "--capture-frame") == 0 && i + 1 < argc)
+                captureFrame = atoi(argv[++i]);
+            else if (strcmp(argv[i], "--golden-tolerance") == 0 && i + 1 < argc)
+                goldenTolerance = atof(argv[++i]);
+            else if (strcmp(argv[i], "--golden-max-fraction") == 0 && i + 1 < argc)
+                goldenMaxFraction = atof(argv[++i]);
+        }
+        if (captureFrame < 0 || captureFrame >= totalFrames)
+            captureFrame = totalFrames - 1;
+        return true;
+    }
+
+    bool enabled() const { return active; }
+    bool isHeadless() const { return headless; }
+    int frameIndex() const { return frame; }
+
+    // Posição no roteiro: 0 no primeiro frame, 1 no último
+    float progress() const
+    {
+        return totalFrames > 1 ? (float)frame / (float)(totalFrames - 1) : 0.0f;
+    }
+
+    // Substitui glfwInit(): no modo benchmark sem display, escolhe a plataforma nula
+    bool initGLFW()
+    {
+        if (active && !getenv("DISPLAY") && !getenv("WAYLAND_DISPLAY"))
+        {
+            headless = true;
+            glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
+#ifndef _WIN32
+            // O Mesa escolhe a plataforma EGL por esta variável (sem sobrescrever a do usuário)
+            setenv("EGL_PLATFORM", "surfaceless", 0);
+#endif
+        }
+        return glfwInit() == GLFW_TRUE;
+    }
+
+    // Substitui glfwCreateWindow(): janela invisível no modo benchmark
+    GLFWwindow *createWindow(int w, int h, const char *title)
+    {
+        if (width == 0 || height == 0)
+        {
+            width = w;
+            height = h;
+        }
+        if (!active)
+            return glfwCreateWindow(w, h, title, nullptr, nullptr);
+
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+        glfwWindowHint(GLFW_SAMPLES, 0); // o FBO não tem MSAA
+        if (!headless)
+            return glfwCreateWindow(width, height, title, nullptr, nullptr);
+
+        glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_EGL_CONTEXT_API);
+        GLFWwindow *window = glfwCreateWindow(width, height, title, nullptr, nullptr);
+        if (!window)
+        {
+            glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_OSMESA_CONTEXT_API);
+            window = glfwCreateWindow(width, height, title, nullptr, nullptr);
+        }
+        return window;
+    }
+
+    // Depois de carregar a GLAD: cria o FBO e as queries do profiler
+    void setup()
+    {
+        profiler.init();
+        if (!active)
+            return;
+        profiler.setHistory(totalFrames); // as estatísticas cobrem todos os frames medidos
+
+        glfwSwapInterval(0);
+
+        glGenRenderbuffers(1, &colorRB);
+        glBindRenderbuffer(GL_RENDERBUFFER, colorRB);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+        glGenRenderbuffers(1, &depthRB);
+        glBindRenderbuffer(GL_RENDERBUFFER, depthRB);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+        glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+        glGenFramebuffers(1, &fbo);
+        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, colorRB);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, depthRB);
+        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+            fprintf(stderr, "Benchmark: FBO incompleto\n");
+        glViewport(0, 0, width, height);
+
+        const GLubyte *renderer = glGetString(GL_RENDERER);
+        rendererName = renderer ? (const char *)renderer : "?";
+        startTime = glfwGetTime();
+    }
+
+    // Substitui o teste do laço principal
+    bool running(GLFWwindow *window) const
+    {
+        if (active)
+            return frame < totalFrames;
+        return !glfwWindowShouldClose(window);
+    }
+
+    void beginFrame()
+    {
+        if (active)
+            glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+        profiler.beginFrame();
+    }
+
+    void endFrame()
+    {
+        // A cópia para o PBO entra na fila da GPU; só é lida em finish()
+        if (active && !goldenPath.empty() && frame == captureFrame)
+        {
+            glBindFramebuffer(GL_READ_FRAMEBUFFER, fbo);
+            glReadBuffer(GL_COLOR_ATTACHMENT0);
+            capture.request(width, height);
+        }
+        profiler.endFrame();
+        frame++;
+    }
+
+    // Câmera do roteiro 3D: uma volta completa em torno de "center", olhando para ele
+    void orbitCamera(glm::vec3 center, float radius, float height, glm::vec3 &pos, glm::vec3 &front) const
+    {
+        float angle = progress() * 6.2831853f;
+        pos = center + glm::vec3(radius * cosf(angle), height, radius * sinf(angle));
+        front = glm::normalize(center - pos);
+    }
+
+    // Ao final da execução: grava o relatório, confere a imagem de referência (se pedida)
+    // e libera o FBO. Retorna false se a comparação com a referência falhar.
+    bool finish(const char *scene)
+    {
+        if (!active)
+            return true;
+        glFinish();
+        double totalSeconds = glfwGetTime() - startTime;
+
+        FILE *f = outputPath.empty() ? stdout : fopen(outputPath.c_str(), "w");
+        if (!f)
+        {
+            fprintf(stderr, "Benchmark: nao foi possivel gravar %s\n", outputPath.c_str());
+            return false;
+        }
+        fprintf(f, "{\n");
+        fprintf(f, "  \"scene\": \"%s\",\n", scene);
+        fprintf(f, "  \"renderer\": \"%s\",\n", rendererName.c_str());
+        fprintf(f, "  \"headless\": %s,\n", headless ? "true" : "false");
+        fprintf(f, "  \"width\": %d,\n  \"height\": %d,\n", width, height);
+        fprintf(f, "  \"frames\": %d,\n", frame);
+        fprintf(f, "  \"total_s\": %.4f,\n", totalSeconds);
+        fprintf(f, "  \"avg_fps\": %.2f,\n", totalSeconds > 0.0 ? frame / totalSeconds : 0.0);
+        writeStat(f, "frame_ms", profiler.frameStat(), false);
+        writeStat(f, "cpu_ms", profiler.cpuStat(), false);
+        writeStat(f, "gpu_ms", profiler.gpuStat(), true);
+        fprintf(f, "}\n");
+        if (f != stdout)
+            fclose(f);
+
+        bool passed = true;
+        if (!goldenPath.empty())
+        {
+            std::vector<uint8_t> pixels;
+            passed = capture.read(pixels) &&
+                     checkGolden(pixels, width, height, goldenPath.c_str(), scene, updateGolden, goldenTolerance, goldenMaxFraction);
+            capture.destroy();
+        }
+
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        glDeleteFramebuffers(1, &fbo);
+        glDeleteRenderbuffers(1, &colorRB);
+        glDeleteRenderbuffers(1, &depthRB);
+        return passed;
+    }
+
+private:
+    FrameProfiler &profiler;
+    bool active, headless;
+    int totalFrames, frame;
+    int width, height;
+    GLuint fbo, colorRB, depthRB;
+    double startTime;
+    std::string outputPath, rendererName;
+
+    FrameCapture capture;
+    std::string goldenPath;
+    int captureFrame;
+    bool updateGolden;
+    double goldenTolerance, goldenMaxFraction;
+
+    // O anel do profiler cobre todos os frames da execução; "samples" é quantos entraram
+    // de fato (o primeiro frame não tem intervalo e a GPU pode não ter respondido a tempo)
+    static void writeStat(FILE *f, const char *name, const ProfileStat &s, bool last)
+    {
+        fprintf(f, "  \"%s\": {\"min\": %.4f, \"avg\": %.4f, \"p99\": %.4f, \"samples\": %d}%s\n",
+                name, s.min, s.avg, s.p99, s.samples, last ? "" : ",");
+    }
+};
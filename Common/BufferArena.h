@@ -0,0 +1,221 @@
+/*
+ * BufferArena - subalocação de trechos dentro de um único buffer OpenGL
+ *
+ * Um buffer grande (de vértices ou de índices) é dividido em trechos contíguos, um por
+ * dono (ex.: um chunk do mundo voxel). Os deslocamentos são medidos em elementos, não em
+ * bytes, porque é assim que o DrawElementsIndirectCommand os usa (firstIndex, baseVertex).
+ *
+ * - allocate(): first-fit numa lista de livres ordenada por deslocamento;
+ * - release(): devolve o trecho e funde com os vizinhos livres;
+ * - defragment(): quando há espaço livre suficiente mas nenhum trecho contíguo grande o
+ *   bastante (típico depois de muitos remeshes), compacta todos os trechos vivos no início
+ *   do buffer. A cópia é feita na GPU (glCopyBufferSubData) através de um buffer temporário,
+ *   então o identificador do buffer não muda e os VAOs continuam válidos;
+ * - grow(): cria um buffer maior, já compactado (o identificador muda!).
+ *
+ * Os trechos que mudaram de lugar são devolvidos como uma lista (dono, novo deslocamento)
+ * para que quem guarda os deslocamentos possa atualizá-los.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <iterator>
+#include <map>
+#include <vector>
+
+#include <glad/glad.h>
+
+const GLuint ARENA_INVALID = 0xFFFFFFFFu;
+
+struct ArenaMove
+{
+    uint32_t owner;
+    GLuint newOffset;
+};
+
+class BufferArena
+{
+public:
+    BufferArena() : bufferID(0), elementSize(0), capacityElems(0), usedElems(0) {}
+
+    void init(GLuint elemSize, GLuint capacity)
+    {
+        elementSize = elemSize;
+        capacityElems = capacity;
+        usedElems = 0;
+        live.clear();
+        freeBlocks.clear();
+        freeBlocks[0] = capacity;
+
+        glGenBuffers(1, &bufferID);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, bufferID);
+        glBufferData(GL_COPY_WRITE_BUFFER, (GLsizeiptr)capacity * elementSize, nullptr, GL_STATIC_DRAW);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    }
+
+    void destroy()
+    {
+        glDeleteBuffers(1, &bufferID);
+        bufferID = 0;
+    }
+
+    // Reserva "count" elementos para "owner". Retorna o deslocamento ou ARENA_INVALID.
+    GLuint allocate(GLuint count, uint32_t owner)
+    {
+        if (count == 0)
+            return ARENA_INVALID;
+        for (auto it = freeBlocks.begin(); it != freeBlocks.end(); ++it)
+        {
+            if (it->second >= count)
+            {
+                GLuint offset = it->first;
+                GLuint remaining = it->second - count;
+                freeBlocks.erase(it);
+                if (remaining > 0)
+                    freeBlocks[offset + count] = remaining;
+                live[offset] = {count, owner};
+                usedElems += count;
+                return offset;
+            }
+        }
+        return ARENA_INVALID;
+    }
+
+    void release(GLuint offset)
+    {
+        auto it = live.find(offset);
+        if (it == live.end())
+            return;
+        GLuint count = it->second.count;
+        usedElems -= count;
+        live.erase(it);
+
+        // Insere e funde com o livre seguinte e o anterior
+        auto next = freeBlocks.lower_bound(offset);
+        if (next != freeBlocks.end() && offset + count == next->first)
+        {
+            count += next->second;
+            next = freeBlocks.erase(next);
+        }
+        if (next != freeBlocks.begin())
+        {
+            auto prev = std::prev(next);
+            if (prev->first + prev->second == offset)
+            {
+                prev->second += count;
+                return;
+            }
+        }
+        freeBlocks[offset] = count;
+    }
+
+    // Envia dados para um trecho já alocado
+    void upload(GLuint offset, GLuint count, const void *data)
+    {
+        glBindBuffer(GL_COPY_WRITE_BUFFER, bufferID);
+        glBufferSubData(GL_COPY_WRITE_BUFFER, (GLintptr)offset * elementSize, (GLsizeiptr)count * elementSize, data);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    }
+
+    // Compacta os trechos vivos no início do buffer, mantendo o mesmo identificador
+    std::vector<ArenaMove> defragment()
+    {
+        return relocate(capacityElems, false);
+    }
+
+    // Troca por um buffer maior (já compactado). O identificador do buffer muda.
+    std::vector<ArenaMove> grow(GLuint newCapacity)
+    {
+        return relocate(newCapacity, true);
+    }
+
+    // 0 = todo o espaço livre é contíguo; perto de 1 = livre muito picotado
+    float fragmentation() const
+    {
+        GLuint totalFree = capacityElems - usedElems;
+        if (totalFree == 0)
+            return 0.0f;
+        return 1.0f - (float)largestFree() / (float)totalFree;
+    }
+
+    GLuint largestFree() const
+    {
+        GLuint largest = 0;
+        for (auto &f : freeBlocks)
+            if (f.second > largest)
+                largest = f.second;
+        return largest;
+    }
+
+    GLuint buffer() const { return bufferID; }
+    GLuint capacity() const { return capacityElems; }
+    GLuint used() const { return usedElems; }
+    GLuint freeElements() const { return capacityElems - usedElems; }
+    GLuint stride() const { return elementSize; }
+
+private:
+    struct Block
+    {
+        GLuint count;
+        uint32_t owner;
+    };
+
+    std::vector<ArenaMove> relocate(GLuint newCapacity, bool newBuffer)
+    {
+        std::vector<ArenaMove> moves;
+
+        // Na compactação o temporário só precisa comportar os trechos vivos
+        GLuint tempElems = newBuffer ? newCapacity : (usedElems > 0 ? usedElems : 1);
+        GLuint temp;
+        glGenBuffers(1, &temp);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, temp);
+        glBufferData(GL_COPY_WRITE_BUFFER, (GLsizeiptr)tempElems * elementSize, nullptr, newBuffer ? GL_STATIC_DRAW : GL_STREAM_COPY);
+        glBindBuffer(GL_COPY_READ_BUFFER, bufferID);
+
+        // Copia cada trecho vivo, em ordem, para o início do buffer temporário
+        std::map<GLuint, Block> packed;
+        GLuint cursor = 0;
+        for (auto &b : live)
+        {
+            glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER,
+                                (GLintptr)b.first * elementSize, (GLintptr)cursor * elementSize,
+                                (GLsizeiptr)b.second.count * elementSize);
+            if (b.first != cursor)
+                moves.push_back({b.second.owner, cursor});
+            packed[cursor] = b.second;
+            cursor += b.second.count;
+        }
+
+        if (newBuffer)
+        {
+            glDeleteBuffers(1, &bufferID);
+            bufferID = temp;
+            capacityElems = newCapacity;
+        }
+        else
+        {
+            // Volta a parte compactada para o buffer original
+            glBindBuffer(GL_COPY_READ_BUFFER, temp);
+            glBindBuffer(GL_COPY_WRITE_BUFFER, bufferID);
+            if (cursor > 0)
+                glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, (GLsizeiptr)cursor * elementSize);
+            glDeleteBuffers(1, &temp);
+        }
+        glBindBuffer(GL_COPY_READ_BUFFER, 0);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+        live.swap(packed);
+        freeBlocks.clear();
+        if (cursor < capacityElems)
+            freeBlocks[cursor] = capacityElems - cursor;
+        return moves;
+    }
+
+    GLuint bufferID;
+    GLuint elementSize;
+    GLuint capacityElems;
+    GLuint usedElems;
+    std::map<GLuint, Block> live;       // deslocamento -> trecho alocado
+    std::map<GLuint, GLuint> freeBlocks; // deslocamento -> tamanho livre
+};
@@ -0,0 +1,119 @@
+/*
+ * Camera2D - câmera 2D com deslocamento, zoom e faixa de tiles visíveis
+ *
+ * A câmera guarda o ponto do mundo no centro da tela (center) e o zoom (pixels de tela
+ * por unidade de mundo). A tela tem viewport.x x viewport.y pixels, com y para cima,
+ * como na projeção ortográfica dos exemplos; projection() devolve a ortho() do retângulo
+ * do mundo que aparece nela.
+ *
+ * Nada é arredondado para o pixel: center e zoom são floats e follow() suaviza o
+ * movimento com um decaimento exponencial que não depende do FPS, então a rolagem anda
+ * frações de pixel de um frame para o outro.
+ *
+ * visibleTiles() converte o retângulo visível em colunas/linhas de um mapa de tiles (com
+ * a linha 0 no topo, como em HelloTiles), com uma margem de vizinhos. Quem percorre só
+ * essa faixa tem custo proporcional ao tamanho da tela, não ao tamanho do mapa.
+ */
+
+#pragma once
+
+#include <cmath>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+// Faixa de tiles [col0, col1] x [row0, row1], já recortada ao mapa (vazia se col1 < col0)
+struct TileRange
+{
+    int col0, row0, col1, row1;
+
+    bool empty() const { return col1 < col0 || row1 < row0; }
+    int count() const { return empty() ? 0 : (col1 - col0 + 1) * (row1 - row0 + 1); }
+};
+
+class Camera2D
+{
+public:
+    glm::vec2 center;
+    float zoom;
+    float minZoom, maxZoom;
+    glm::vec2 viewport; // tamanho da tela, em pixels
+
+    Camera2D(float width, float height)
+        : center(width * 0.5f, height * 0.5f), zoom(1.0f), minZoom(0.25f), maxZoom(4.0f), viewport(width, height) {}
+
+    // Meia-largura e meia-altura da vista, em unidades do mundo
+    glm::vec2 halfExtent() const { return viewport * (0.5f / zoom); }
+
+    void visibleRect(float &minX, float &minY, float &maxX, float &maxY) const
+    {
+        glm::vec2 h = halfExtent();
+        minX = center.x - h.x;
+        minY = center.y - h.y;
+        maxX = center.x + h.x;
+        maxY = center.y + h.y;
+    }
+
+    glm::mat4 projection() const
+    {
+        glm::vec2 h = halfExtent();
+        return glm::ortho(center.x - h.x, center.x + h.x, center.y - h.y, center.y + h.y, -1.0f, 1.0f);
+    }
+
+    // Ponto da tela (pixels, y para cima) no mundo, e o contrário
+    glm::vec2 screenToWorld(const glm::vec2 &screen) const { return center + (screen - viewport * 0.5f) / zoom; }
+    glm::vec2 worldToScreen(const glm::vec2 &world) const { return (world - center) * zoom + viewport * 0.5f; }
+
+    // Desloca a vista por um arrasto em pixels de tela
+    void pan(const glm::vec2 &screenDelta) { center += screenDelta / zoom; }
+
+    // Multiplica o zoom mantendo parado o ponto do mundo sob screenPoint (ex.: o cursor)
+    void zoomAt(const glm::vec2 &screenPoint, float factor)
+    {
+        glm::vec2 anchor = screenToWorld(screenPoint);
+        zoom = glm::clamp(zoom * factor, minZoom, maxZoom);
+        center = anchor - (screenPoint - viewport * 0.5f) / zoom;
+    }
+
+    // Aproxima o centro do alvo: metade da distância some a cada halfLife segundos
+    void follow(const glm::vec2 &target, float dt, float halfLife)
+    {
+        if (halfLife <= 0.0f)
+        {
+            center = target;
+            return;
+        }
+        float k = 1.0f - exp2f(-dt / halfLife);
+        center += (target - center) * k;
+    }
+
+    // Mantém a vista dentro do retângulo do mundo; se ele for menor que a vista, centraliza
+    void clampTo(float minX, float minY, float maxX, float maxY)
+    {
+        glm::vec2 h = halfExtent();
+        center.x = (maxX - minX <= 2.0f * h.x) ? (minX + maxX) * 0.5f : glm::clamp(center.x, minX + h.x, maxX - h.x);
+        center.y = (maxY - minY <= 2.0f * h.y) ? (minY + maxY) * 0.5f : glm::clamp(center.y, minY + h.y, maxY - h.y);
+    }
+
+    // Tiles do mapa (canto superior esquerdo em (left, top), y para cima) que aparecem na
+    // tela, mais "margin" vizinhos em cada direção
+    TileRange visibleTiles(float left, float top, float tileW, float tileH, int cols, int rows, int margin = 1) const
+    {
+        float minX, minY, maxX, maxY;
+        visibleRect(minX, minY, maxX, maxY);
+        TileRange r;
+        r.col0 = (int)floorf((minX - left) / tileW) - margin;
+        r.col1 = (int)floorf((maxX - left) / tileW) + margin;
+        r.row0 = (int)floorf((top - maxY) / tileH) - margin;
+        r.row1 = (int)floorf((top - minY) / tileH) + margin;
+        if (r.col0 < 0)
+            r.col0 = 0;
+        if (r.row0 < 0)
+            r.row0 = 0;
+        if (r.col1 > cols - 1)
+            r.col1 = cols - 1;
+        if (r.row1 > rows - 1)
+            r.row1 = rows - 1;
+        return r;
+    }
+};
@@ -0,0 +1,117 @@
+/*
+ * CameraUBO - matrizes da câmera num Uniform Buffer Object compartilhado
+ *
+ * Em vez de cada programa de shader receber "view" e "proj" como uniforms separados
+ * (um glGetUniformLocation + glUniformMatrix4fv por programa, por frame), as matrizes
+ * ficam num único buffer ligado ao ponto fixo CAMERA_UBO_BINDING. Todos os programas
+ * que declaram o bloco abaixo leem do mesmo buffer:
+ *
+ *   layout (std140, binding = 0) uniform Camera
+ *   {
+ *       mat4 view;
+ *       mat4 proj;
+ *       mat4 viewProj;
+ *       vec4 cameraPos;
+ *   };
+ *
+ * (Shaders com #version < 420 não aceitam "binding = 0": nesse caso chame
+ * CameraUBO::bindProgram(programa) depois de linkar.)
+ *
+ * update() só recalcula lookAt/perspective e envia o buffer quando posição, direção,
+ * FOV ou proporção da tela mudaram desde o último envio.
+ */
+
+#pragma once
+
+#include <glad/glad.h>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+const GLuint CAMERA_UBO_BINDING = 0;
+
+// Layout std140: mat4 e vec4 já são alinhados a 16 bytes, então a struct C++ bate com o bloco
+struct CameraBlock
+{
+    glm::mat4 view;
+    glm::mat4 proj;
+    glm::mat4 viewProj;
+    glm::vec4 cameraPos;
+};
+
+class CameraUBO
+{
+public:
+    CameraUBO() : uboID(0), valid(false), uploads(0) {}
+
+    void init()
+    {
+        glGenBuffers(1, &uboID);
+        glBindBuffer(GL_UNIFORM_BUFFER, uboID);
+        glBufferData(GL_UNIFORM_BUFFER, sizeof(CameraBlock), nullptr, GL_DYNAMIC_DRAW);
+        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+        glBindBufferBase(GL_UNIFORM_BUFFER, CAMERA_UBO_BINDING, uboID);
+        valid = false;
+    }
+
+    // Liga o bloco "Camera" de um programa ao ponto fixo (para GLSL < 4.20)
+    static void bindProgram(GLuint program)
+    {
+        GLuint index = glGetUniformBlockIndex(program, "Camera");
+        if (index != GL_INVALID_INDEX)
+            glUniformBlockBinding(program, index, CAMERA_UBO_BINDING);
+    }
+
+    // Atualiza o buffer se algum parâmetro mudou. Retorna true se houve envio.
+    bool update(const glm::vec3 &pos, const glm::vec3 &front, const glm::vec3 &up,
+                float fovDegrees, float aspect, float zNear, float zFar)
+    {
+        if (valid && pos == lastPos && front == lastFront && up == lastUp &&
+            fovDegrees == lastFov && aspect == lastAspect && zNear == lastNear && zFar == lastFar)
+        {
+            return false;
+        }
+
+        block.view = glm::lookAt(pos, pos + front, up);
+        block.proj = glm::perspective(glm::radians(fovDegrees), aspect, zNear, zFar);
+        block.viewProj = block.proj * block.view;
+        block.cameraPos = glm::vec4(pos, 1.0f);
+
+        glBindBuffer(GL_UNIFORM_BUFFER, uboID);
+        glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(CameraBlock), &block);
+        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+        lastPos = pos;
+        lastFront = front;
+        lastUp = up;
+        lastFov = fovDegrees;
+        lastAspect = aspect;
+        lastNear = zNear;
+        lastFar = zFar;
+        valid = true;
+        uploads++;
+        return true;
+    }
+
+    // Força o próximo update() a reenviar (ex.: após trocar de contexto)
+    void invalidate() { valid = false; }
+
+    const CameraBlock &data() const { return block; }
+    GLuint buffer() const { return uboID; }
+    int uploadCount() const { return uploads; }
+
+    void destroy()
+    {
+        glDeleteBuffers(1, &uboID);
+        uboID = 0;
+    }
+
+private:
+    GLuint uboID;
+    CameraBlock block;
+    bool valid;
+    int uploads;
+    glm::vec3 lastPos, lastFront, lastUp;
+    float lastFov, lastAspect, lastNear, lastFar;
+};
@@ -0,0 +1,217 @@
+/*
+ * ChunkMesher - gera a malha indexada de um chunk do VoxelWorld
+ *
+ * Só são emitidas as faces de blocos sólidos que encostam em ar (as demais nunca são
+ * vistas). Cada face vira 4 vértices e 6 índices. Os índices são locais ao chunk
+ * (começam em 0), pois no desenho indireto o baseVertex do comando desloca o trecho
+ * do chunk dentro da arena de vértices. Um chunk tem no máximo 16^3 / 2 * 6 faces
+ * expostas (tabuleiro de xadrez) = 49152 vértices, então índices de 16 bits bastam.
+ *
+ * Vértice compactado em 8 bytes (decodificado no vertex shader):
+ *   palavra a: bits  0-4  x local (0..16)
+ *              bits  5-9  y local
+ *              bits 10-14 z local
+ *              bits 15-17 índice da normal (face, ver FACE_NORMALS)
+ *              bits 18-19 canto da face (0..3, define a coordenada de textura)
+ *              bits 20-21 oclusão ambiente (0 = mais escuro, 3 = sem oclusão, ver VoxelAO.h)
+ *   palavra b: bits  0-15 camada da textura array
+ *              bits 16-19 luz do sol no canto (0..15, ver VoxelLight.h)
+ *              bits 20-23 luz de blocos no canto
+ * Comparado a 5 floats por vértice sem índices (HelloMinecraft: 6 vértices de 20 bytes
+ * por face = 120 bytes), uma face aqui ocupa 4 * 8 + 6 * 2 = 44 bytes.
+ *
+ * Antes de gerar a malha, o chunk é copiado para um bloco local de 18x18x18 que inclui
+ * uma borda de 1 voxel dos chunks vizinhos: assim o teste de vizinhança é um acesso
+ * direto a vetor, sem consultar o mundo bloco a bloco. A mesma borda serve para a oclusão
+ * ambiente: os 3 blocos em volta de cada canto de face também caem dentro dela.
+ *
+ * A luz é copiada junto com os blocos. Cada canto recebe a média da luz das células de
+ * ar que encostam nele do lado de fora da face (as mesmas da oclusão, mais a da frente),
+ * o que dá a transição suave entre os níveis inteiros da BFS.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "VoxelWorld.h"
+#include "VoxelAO.h"
+
+// Formato de vértice dos chunks (8 bytes, ver o layout acima)
+struct ChunkVertex
+{
+    uint32_t a;
+    uint32_t b;
+};
+
+typedef uint16_t ChunkIndex;
+
+inline ChunkVertex packChunkVertex(int x, int y, int z, int normal, int corner, int ao, int layer, int sun = 15,
+                                   int blockLight = 0)
+{
+    ChunkVertex v;
+    v.a = (uint32_t)x | ((uint32_t)y << 5) | ((uint32_t)z << 10) |
+          ((uint32_t)normal << 15) | ((uint32_t)corner << 18) | ((uint32_t)ao << 20);
+    v.b = ((uint32_t)layer & 0xFFFF) | ((uint32_t)sun << 16) | ((uint32_t)blockLight << 20);
+    return v;
+}
+
+// Faces: 0 +X, 1 -X, 2 +Y, 3 -Y, 4 +Z, 5 -Z
+const int FACE_NORMALS[6][3] = {
+    {1, 0, 0}, {-1, 0, 0}, {0, 1, 0}, {0, -1, 0}, {0, 0, 1}, {0, 0, -1}};
+
+// Cantos de cada face em ordem anti-horária vista de fora:
+// base esq, base dir, topo dir, topo esq
+const int FACE_CORNERS[6][4][3] = {
+    {{1, 0, 1}, {1, 0, 0}, {1, 1, 0}, {1, 1, 1}}, // +X
+    {{0, 0, 0}, {0, 0, 1}, {0, 1, 1}, {0, 1, 0}}, // -X
+    {{0, 1, 1}, {1, 1, 1}, {1, 1, 0}, {0, 1, 0}}, // +Y
+    {{0, 0, 0}, {1, 0, 0}, {1, 0, 1}, {0, 0, 1}}, // -Y
+    {{0, 0, 1}, {1, 0, 1}, {1, 1, 1}, {0, 1, 1}}, // +Z
+    {{1, 0, 0}, {0, 0, 0}, {0, 1, 0}, {1, 1, 0}}, // -Z
+};
+
+class ChunkMesher
+{
+public:
+    static const int PADDED = CHUNK_SIZE + 2;
+
+    std::vector<ChunkVertex> vertices;
+    std::vector<ChunkIndex> indices;
+
+    // Desligada, todo vértice sai com oclusão 3 e a diagonal padrão (para comparação)
+    bool ambientOcclusion = true;
+    // Desligada, todo vértice sai com sol 15 e sem luz de blocos (mundo sem VoxelLighting)
+    bool bakeLight = true;
+
+    // Gera a malha do chunk "index". Os resultados ficam em vertices/indices.
+    void mesh(const VoxelWorld &world, int index)
+    {
+        vertices.clear();
+        indices.clear();
+        if (world.chunk(index).solidCount == 0)
+            return;
+
+        gather(world, index);
+
+        for (int y = 0; y < CHUNK_SIZE; y++)
+        {
+            for (int z = 0; z < CHUNK_SIZE; z++)
+            {
+                for (int x = 0; x < CHUNK_SIZE; x++)
+                {
+                    uint8_t type = at(x, y, z);
+                    if (type == BLOCK_AIR)
+                        continue;
+                    for (int f = 0; f < 6; f++)
+                    {
+                        const int *n = FACE_NORMALS[f];
+                        if (at(x + n[0], y + n[1], z + n[2]) != BLOCK_AIR)
+                            continue;
+                        emitFace(x, y, z, f, type);
+                    }
+                }
+            }
+        }
+    }
+
+private:
+    uint8_t padded[PADDED * PADDED * PADDED];
+    uint8_t paddedLight[PADDED * PADDED * PADDED];
+
+    // Acesso em coordenadas locais, de -1 a 16
+    uint8_t at(int x, int y, int z) const
+    {
+        return padded[(x + 1) + (z + 1) * PADDED + (y + 1) * PADDED * PADDED];
+    }
+
+    uint8_t lightAt(int x, int y, int z) const
+    {
+        return paddedLight[(x + 1) + (z + 1) * PADDED + (y + 1) * PADDED * PADDED];
+    }
+
+    void gather(const VoxelWorld &world, int index)
+    {
+        glm::ivec3 c = world.chunkCoord(index);
+        int ox = c.x * CHUNK_SIZE, oy = c.y * CHUNK_SIZE, oz = c.z * CHUNK_SIZE;
+        const Chunk &chunk = world.chunk(index);
+
+        for (int y = -1; y <= CHUNK_SIZE; y++)
+        {
+            for (int z = -1; z <= CHUNK_SIZE; z++)
+            {
+                for (int x = -1; x <= CHUNK_SIZE; x++)
+                {
+                    bool interior = x >= 0 && y >= 0 && z >= 0 && x < CHUNK_SIZE && y < CHUNK_SIZE && z < CHUNK_SIZE;
+                    int i = (x + 1) + (z + 1) * PADDED + (y + 1) * PADDED * PADDED;
+                    if (interior)
+                    {
+                        padded[i] = chunk.blocks[blockIndex(x, y, z)];
+                        paddedLight[i] = chunk.light[blockIndex(x, y, z)];
+                    }
+                    else
+                    {
+                        padded[i] = world.getBlock(ox + x, oy + y, oz + z);
+                        paddedLight[i] = world.getLight(ox + x, oy + y, oz + z);
+                    }
+                }
+            }
+        }
+    }
+
+    void emitFace(int x, int y, int z, int face, uint8_t type)
+    {
+        int ao[4] = {3, 3, 3, 3};
+        if (ambientOcclusion)
+        {
+            auto solid = [this](int bx, int by, int bz) { return at(bx, by, bz) != BLOCK_AIR; };
+            for (int c = 0; c < 4; c++)
+                ao[c] = faceCornerAO(solid, x, y, z, FACE_NORMALS[face], FACE_CORNERS[face][c]);
+        }
+
+        int sun[4] = {15, 15, 15, 15}, blockLight[4] = {0, 0, 0, 0};
+        if (bakeLight)
+            for (int c = 0; c < 4; c++)
+                cornerLight(x, y, z, face, c, sun[c], blockLight[c]);
+
+        ChunkIndex base = (ChunkIndex)vertices.size();
+        for (int c = 0; c < 4; c++)
+        {
+            const int *corner = FACE_CORNERS[face][c];
+            vertices.push_back(packChunkVertex(x + corner[0], y + corner[1], z + corner[2], face, c, ao[c], type - 1,
+                                               sun[c], blockLight[c]));
+        }
+        // Diagonal entre os cantos mais claros, para a sombra não sair torta
+        int first = aoFlipQuad(ao) ? 1 : 0;
+        indices.push_back(base + first);
+        indices.push_back(base + (first + 1) % 4);
+        indices.push_back(base + (first + 2) % 4);
+        indices.push_back(base + first);
+        indices.push_back(base + (first + 2) % 4);
+        indices.push_back(base + (first + 3) % 4);
+    }
+
+    // Média da luz das células de ar em volta do canto. A da frente é sempre ar (a face
+    // está exposta); a da diagonal só conta se não estiver escondida pelos dois lados.
+    void cornerLight(int x, int y, int z, int face, int c, int &sun, int &blockLight) const
+    {
+        FaceCornerSamples s = faceCornerSamples(x, y, z, FACE_NORMALS[face], FACE_CORNERS[face][c]);
+        bool open1 = at(s.side1[0], s.side1[1], s.side1[2]) == BLOCK_AIR;
+        bool open2 = at(s.side2[0], s.side2[1], s.side2[2]) == BLOCK_AIR;
+        const int *cells[4] = {s.front, s.side1, s.side2, s.corner};
+        bool use[4] = {true, open1, open2, (open1 || open2) && at(s.corner[0], s.corner[1], s.corner[2]) == BLOCK_AIR};
+        int sunSum = 0, blockSum = 0, count = 0;
+        for (int k = 0; k < 4; k++)
+        {
+            if (!use[k])
+                continue;
+            uint8_t l = lightAt(cells[k][0], cells[k][1], cells[k][2]);
+            sunSum += l >> 4;
+            blockSum += l & 15;
+            count++;
+        }
+        sun = (sunSum + count / 2) / count;
+        blockLight = (blockSum + count / 2) / count;
+    }
+};
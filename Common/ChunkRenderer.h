@@ -0,0 +1,363 @@
+/*
+ * ChunkRenderer - desenha todos os chunks do VoxelWorld com um único glMultiDrawElementsIndirect
+ *
+ * - As malhas de todos os chunks moram em duas arenas (BufferArena): uma de vértices e uma
+ *   de índices. Cada chunk ocupa um trecho de cada uma.
+ * - A cada frame os chunks com geometria passam por um teste de frustum (AABB contra os 6
+ *   planos extraídos de proj * view). Para os visíveis é escrito um
+ *   DrawElementsIndirectCommand (firstIndex e baseVertex apontam o trecho do chunk nas arenas)
+ *   num StreamBuffer, e o mundo inteiro sai numa chamada só.
+ * - A posição do chunk no mundo vem de um atributo instanciado (divisor 1) lido de um buffer
+ *   estático com a origem de cada chunk. Como cada comando desenha 1 instância com
+ *   baseInstance = índice do chunk, o vertex shader recebe a origem certa sem nenhum uniform.
+ * - Sem multi-draw indireto (OpenGL < 4.3) sai um draw por chunk, ainda com baseInstance.
+ *   Sem baseInstance (OpenGL < 4.2, sem ARB_base_instance) o atributo instanciado fica
+ *   desligado (vale 0) e a origem de cada chunk vai no uniform informado em
+ *   setOriginUniform(), antes de cada glDrawElementsBaseVertex.
+ * - Quando um chunk é refeito (remesh), seus trechos antigos voltam para as arenas; se não houver
+ *   trecho contíguo livre, a arena é compactada (defragment) e os deslocamentos são corrigidos.
+ *
+ * Layout dos atributos esperado pelo vertex shader:
+ *   location 0: uvec2 vértice compactado (ver ChunkMesher.h)
+ *   location 3: vec4 origem do chunk (instanciado)
+ *   uniform vec4 somado à origem (só usado sem baseInstance; 0 nos outros caminhos)
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include <iostream>
+
+#include <glad/glad.h>
+
+#include <glm/glm.hpp>
+
+#include "GLExt.h"
+#include "BufferArena.h"
+#include "StreamBuffer.h"
+#include "VoxelWorld.h"
+#include "ChunkMesher.h"
+
+// Layout definido pela especificação OpenGL para os comandos indiretos
+struct DrawElementsIndirectCommand
+{
+    GLuint count;
+    GLuint instanceCount;
+    GLuint firstIndex;
+    GLint baseVertex;
+    GLuint baseInstance;
+};
+
+// Onde está a malha de cada chunk dentro das arenas
+struct ChunkDraw
+{
+    GLuint vertexOffset, vertexCount;
+    GLuint indexOffset, indexCount;
+};
+
+// Planos do frustum extraídos da matriz proj * view (método de Gribb/Hartmann)
+inline void extractFrustumPlanes(const glm::mat4 &m, glm::vec4 planes[6])
+{
+    glm::vec4 row0(m[0][0], m[1][0], m[2][0], m[3][0]);
+    glm::vec4 row1(m[0][1], m[1][1], m[2][1], m[3][1]);
+    glm::vec4 row2(m[0][2], m[1][2], m[2][2], m[3][2]);
+    glm::vec4 row3(m[0][3], m[1][3], m[2][3], m[3][3]);
+    planes[0] = row3 + row0; // esquerda
+    planes[1] = row3 - row0; // direita
+    planes[2] = row3 + row1; // baixo
+    planes[3] = row3 - row1; // cima
+    planes[4] = row3 + row2; // perto
+    planes[5] = row3 - row2; // longe
+}
+
+// A caixa está fora se o canto mais "positivo" em relação a algum plano estiver atrás dele
+inline bool aabbInFrustum(const glm::vec4 planes[6], const glm::vec3 &bmin, const glm::vec3 &bmax)
+{
+    for (int i = 0; i < 6; i++)
+    {
+        const glm::vec4 &p = planes[i];
+        float x = p.x >= 0.0f ? bmax.x : bmin.x;
+        float y = p.y >= 0.0f ? bmax.y : bmin.y;
+        float z = p.z >= 0.0f ? bmax.z : bmin.z;
+        if (p.x * x + p.y * y + p.z * z + p.w < 0.0f)
+            return false;
+    }
+    return true;
+}
+
+class ChunkRenderer
+{
+public:
+    int visibleChunks;  // chunks desenhados no último frame
+    int drawableChunks; // chunks com geometria
+    int defragCount;    // quantas vezes alguma arena foi compactada ou cresceu
+
+    ChunkRenderer() : visibleChunks(0), drawableChunks(0), defragCount(0), VAO(0), originVBO(0), listDirty(true) {}
+
+    // Capacidades iniciais em número de vértices e de índices (as arenas crescem se preciso)
+    void init(const VoxelWorld &world, GLuint vertexCapacity, GLuint indexCapacity)
+    {
+        loadGLExt();
+        hasBaseInstance = glDrawElementsInstancedBaseVertexBaseInstance != nullptr;
+        if (!glMultiDrawElementsIndirect)
+            std::cout << "ChunkRenderer: glMultiDrawElementsIndirect indisponivel, usando um draw por chunk" << std::endl;
+        if (!glMultiDrawElementsIndirect && !hasBaseInstance)
+            std::cout << "ChunkRenderer: sem baseInstance, origem do chunk passada por uniform" << std::endl;
+
+        vertexArena.init(sizeof(ChunkVertex), vertexCapacity);
+        indexArena.init(sizeof(ChunkIndex), indexCapacity);
+
+        int n = world.chunkCount();
+        draws.assign(n, {ARENA_INVALID, 0, ARENA_INVALID, 0});
+
+        // Origem de cada chunk, lida pelo atributo instanciado via baseInstance,
+        // e canto mínimo da caixa envolvente usada no teste de frustum
+        std::vector<glm::vec4> origins(n);
+        chunkMin.resize(n);
+        for (int i = 0; i < n; i++)
+        {
+            glm::ivec3 c = world.chunkCoord(i);
+            chunkMin[i] = glm::vec3((float)(c.x * CHUNK_SIZE), (float)(c.y * CHUNK_SIZE), (float)(c.z * CHUNK_SIZE));
+            origins[i] = glm::vec4(chunkMin[i], 0.0f);
+        }
+        glGenBuffers(1, &originVBO);
+        glBindBuffer(GL_ARRAY_BUFFER, originVBO);
+        glBufferData(GL_ARRAY_BUFFER, n * sizeof(glm::vec4), origins.data(), GL_STATIC_DRAW);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+        // Comandos indiretos: no máximo um por chunk, por frame
+        indirect.init(n * sizeof(DrawElementsIndirectCommand), GL_DRAW_INDIRECT_BUFFER);
+
+        glGenVertexArrays(1, &VAO);
+        setupVAO();
+    }
+
+    void destroy()
+    {
+        vertexArena.destroy();
+        indexArena.destroy();
+        indirect.destroy();
+        glDeleteBuffers(1, &originVBO);
+        glDeleteVertexArrays(1, &VAO);
+    }
+
+    // Refaz a malha dos chunks marcados como sujos. Retorna quantos foram refeitos.
+    int rebuildDirty(VoxelWorld &world)
+    {
+        std::vector<int> dirty = world.takeDirty();
+        for (int index : dirty)
+            updateChunk(world, index);
+        if (!dirty.empty())
+            listDirty = true;
+        return (int)dirty.size();
+    }
+
+    // Uniform vec4 do programa que recebe a origem do chunk quando não há baseInstance
+    // (o programa deve estar em uso ao chamar draw)
+    void setOriginUniform(GLint location) { originUniform = location; }
+
+    void draw(const glm::mat4 &viewProj)
+    {
+        if (listDirty)
+            rebuildDrawableList();
+
+        glm::vec4 planes[6];
+        extractFrustumPlanes(viewProj, planes);
+
+        commands.clear();
+        for (int index : drawable)
+        {
+            const ChunkDraw &d = draws[index];
+            if (!aabbInFrustum(planes, chunkMin[index], chunkMin[index] + glm::vec3((float)CHUNK_SIZE)))
+                continue;
+            commands.push_back({d.indexCount, 1, d.indexOffset, (GLint)d.vertexOffset, (GLuint)index});
+        }
+        visibleChunks = (int)commands.size();
+        if (commands.empty())
+            return;
+
+        glBindVertexArray(VAO);
+        if (glMultiDrawElementsIndirect)
+        {
+            indirect.beginFrame();
+            StreamAlloc alloc = indirect.allocate(commands.size() * sizeof(DrawElementsIndirectCommand), 4);
+            memcpy(alloc.ptr, commands.data(), alloc.size);
+            indirect.flush(alloc);
+
+            glBindBuffer(GL_DRAW_INDIRECT_BUFFER, indirect.buffer());
+            glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_SHORT, (const void *)alloc.offset, (GLsizei)commands.size(), 0);
+            glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+            indirect.endFrame();
+        }
+        else if (hasBaseInstance)
+        {
+            for (const DrawElementsIndirectCommand &c : commands)
+            {
+                glDrawElementsInstancedBaseVertexBaseInstance(GL_TRIANGLES, c.count, GL_UNSIGNED_SHORT,
+                                                              (const void *)(c.firstIndex * sizeof(ChunkIndex)), 1, c.baseVertex, c.baseInstance);
+            }
+        }
+        else
+        {
+            for (const DrawElementsIndirectCommand &c : commands)
+            {
+                const glm::vec3 &o = chunkMin[c.baseInstance];
+                glUniform4f(originUniform, o.x, o.y, o.z, 0.0f);
+                glDrawElementsBaseVertex(GL_TRIANGLES, c.count, GL_UNSIGNED_SHORT,
+                                         (const void *)(c.firstIndex * sizeof(ChunkIndex)), c.baseVertex);
+            }
+            glUniform4f(originUniform, 0.0f, 0.0f, 0.0f, 0.0f);
+        }
+        glBindVertexArray(0);
+    }
+
+    // Relatório de memória das malhas: por chunk (opcional) e total, comparando com o formato
+    // antigo de 5 floats por vértice sem índices (6 vértices por face)
+    void printMemoryReport(const VoxelWorld &world, bool perChunk) const
+    {
+        size_t totalVertexBytes = 0, totalIndexBytes = 0, totalFaces = 0;
+        for (int i = 0; i < (int)draws.size(); i++)
+        {
+            const ChunkDraw &d = draws[i];
+            if (d.indexCount == 0)
+                continue;
+            size_t vb = (size_t)d.vertexCount * sizeof(ChunkVertex);
+            size_t ib = (size_t)d.indexCount * sizeof(ChunkIndex);
+            size_t faces = d.vertexCount / 4;
+            totalVertexBytes += vb;
+            totalIndexBytes += ib;
+            totalFaces += faces;
+            if (perChunk)
+            {
+                glm::ivec3 c = world.chunkCoord(i);
+                printf("chunk (%d,%d,%d): %zu faces, vertices %.1f KB, indices %.1f KB (float sem indices: %.1f KB)\n",
+                       c.x, c.y, c.z, faces, vb / 1024.0, ib / 1024.0, faces * 6 * 5 * sizeof(float) / 1024.0);
+            }
+        }
+        double packed = (double)(totalVertexBytes + totalIndexBytes);
+        double unpacked = (double)totalFaces * 6 * 5 * sizeof(float);
+        printf("Total: %zu faces, vertices %.2f MB + indices %.2f MB = %.2f MB (float sem indices: %.2f MB, %.1fx menor)\n",
+               totalFaces, totalVertexBytes / 1048576.0, totalIndexBytes / 1048576.0, packed / 1048576.0,
+               unpacked / 1048576.0, packed > 0.0 ? unpacked / packed : 0.0);
+        printf("Arenas: vertices %.2f/%.2f MB, indices %.2f/%.2f MB\n",
+               vertexArena.used() * (double)sizeof(ChunkVertex) / 1048576.0, vertexArena.capacity() * (double)sizeof(ChunkVertex) / 1048576.0,
+               indexArena.used() * (double)sizeof(ChunkIndex) / 1048576.0, indexArena.capacity() * (double)sizeof(ChunkIndex) / 1048576.0);
+    }
+
+    const ChunkDraw &chunkDraw(int index) const { return draws[index]; }
+    const BufferArena &vertices() const { return vertexArena; }
+    const BufferArena &indices() const { return indexArena; }
+
+private:
+    void setupVAO()
+    {
+        glBindVertexArray(VAO);
+
+        // Vértice compactado: dois inteiros sem sinal, sem conversão para float (glVertexAttribIPointer)
+        glBindBuffer(GL_ARRAY_BUFFER, vertexArena.buffer());
+        glVertexAttribIPointer(0, 2, GL_UNSIGNED_INT, sizeof(ChunkVertex), (GLvoid *)0);
+        glEnableVertexAttribArray(0);
+
+        glBindBuffer(GL_ARRAY_BUFFER, originVBO);
+        glVertexAttribPointer(3, 4, GL_FLOAT, GL_FALSE, sizeof(glm::vec4), (GLvoid *)0);
+        glVertexAttribDivisor(3, 1);
+        if (glMultiDrawElementsIndirect || hasBaseInstance)
+            glEnableVertexAttribArray(3);
+        else
+        {
+            // Sem baseInstance toda instância leria a origem do chunk 0: o atributo fica
+            // constante em 0 e a origem vem do uniform
+            glDisableVertexAttribArray(3);
+            glVertexAttrib4f(3, 0.0f, 0.0f, 0.0f, 0.0f);
+        }
+
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexArena.buffer());
+
+        glBindVertexArray(0);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+
+    void updateChunk(const VoxelWorld &world, int index)
+    {
+        ChunkDraw &d = draws[index];
+        if (d.vertexOffset != ARENA_INVALID)
+            vertexArena.release(d.vertexOffset);
+        if (d.indexOffset != ARENA_INVALID)
+            indexArena.release(d.indexOffset);
+        d = {ARENA_INVALID, 0, ARENA_INVALID, 0};
+
+        mesher.mesh(world, index);
+        if (mesher.indices.empty())
+            return;
+
+        GLuint nv = (GLuint)mesher.vertices.size();
+        GLuint ni = (GLuint)mesher.indices.size();
+        GLuint vOffset = allocateIn(vertexArena, nv, index, true);
+        GLuint iOffset = allocateIn(indexArena, ni, index, false);
+
+        vertexArena.upload(vOffset, nv, mesher.vertices.data());
+        indexArena.upload(iOffset, ni, mesher.indices.data());
+        draws[index] = {vOffset, nv, iOffset, ni};
+    }
+
+    // Tenta alocar; sem trecho contíguo, compacta a arena (ou a aumenta) e tenta de novo
+    GLuint allocateIn(BufferArena &arena, GLuint count, int owner, bool isVertexArena)
+    {
+        GLuint offset = arena.allocate(count, owner);
+        if (offset != ARENA_INVALID)
+            return offset;
+
+        std::vector<ArenaMove> moves;
+        if (arena.freeElements() >= count)
+        {
+            moves = arena.defragment();
+        }
+        else
+        {
+            GLuint capacity = arena.capacity();
+            while (capacity - arena.used() < count)
+                capacity *= 2;
+            moves = arena.grow(capacity);
+            setupVAO(); // o buffer da arena mudou de identificador
+        }
+        defragCount++;
+
+        for (const ArenaMove &m : moves)
+        {
+            if (isVertexArena)
+                draws[m.owner].vertexOffset = m.newOffset;
+            else
+                draws[m.owner].indexOffset = m.newOffset;
+        }
+        return arena.allocate(count, owner);
+    }
+
+    void rebuildDrawableList()
+    {
+        drawable.clear();
+        for (int i = 0; i < (int)draws.size(); i++)
+        {
+            if (draws[i].indexCount > 0)
+                drawable.push_back(i);
+        }
+        drawableChunks = (int)drawable.size();
+        listDirty = false;
+    }
+
+private:
+    BufferArena vertexArena;
+    BufferArena indexArena;
+    StreamBuffer indirect;
+    ChunkMesher mesher;
+    GLuint VAO, originVBO;
+    bool hasBaseInstance = false;
+    GLint originUniform = -1;
+    std::vector<ChunkDraw> draws;
+    std::vector<int> drawable;
+    std::vector<glm::vec3> chunkMin;
+    std::vector<DrawElementsIndirectCommand> commands;
+    bool listDirty;
+};
@@ -0,0 +1,339 @@
+/*
+ * FieldOfView - campo de visão por shadowcasting e névoa de guerra sobre o tilemap
+ *
+ * Cada observador (o jogador, uma unidade) enxerga as células até "radius" tiles de
+ * distância que não estão atrás de um tile sólido. O cálculo é o shadowcasting recursivo:
+ * a área em volta do observador é dividida em 8 octantes, e cada octante é varrido linha
+ * a linha, do centro para fora, carregando o intervalo de inclinações ainda iluminado;
+ * um tile sólido estreita o intervalo (e abre uma recursão para a parte ao lado dele).
+ * Cada célula é visitada no máximo uma vez por octante, então o custo é O(radius²),
+ * independente do tamanho do mapa. As paredes que fazem sombra também ficam visíveis.
+ *
+ * FogOfWar guarda, para cada observador, o resultado numa janela de bits do tamanho do
+ * seu raio, alinhada às palavras de 64 bits do mapa. O mapa visível é a união (OR) das
+ * janelas. Um observador só é recalculado quando troca de célula ou quando muda um tile
+ * dentro do seu raio; aí só a área da janela antiga e da nova é refeita no mapa, com os
+ * observadores que a cobrem. As células já vistas alguma vez ficam em "explored".
+ *
+ * Para desenhar, fogLevel() dá um byte por célula (visível, explorada ou desconhecida),
+ * e dirtyRect() o retângulo que mudou desde a última consulta, para enviar só ele à
+ * textura R8 do shader.
+ *
+ * Coordenadas como em TileCollisionLayer: (col, row), linha 0 no topo.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "TileCollision.h"
+
+// Valores da textura de névoa (R8)
+const uint8_t FOG_UNKNOWN = 0;
+const uint8_t FOG_EXPLORED = 100;
+const uint8_t FOG_VISIBLE = 255;
+
+class FogOfWar
+{
+public:
+    // Mapa de opacidade: tiles sólidos da camada (fora do mapa também bloqueia)
+    void init(const TileCollisionLayer &opaque)
+    {
+        layer = &opaque;
+        cols = opaque.cols;
+        rows = opaque.rows;
+        wordsPerRow = (cols + 63) / 64;
+        visibleBits.assign((size_t)wordsPerRow * rows, 0);
+        exploredBits.assign((size_t)wordsPerRow * rows, 0);
+        viewers.clear();
+        freeIds.clear();
+        clearDirty();
+    }
+
+    int addViewer(int col, int row, int radius)
+    {
+        Viewer v;
+        v.col = col;
+        v.row = row;
+        v.radius = radius;
+        v.active = true;
+        v.dirty = true; // ainda sem janela
+        if (!freeIds.empty())
+        {
+            int id = freeIds.back();
+            freeIds.pop_back();
+            viewers[id] = v;
+            return id;
+        }
+        viewers.push_back(v);
+        return (int)viewers.size() - 1;
+    }
+
+    // Só marca para recalcular se o observador trocou de célula
+    void moveViewer(int id, int col, int row)
+    {
+        Viewer &v = viewers[id];
+        if (v.col == col && v.row == row)
+            return;
+        v.col = col;
+        v.row = row;
+        v.dirty = true;
+    }
+
+    void removeViewer(int id)
+    {
+        Viewer &v = viewers[id];
+        v.active = false;
+        v.dirty = false;
+        rebuildArea(v.c0, v.r0, v.c1, v.r1);
+        v.bits.clear();
+        freeIds.push_back(id);
+    }
+
+    // Um tile mudou na camada de opacidade: recalcula quem o tem dentro do raio
+    void tileChanged(int col, int row)
+    {
+        for (Viewer &v : viewers)
+            if (v.active && col >= v.c0 && col <= v.c1 && row >= v.r0 && row <= v.r1)
+                v.dirty = true;
+    }
+
+    // Recalcula os observadores marcados e refaz o mapa só em volta deles.
+    // Retorna quantos foram recalculados.
+    int update()
+    {
+        int n = 0;
+        for (Viewer &v : viewers)
+        {
+            if (!v.active || !v.dirty)
+                continue;
+            int oc0 = v.c0, or0 = v.r0, oc1 = v.c1, or1 = v.r1;
+            computeViewer(v);
+            v.dirty = false;
+            n++;
+
+            // Normalmente a janela antiga e a nova se sobrepõem (o observador andou uma
+            // célula) e a caixa das duas é refeita de uma vez
+            bool hadWindow = oc1 >= oc0 && or1 >= or0;
+            if (!hadWindow)
+                rebuildArea(v.c0, v.r0, v.c1, v.r1);
+            else if (oc1 < v.c0 || oc0 > v.c1 || or1 < v.r0 || or0 > v.r1)
+            {
+                rebuildArea(oc0, or0, oc1, or1);
+                rebuildArea(v.c0, v.r0, v.c1, v.r1);
+            }
+            else
+                rebuildArea(std::min(oc0, v.c0), std::min(or0, v.r0), std::max(oc1, v.c1), std::max(or1, v.r1));
+        }
+        return n;
+    }
+
+    bool visible(int col, int row) const { return inside(col, row) && testBit(visibleBits, col, row); }
+    bool explored(int col, int row) const { return inside(col, row) && testBit(exploredBits, col, row); }
+
+    uint8_t fogLevel(int col, int row) const
+    {
+        if (!inside(col, row))
+            return FOG_UNKNOWN;
+        return testBit(visibleBits, col, row) ? FOG_VISIBLE
+                                              : (testBit(exploredBits, col, row) ? FOG_EXPLORED : FOG_UNKNOWN);
+    }
+
+    // Retângulo (inclusivo) alterado desde a última chamada; false se nada mudou
+    bool dirtyRect(int &c0, int &r0, int &c1, int &r1)
+    {
+        if (dirtyC1 < dirtyC0)
+            return false;
+        c0 = dirtyC0;
+        r0 = dirtyR0;
+        c1 = dirtyC1;
+        r1 = dirtyR1;
+        clearDirty();
+        return true;
+    }
+
+    // Células visíveis por um observador sozinho (para conferência)
+    bool viewerSees(int id, int col, int row) const
+    {
+        const Viewer &v = viewers[id];
+        if (v.bits.empty() || col < v.c0 || col > v.c1 || row < v.r0 || row > v.r1)
+            return false;
+        int w = col / 64 - v.w0;
+        return (v.bits[(size_t)(row - v.r0) * v.wordsPerRow + w] >> (col % 64)) & 1;
+    }
+
+    int viewerCount() const { return (int)viewers.size() - (int)freeIds.size(); }
+
+private:
+    struct Viewer
+    {
+        int col = 0, row = 0, radius = 0;
+        bool active = false, dirty = false;
+        int c0 = 0, r0 = 0, c1 = -1, r1 = -1; // janela no mapa (recortada), inclusiva
+        int w0 = 0, wordsPerRow = 0;          // palavras de 64 colunas cobertas pela janela
+        std::vector<uint64_t> bits;           // (r1 - r0 + 1) linhas de wordsPerRow palavras
+    };
+
+    const TileCollisionLayer *layer = nullptr;
+    int cols = 0, rows = 0, wordsPerRow = 0;
+    std::vector<uint64_t> visibleBits, exploredBits;
+    std::vector<Viewer> viewers;
+    std::vector<int> freeIds;
+    int dirtyC0 = 0, dirtyR0 = 0, dirtyC1 = -1, dirtyR1 = -1;
+
+    bool inside(int col, int row) const { return col >= 0 && row >= 0 && col < cols && row < rows; }
+
+    bool testBit(const std::vector<uint64_t> &b, int col, int row) const
+    {
+        return (b[(size_t)row * wordsPerRow + col / 64] >> (col % 64)) & 1;
+    }
+
+    void clearDirty()
+    {
+        dirtyC0 = dirtyR0 = 0;
+        dirtyC1 = dirtyR1 = -1;
+    }
+
+    // Janela nova (recortada ao mapa), bits zerados e shadowcasting nos 8 octantes
+    void computeViewer(Viewer &v)
+    {
+        v.c0 = std::max(v.col - v.radius, 0);
+        v.r0 = std::max(v.row - v.radius, 0);
+        v.c1 = std::min(v.col + v.radius, cols - 1);
+        v.r1 = std::min(v.row + v.radius, rows - 1);
+        if (v.c1 < v.c0 || v.r1 < v.r0)
+        {
+            v.bits.clear();
+            return;
+        }
+        v.w0 = v.c0 / 64;
+        v.wordsPerRow = v.c1 / 64 - v.w0 + 1;
+        v.bits.assign((size_t)v.wordsPerRow * (v.r1 - v.r0 + 1), 0);
+
+        mark(v, v.col, v.row);
+        // Multiplicadores que levam (dx, dy) do octante de referência para cada um dos 8
+        static const int xx[8] = {1, 0, 0, -1, -1, 0, 0, 1};
+        static const int xy[8] = {0, 1, -1, 0, 0, -1, 1, 0};
+        static const int yx[8] = {0, 1, 1, 0, 0, -1, -1, 0};
+        static const int yy[8] = {1, 0, 0, 1, -1, 0, 0, -1};
+        for (int oct = 0; oct < 8; oct++)
+            castLight(v, 1, 1.0f, 0.0f, xx[oct], xy[oct], yx[oct], yy[oct]);
+    }
+
+    void mark(Viewer &v, int col, int row)
+    {
+        if (col < v.c0 || col > v.c1 || row < v.r0 || row > v.r1)
+            return;
+        v.bits[(size_t)(row - v.r0) * v.wordsPerRow + (col / 64 - v.w0)] |= uint64_t(1) << (col % 64);
+    }
+
+    // Varre as linhas "dist" em diante de um octante, dentro do leque de inclinações
+    // [end, start]. Cada tile sólido que começa uma sombra abre uma recursão para o leque
+    // acima dele; a varredura continua depois da sombra com o leque estreitado.
+    void castLight(Viewer &v, int dist, float start, float end, int xx, int xy, int yx, int yy)
+    {
+        if (start < end)
+            return;
+        const int r2 = v.radius * v.radius + v.radius; // círculo um pouco mais cheio que r²
+        float newStart = 0.0f;
+        for (int j = dist; j <= v.radius; j++)
+        {
+            bool blocked = false;
+            int dy = -j;
+            for (int dx = -j; dx <= 0; dx++)
+            {
+                float leftSlope = (dx - 0.5f) / (dy + 0.5f);
+                float rightSlope = (dx + 0.5f) / (dy - 0.5f);
+                if (start < rightSlope)
+                    continue;
+                if (end > leftSlope)
+                    break;
+
+                int col = v.col + dx * xx + dy * xy;
+                int row = v.row + dx * yx + dy * yy;
+                if (dx * dx + dy * dy <= r2)
+                    mark(v, col, row);
+
+                bool opaque = layer->solidAt(col, row);
+                if (blocked)
+                {
+                    if (opaque)
+                    {
+                        newStart = rightSlope;
+                        continue;
+                    }
+                    blocked = false;
+                    start = newStart;
+                }
+                else if (opaque && j < v.radius)
+                {
+                    blocked = true;
+                    castLight(v, j + 1, start, leftSlope, xx, xy, yx, yy);
+                    newStart = rightSlope;
+                }
+            }
+            if (blocked)
+                break;
+        }
+    }
+
+    // Refaz visible (e explored) no retângulo: limpa e junta as janelas que o cobrem
+    void rebuildArea(int c0, int r0, int c1, int r1)
+    {
+        c0 = std::max(c0, 0);
+        r0 = std::max(r0, 0);
+        c1 = std::min(c1, cols - 1);
+        r1 = std::min(r1, rows - 1);
+        if (c1 < c0 || r1 < r0)
+            return;
+        int wa = c0 / 64, wb = c1 / 64;
+        auto maskOf = [&](int w) {
+            uint64_t m = ~uint64_t(0);
+            if (w == wa)
+                m &= ~uint64_t(0) << (c0 % 64);
+            if (w == wb && c1 % 64 != 63)
+                m &= (uint64_t(1) << (c1 % 64 + 1)) - 1;
+            return m;
+        };
+
+        for (int r = r0; r <= r1; r++)
+            for (int w = wa; w <= wb; w++)
+                visibleBits[(size_t)r * wordsPerRow + w] &= ~maskOf(w);
+
+        for (const Viewer &v : viewers)
+        {
+            if (!v.active || v.bits.empty() || v.c1 < c0 || v.c0 > c1 || v.r1 < r0 || v.r0 > r1)
+                continue;
+            int ra = std::max(r0, v.r0), rb = std::min(r1, v.r1);
+            int va = std::max(wa, v.w0), vb = std::min(wb, v.w0 + v.wordsPerRow - 1);
+            for (int r = ra; r <= rb; r++)
+            {
+                const uint64_t *src = v.bits.data() + (size_t)(r - v.r0) * v.wordsPerRow;
+                uint64_t *dst = visibleBits.data() + (size_t)r * wordsPerRow;
+                for (int w = va; w <= vb; w++)
+                    dst[w] |= src[w - v.w0] & maskOf(w);
+            }
+        }
+
+        for (int r = r0; r <= r1; r++)
+            for (int w = wa; w <= wb; w++)
+                exploredBits[(size_t)r * wordsPerRow + w] |= visibleBits[(size_t)r * wordsPerRow + w];
+
+        if (dirtyC1 < dirtyC0)
+        {
+            dirtyC0 = c0;
+            dirtyR0 = r0;
+            dirtyC1 = c1;
+            dirtyR1 = r1;
+        }
+        else
+        {
+            dirtyC0 = std::min(dirtyC0, c0);
+            dirtyR0 = std::min(dirtyR0, r0);
+            dirtyC1 = std::max(dirtyC1, c1);
+            dirtyR1 = std::max(dirtyR1, r1);
+        }
+    }
+};
@@ -0,0 +1,510 @@
+/*
+ * FlowField - campos de fluxo sobre a grade do tilemap, para multidões indo ao mesmo destino
+ *
+ * Com dezenas de milhares de agentes indo para o mesmo lugar, um A* por agente repete
+ * quase o mesmo trabalho milhares de vezes. O campo de fluxo resolve o mapa inteiro uma
+ * vez por destino:
+ *
+ *   - integração: a distância (em passos retos) de cada célula até o destino, por uma BFS
+ *     em frentes de onda. Cada frente é dividida entre as threads do ThreadPool quando é
+ *     grande; as células são reivindicadas com um atômico, então cada uma é escrita por
+ *     uma thread só e o resultado é o mesmo com ou sem threads;
+ *   - direção: para cada célula, o vizinho (dos 8) com a menor distância, sem cortar
+ *     quinas. Com SSE2, 4 células por instrução, lendo a integração com uma borda de
+ *     "infinito" em volta para dispensar os testes de limite.
+ *
+ * Cada agente só consulta a direção da célula em que está (steer()), O(1) e sem busca.
+ *
+ * Quando um tile muda, tileChanged() conserta a integração só onde ela mudou: ao fechar
+ * uma célula, remove em ordem de distância as células que dependiam só dela (como a
+ * remoção de luz em jogos de voxel) e preenche de novo a partir da borda dessa região;
+ * ao abrir, propaga a melhora a partir dela. As direções são refeitas só em volta das
+ * células tocadas.
+ *
+ * FlowFieldCache guarda os campos dos destinos mais recentes (LRU) e repassa as mudanças
+ * de tile a todos eles.
+ *
+ * Coordenadas como em TileCollisionLayer: linha 0 no topo, canto superior esquerdo em
+ * (left, top), y do mundo crescendo para cima.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define FLOW_FIELD_SSE2 1
+#endif
+
+#include "Pathfinding.h"
+#include "ThreadPool.h"
+
+// Direções das células vizinhas (col, row), na ordem dos códigos 0..7; 8 = parado
+const int FLOW_DIR_C[9] = {1, -1, 0, 0, 1, 1, -1, -1, 0};
+const int FLOW_DIR_R[9] = {0, 0, 1, -1, 1, -1, 1, -1, 0};
+const uint8_t FLOW_NONE = 8;
+
+class FlowField
+{
+public:
+    static constexpr int32_t UNREACHED = 0x7fffffff;
+
+    float tileW = 1.0f, tileH = 1.0f;
+    float left = 0.0f, top = 0.0f;
+
+    explicit FlowField(const PathGrid &grid) : grid(grid), cols(0), rows(0), W(0), goalPad(-1), generation(0) {}
+
+    // Refaz o campo inteiro para o destino (pool = nullptr: tudo na thread que chamou)
+    void build(GridPoint goal, ThreadPool *pool = nullptr)
+    {
+        resize();
+        goalCell = goal;
+        for (int r = 0; r < rows; r++)
+            for (int c = 0; c < cols; c++)
+                open[pad(c, r)] = grid.walkable(c, r) ? 1 : 0;
+        std::fill(cost.begin(), cost.end(), UNREACHED);
+        goalPad = grid.walkable(goal.col, goal.row) ? pad(goal.col, goal.row) : -1;
+        integrate(pool);
+        computeDirections(pool);
+    }
+
+    GridPoint goal() const { return goalCell; }
+
+    // Distância até o destino em passos retos (UNREACHED se não há caminho)
+    int32_t distance(int col, int row) const
+    {
+        return inside(col, row) ? cost[pad(col, row)] : UNREACHED;
+    }
+
+    // Código 0..7 da direção a seguir na célula, ou FLOW_NONE (destino, parede isolada, sem caminho)
+    uint8_t direction(int col, int row) const
+    {
+        return inside(col, row) ? dirs[(size_t)row * cols + col] : FLOW_NONE;
+    }
+
+    // Velocidade de cada agente [begin, end): speed na direção da célula onde ele está
+    void steer(const float *posX, const float *posY, float *velX, float *velY, int begin, int end, float speed) const
+    {
+        // Direções da tela (y para cima) já normalizadas, uma por código
+        float ux[9], uy[9];
+        for (int d = 0; d < 9; d++)
+        {
+            float len = sqrtf((float)(FLOW_DIR_C[d] * FLOW_DIR_C[d] + FLOW_DIR_R[d] * FLOW_DIR_R[d]));
+            ux[d] = len > 0.0f ? speed * FLOW_DIR_C[d] / len : 0.0f;
+            uy[d] = len > 0.0f ? -speed * FLOW_DIR_R[d] / len : 0.0f;
+        }
+        float invW = 1.0f / tileW, invH = 1.0f / tileH;
+        for (int i = begin; i < end; i++)
+        {
+            int c = (int)floorf((posX[i] - left) * invW), r = (int)floorf((top - posY[i]) * invH);
+            uint8_t d = direction(c, r);
+            velX[i] = ux[d];
+            velY[i] = uy[d];
+        }
+    }
+
+    // A célula já mudou em grid: conserta a integração e as direções em volta dela
+    void tileChanged(int col, int row)
+    {
+        if (!inside(col, row) || cost.empty())
+            return;
+        int p = pad(col, row);
+        uint8_t nowOpen = grid.walkable(col, row) ? 1 : 0;
+        if (nowOpen == open[p])
+            return;
+        open[p] = nowOpen;
+        touched.clear();
+        touched.push_back(p);
+        if (!nowOpen)
+        {
+            if (p == goalPad)
+            {
+                // Sem destino, nenhuma célula tem caminho
+                goalPad = -1;
+                std::fill(cost.begin(), cost.end(), UNREACHED);
+                std::fill(dirs.begin(), dirs.end(), FLOW_NONE);
+                return;
+            }
+            closeCell(p);
+        }
+        else
+            openCell(p);
+
+        for (int t : touched)
+            for (int dr = -1; dr <= 1; dr++)
+                for (int dc = -1; dc <= 1; dc++)
+                {
+                    int q = t + dr * W + dc;
+                    int c = q % W - 1, r = q / W - 1;
+                    if (inside(c, r))
+                        dirs[(size_t)r * cols + c] = bestDirection(q);
+                }
+    }
+
+    // Células cuja integração mudou na última tileChanged
+    int lastTouched() const { return (int)touched.size(); }
+
+    // Versão escalar da passada de direções, para conferir a SIMD
+    void computeDirectionsScalar()
+    {
+        for (int r = 0; r < rows; r++)
+            for (int c = 0; c < cols; c++)
+                dirs[(size_t)r * cols + c] = bestDirection(pad(c, r));
+    }
+
+    void computeDirections(ThreadPool *pool = nullptr)
+    {
+        auto rowsFn = [&](int r0, int r1) {
+            for (int r = r0; r < r1; r++)
+                directionRow(r);
+        };
+        if (pool)
+            pool->parallelFor(rows, 16, rowsFn);
+        else
+            rowsFn(0, rows);
+    }
+
+    const std::vector<uint8_t> &directions() const { return dirs; }
+
+private:
+    // Frentes menores que isso são expandidas numa thread só (a sincronização custaria mais)
+    static const int PARALLEL_FRONTIER = 4096;
+    static const int FRONTIER_GRAIN = 1024;
+
+    const PathGrid &grid;
+    int cols, rows, W; // W = cols + 2: linhas com uma célula de borda em cada lado
+    GridPoint goalCell = {0, 0};
+    int goalPad;
+
+    std::vector<int32_t> cost;   // (cols + 2) x (rows + 2), borda = UNREACHED
+    std::vector<uint8_t> open;   // idem, borda = 0
+    std::vector<uint8_t> dirs;   // cols x rows, sem borda
+    std::unique_ptr<std::atomic<uint32_t>[]> claimed;
+    uint32_t generation;
+
+    std::vector<int> frontier, next, touched, removed, seeds;
+    std::vector<int32_t> removedCost;
+    std::vector<std::vector<int>> parts;
+
+    bool inside(int col, int row) const { return col >= 0 && row >= 0 && col < cols && row < rows; }
+    int pad(int col, int row) const { return (row + 1) * W + col + 1; }
+
+    void resize()
+    {
+        if (cols == grid.cols && rows == grid.rows && !cost.empty())
+            return;
+        cols = grid.cols;
+        rows = grid.rows;
+        W = cols + 2;
+        size_t n = (size_t)W * (rows + 2);
+        cost.assign(n, UNREACHED);
+        open.assign(n, 0);
+        dirs.assign((size_t)cols * rows, FLOW_NONE);
+        claimed.reset(new std::atomic<uint32_t>[n]);
+        for (size_t i = 0; i < n; i++)
+            claimed[i].store(0, std::memory_order_relaxed);
+        generation = 0;
+    }
+
+    // Marca v como visitada nesta construção; com várias threads, só uma consegue (a
+    // troca atômica só é necessária aí: numa thread, ler e gravar basta)
+    bool claim(int v, bool shared)
+    {
+        uint32_t seen = claimed[v].load(std::memory_order_relaxed);
+        if (seen == generation)
+            return false;
+        if (shared)
+            return claimed[v].compare_exchange_strong(seen, generation, std::memory_order_relaxed);
+        claimed[v].store(generation, std::memory_order_relaxed);
+        return true;
+    }
+
+    void expand(const int *cells, int count, int32_t level, std::vector<int> &out, bool shared)
+    {
+        const int offs[4] = {1, -1, W, -W};
+        for (int i = 0; i < count; i++)
+            for (int k = 0; k < 4; k++)
+            {
+                int v = cells[i] + offs[k];
+                if (open[v] && claim(v, shared))
+                {
+                    cost[v] = level;
+                    out.push_back(v);
+                }
+            }
+    }
+
+    void integrate(ThreadPool *pool)
+    {
+        if (++generation == 0)
+        {
+            for (size_t i = 0; i < cost.size(); i++)
+                claimed[i].store(0, std::memory_order_relaxed);
+            generation = 1;
+        }
+        frontier.clear();
+        if (goalPad < 0)
+            return;
+        claim(goalPad, false);
+        cost[goalPad] = 0;
+        frontier.push_back(goalPad);
+        for (int32_t level = 1; !frontier.empty(); level++)
+        {
+            next.clear();
+            int n = (int)frontier.size();
+            if (pool && pool->size() > 1 && n >= PARALLEL_FRONTIER)
+            {
+                // Cada bloco da frente escreve na sua lista (os blocos começam em múltiplos do grão)
+                int blocks = (n + FRONTIER_GRAIN - 1) / FRONTIER_GRAIN;
+                if ((int)parts.size() < blocks)
+                    parts.resize(blocks);
+                pool->parallelFor(n, FRONTIER_GRAIN, [&](int b, int e) {
+                    std::vector<int> &out = parts[b / FRONTIER_GRAIN];
+                    out.clear();
+                    expand(&frontier[b], e - b, level, out, true);
+                });
+                for (int k = 0; k < blocks; k++)
+                    next.insert(next.end(), parts[k].begin(), parts[k].end());
+            }
+            else
+                expand(frontier.data(), n, level, next, false);
+            frontier.swap(next);
+        }
+    }
+
+    // Vizinho de menor distância da célula p (com borda), sem cortar quinas
+    uint8_t bestDirection(int p) const
+    {
+        int32_t best = cost[p];
+        uint8_t dir = FLOW_NONE;
+        for (int d = 0; d < 8; d++)
+        {
+            int dc = FLOW_DIR_C[d], dr = FLOW_DIR_R[d];
+            int32_t v = cost[p + dr * W + dc];
+            if (v >= best)
+                continue;
+            // Uma célula alcançada é andável; nas diagonais as duas retas têm que estar livres
+            if (dc && dr && (cost[p + dc] == UNREACHED || cost[p + dr * W] == UNREACHED))
+                continue;
+            best = v;
+            dir = (uint8_t)d;
+        }
+        return dir;
+    }
+
+    void directionRow(int r)
+    {
+        int c = 0;
+        uint8_t *out = &dirs[(size_t)r * cols];
+#ifdef FLOW_FIELD_SSE2
+        const __m128i unreached = _mm_set1_epi32(UNREACHED);
+        for (; c + 4 <= cols; c += 4)
+        {
+            const int32_t *p = &cost[pad(c, r)];
+            __m128i best = _mm_loadu_si128((const __m128i *)p);
+            __m128i dir = _mm_set1_epi32(FLOW_NONE);
+            // Retas primeiro, depois diagonais: mesma ordem (e mesmo desempate) da versão escalar
+            __m128i ortho[4];
+            for (int d = 0; d < 4; d++)
+            {
+                __m128i v = _mm_loadu_si128((const __m128i *)(p + FLOW_DIR_R[d] * W + FLOW_DIR_C[d]));
+                ortho[d] = v;
+                __m128i m = _mm_cmplt_epi32(v, best);
+                best = _mm_or_si128(_mm_and_si128(m, v), _mm_andnot_si128(m, best));
+                dir = _mm_or_si128(_mm_and_si128(m, _mm_set1_epi32(d)), _mm_andnot_si128(m, dir));
+            }
+            for (int d = 4; d < 8; d++)
+            {
+                __m128i v = _mm_loadu_si128((const __m128i *)(p + FLOW_DIR_R[d] * W + FLOW_DIR_C[d]));
+                // ortho[0] = +col, [1] = -col, [2] = +row, [3] = -row
+                __m128i side = _mm_or_si128(_mm_cmpeq_epi32(ortho[FLOW_DIR_C[d] > 0 ? 0 : 1], unreached),
+                                            _mm_cmpeq_epi32(ortho[FLOW_DIR_R[d] > 0 ? 2 : 3], unreached));
+                __m128i m = _mm_andnot_si128(side, _mm_cmplt_epi32(v, best));
+                best = _mm_or_si128(_mm_and_si128(m, v), _mm_andnot_si128(m, best));
+                dir = _mm_or_si128(_mm_and_si128(m, _mm_set1_epi32(d)), _mm_andnot_si128(m, dir));
+            }
+            // 4 x int32 (0..8) -> 4 bytes
+            __m128i packed = _mm_packus_epi16(_mm_packs_epi32(dir, dir), _mm_setzero_si128());
+            int32_t four = _mm_cvtsi128_si32(packed);
+            memcpy(out + c, &four, 4);
+        }
+#endif
+        for (; c < cols; c++)
+            out[c] = bestDirection(pad(c, r));
+    }
+
+    // Fecha p: remove (em ordem de distância) quem só tinha caminho por ela e preenche de
+    // novo a partir das células válidas em volta da região removida
+    void closeCell(int p)
+    {
+        const int offs[4] = {1, -1, W, -W};
+        int32_t d0 = cost[p];
+        cost[p] = UNREACHED;
+        if (d0 == UNREACHED)
+            return;
+
+        // Em ordem FIFO, todas as remoções de distância d são decididas antes de olhar
+        // qualquer célula de distância d + 1, então "ainda tem outro vizinho a d - 1" é exato
+        removed.clear();
+        removed.push_back(p);
+        removedCost.clear();
+        removedCost.push_back(d0);
+        for (size_t i = 0; i < removed.size(); i++)
+        {
+            int u = removed[i];
+            int32_t du = removedCost[i];
+            for (int k = 0; k < 4; k++)
+            {
+                int v = u + offs[k];
+                if (!open[v] || cost[v] != du + 1)
+                    continue;
+                bool otherParent = false;
+                for (int j = 0; j < 4 && !otherParent; j++)
+                    otherParent = cost[v + offs[j]] == du;
+                if (otherParent)
+                    continue;
+                cost[v] = UNREACHED;
+                removed.push_back(v);
+                removedCost.push_back(du + 1);
+                touched.push_back(v);
+            }
+        }
+
+        // Borda válida da região, em ordem de distância, intercalada com a própria BFS
+        seeds.clear();
+        for (int u : removed)
+            for (int k = 0; k < 4; k++)
+            {
+                int w = u + offs[k];
+                if (open[w] && cost[w] != UNREACHED)
+                    seeds.push_back(w);
+            }
+        std::sort(seeds.begin(), seeds.end(), [&](int a, int b) { return cost[a] < cost[b]; });
+        next.clear();
+        size_t head = 0, si = 0;
+        while (head < next.size() || si < seeds.size())
+        {
+            int u;
+            if (si < seeds.size() && (head == next.size() || cost[seeds[si]] <= cost[next[head]]))
+                u = seeds[si++];
+            else
+                u = next[head++];
+            for (int k = 0; k < 4; k++)
+            {
+                int v = u + offs[k];
+                if (open[v] && cost[v] > cost[u] + 1)
+                {
+                    cost[v] = cost[u] + 1;
+                    next.push_back(v);
+                    touched.push_back(v);
+                }
+            }
+        }
+    }
+
+    // Abre p: distância pelo melhor vizinho e propagação da melhora (uma fonte só, FIFO basta)
+    void openCell(int p)
+    {
+        const int offs[4] = {1, -1, W, -W};
+        if (goalPad < 0 && p == pad(goalCell.col, goalCell.row))
+        {
+            // O destino voltou a existir: refaz o campo
+            goalPad = p;
+            integrate(nullptr);
+            computeDirections(nullptr);
+            return;
+        }
+        int32_t best = UNREACHED;
+        for (int k = 0; k < 4; k++)
+            if (cost[p + offs[k]] != UNREACHED && cost[p + offs[k]] + 1 < best)
+                best = cost[p + offs[k]] + 1;
+        cost[p] = best;
+        if (best == UNREACHED)
+            return;
+        next.clear();
+        next.push_back(p);
+        for (size_t head = 0; head < next.size(); head++)
+        {
+            int u = next[head];
+            for (int k = 0; k < 4; k++)
+            {
+                int v = u + offs[k];
+                if (open[v] && cost[v] > cost[u] + 1)
+                {
+                    cost[v] = cost[u] + 1;
+                    next.push_back(v);
+                    touched.push_back(v);
+                }
+            }
+        }
+    }
+};
+
+class FlowFieldCache
+{
+public:
+    FlowFieldCache(const PathGrid &grid, int capacity = 8, ThreadPool *pool = nullptr)
+        : grid(grid), capacity(capacity), pool(pool), clock(0) {}
+
+    // Campo para o destino: o guardado, se houver, ou um novo (descartando o menos usado)
+    FlowField &get(GridPoint goal, float tileW, float tileH, float left, float top)
+    {
+        clock++;
+        for (Entry &e : entries)
+            if (e.field->goal() == goal)
+            {
+                e.lastUse = clock;
+                return *e.field;
+            }
+        Entry *slot = nullptr;
+        if ((int)entries.size() < capacity)
+        {
+            entries.push_back({std::unique_ptr<FlowField>(new FlowField(grid)), 0});
+            slot = &entries.back();
+        }
+        else
+        {
+            slot = &entries[0];
+            for (Entry &e : entries)
+                if (e.lastUse < slot->lastUse)
+                    slot = &e;
+        }
+        slot->lastUse = clock;
+        FlowField &f = *slot->field;
+        f.tileW = tileW;
+        f.tileH = tileH;
+        f.left = left;
+        f.top = top;
+        f.build(goal, pool);
+        return f;
+    }
+
+    // Repassa a mudança de um tile (já aplicada em grid) a todos os campos guardados
+    void tileChanged(int col, int row)
+    {
+        for (Entry &e : entries)
+            e.field->tileChanged(col, row);
+    }
+
+    int size() const { return (int)entries.size(); }
+
+private:
+    struct Entry
+    {
+        std::unique_ptr<FlowField> field;
+        uint64_t lastUse;
+    };
+
+    const PathGrid &grid;
+    int capacity;
+    ThreadPool *pool;
+    uint64_t clock;
+    std::vector<Entry> entries;
+};
@@ -0,0 +1,206 @@
+/*
+ * FramePacer - controle do ritmo dos frames e medição da latência entrada -> apresentação
+ *
+ * Modos:
+ *   PACE_VSYNC       glfwSwapInterval(1): o swap espera o retraço vertical. Sem tearing,
+ *                    mas a entrada lida no início do frame pode esperar até um retraço inteiro.
+ *   PACE_ADAPTIVE    glfwSwapInterval(-1) (extensão *_swap_control_tear): sincroniza quando
+ *                    o frame fica pronto a tempo e troca imediatamente quando atrasa, em vez de
+ *                    esperar o próximo retraço. Sem a extensão, cai para PACE_VSYNC.
+ *   PACE_CAPPED      sem vsync, limitado a targetFps: dorme até perto do prazo e completa a
+ *                    espera girando (spin), pois o sleep do sistema pode acordar com atraso de
+ *                    1 ms ou mais. A margem do spin se ajusta ao maior atraso de sleep medido.
+ *   PACE_UNTHROTTLED sem vsync e sem limite (benchmarks). Ocupa um núcleo inteiro.
+ *
+ * Latência: markInput() logo depois de glfwPollEvents() e present() no lugar de
+ * glfwSwapBuffers(). A latência medida vai da leitura da entrada até o retorno do swap,
+ * que é o que o modo de ritmo controla (o tempo de varredura do monitor não entra).
+ *
+ * Na linha de comando: --pacing vsync|adaptive|capped|unthrottled e --fps N.
+ */
+
+#pragma once
+
+#include <GLFW/glfw3.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+enum PacingMode
+{
+    PACE_VSYNC = 0,
+    PACE_ADAPTIVE,
+    PACE_CAPPED,
+    PACE_UNTHROTTLED,
+    N_PACING_MODES
+};
+
+class FramePacer
+{
+public:
+    static const int LATENCY_SAMPLES = 240;
+
+    FramePacer()
+        : mode(PACE_VSYNC), targetFps(60.0), spinMarginS(0.002), adaptiveSupported(false),
+          inputTime(-1.0), nextDeadline(0.0), nSamples(0), nextSample(0)
+    {
+    }
+
+    // Lê --pacing e --fps (chamar antes de apply())
+    void parseArgs(int argc, char **argv)
+    {
+        for (int i = 1; i < argc - 1; i++)
+        {
+            if (strcmp(argv[i], "--pacing") == 0)
+            {
+                for (int m = 0; m < N_PACING_MODES; m++)
+                    if (strcmp(argv[i + 1], modeName((PacingMode)m)) == 0)
+                        mode = (PacingMode)m;
+            }
+            else if (strcmp(argv[i], "--fps") == 0)
+                targetFps = atof(argv[i + 1]);
+        }
+        if (targetFps <= 0.0)
+            targetFps = 60.0;
+    }
+
+    // Aplica o modo atual ao contexto corrente (precisa de contexto OpenGL ativo)
+    void apply()
+    {
+        adaptiveSupported = glfwExtensionSupported("WGL_EXT_swap_control_tear") ||
+                            glfwExtensionSupported("GLX_EXT_swap_control_tear");
+        switch (mode)
+        {
+        case PACE_VSYNC:
+            glfwSwapInterval(1);
+            break;
+        case PACE_ADAPTIVE:
+            glfwSwapInterval(adaptiveSupported ? -1 : 1);
+            break;
+        case PACE_CAPPED:
+        case PACE_UNTHROTTLED:
+            glfwSwapInterval(0);
+            break;
+        default:
+            break;
+        }
+        nextDeadline = now();
+        nSamples = 0;
+        nextSample = 0;
+    }
+
+    void setMode(PacingMode m)
+    {
+        mode = m;
+        apply();
+    }
+
+    // Passa para o próximo modo (para alternar por tecla)
+    void cycleMode() { setMode((PacingMode)((mode + 1) % N_PACING_MODES)); }
+
+    void setTargetFps(double fps)
+    {
+        if (fps > 0.0)
+            targetFps = fps;
+    }
+
+    PacingMode currentMode() const { return mode; }
+
+    static const char *modeName(PacingMode m)
+    {
+        static const char *names[N_PACING_MODES] = {"vsync", "adaptive", "capped", "unthrottled"};
+        return m < N_PACING_MODES ? names[m] : "?";
+    }
+
+    // Instante em que a entrada do frame foi lida (logo após glfwPollEvents)
+    void markInput() { inputTime = now(); }
+
+    // Espera o prazo do modo limitado, troca os buffers e registra a latência
+    void present(GLFWwindow *window)
+    {
+        if (mode == PACE_CAPPED)
+            waitForDeadline();
+        glfwSwapBuffers(window);
+        double t = now();
+        if (inputTime >= 0.0)
+        {
+            latencies[nextSample] = (t - inputTime) * 1000.0;
+            nextSample = (nextSample + 1) % LATENCY_SAMPLES;
+            if (nSamples < LATENCY_SAMPLES)
+                nSamples++;
+            inputTime = -1.0;
+        }
+    }
+
+    // Latência média e máxima (ms) nas últimas LATENCY_SAMPLES apresentações
+    void latencyStats(double &avgMs, double &maxMs) const
+    {
+        avgMs = maxMs = 0.0;
+        for (int i = 0; i < nSamples; i++)
+        {
+            avgMs += latencies[i];
+            if (latencies[i] > maxMs)
+                maxMs = latencies[i];
+        }
+        if (nSamples > 0)
+            avgMs /= nSamples;
+    }
+
+    // Texto curto para a barra de título, ex.: "capped 60 | latencia 3.1/5.2 ms"
+    void describe(char *out, size_t size) const
+    {
+        double avg, mx;
+        latencyStats(avg, mx);
+        if (mode == PACE_CAPPED)
+            snprintf(out, size, "%s %.0f | latencia %.1f/%.1f ms (med/max)", modeName(mode), targetFps, avg, mx);
+        else if (mode == PACE_ADAPTIVE && !adaptiveSupported)
+            snprintf(out, size, "adaptive (sem suporte: vsync) | latencia %.1f/%.1f ms (med/max)", avg, mx);
+        else
+            snprintf(out, size, "%s | latencia %.1f/%.1f ms (med/max)", modeName(mode), avg, mx);
+    }
+
+private:
+    PacingMode mode;
+    double targetFps;
+    double spinMarginS; // quanto antes do prazo o sleep termina e o spin começa
+    bool adaptiveSupported;
+    double inputTime;
+    double nextDeadline;
+    double latencies[LATENCY_SAMPLES];
+    int nSamples, nextSample;
+
+    static double now()
+    {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    void waitForDeadline()
+    {
+        double period = 1.0 / targetFps;
+        nextDeadline += period;
+        double t = now();
+        // Muito atrasado (ex.: janela arrastada): recomeça a contagem em vez de tentar
+        // recuperar com vários frames seguidos sem espera
+        if (t > nextDeadline + period)
+            nextDeadline = t;
+
+        double sleepFor = nextDeadline - t - spinMarginS;
+        if (sleepFor > 0.0)
+        {
+            std::this_thread::sleep_for(std::chrono::duration<double>(sleepFor));
+            double overshoot = now() - (t + sleepFor);
+            // A margem cresce logo com um atraso grande e diminui devagar quando o sleep é preciso
+            if (overshoot > spinMarginS)
+                spinMarginS = overshoot * 1.25;
+            else
+                spinMarginS = spinMarginS * 0.99 + overshoot * 1.25 * 0.01;
+            if (spinMarginS < 0.0002)
+                spinMarginS = 0.0002;
+        }
+        while (now() < nextDeadline)
+            std::this_thread::yield();
+    }
+};
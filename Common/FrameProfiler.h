@@ -0,0 +1,392 @@
+/*
+ * FrameProfiler - medição de tempo de CPU e GPU por frame
+ *
+ * Uso típico no game loop:
+ *     profiler.beginFrame();
+ *     {
+ *         ProfileScope s(profiler, "tilemap");      // tempo de CPU do bloco
+ *         GpuProfileScope g(profiler, "tilemap");   // tempo de GPU do mesmo bloco
+ *         drawTilemap(...);
+ *     }
+ *     profiler.endFrame();
+ *     glfwSwapBuffers(window);
+ *
+ * CPU: os escopos são RAII (o destrutor fecha o intervalo) e podem ser aninhados.
+ *
+ * GPU: o tempo total de GPU do frame usa um par glBeginQuery/glEndQuery(GL_TIME_ELAPSED).
+ * Os escopos de GPU usam pares de glQueryCounter(GL_TIMESTAMP), que, diferente de
+ * GL_TIME_ELAPSED, podem ser aninhados e dão a posição absoluta no tempo (para o trace).
+ * O resultado de uma query só fica pronto alguns frames depois; ler antes disso faria a
+ * CPU esperar a GPU. Por isso há QUERY_LATENCY conjuntos de queries em rodízio: a cada
+ * frame só são lidos os conjuntos já disponíveis (GL_QUERY_RESULT_AVAILABLE). Se um
+ * conjunto ainda não estiver pronto quando precisar ser reutilizado, o frame fica sem
+ * tempo de GPU (gpuMs < 0) em vez de travar.
+ *
+ * Os últimos HISTORY frames (ou mais, ver setHistory) ficam num anel, de onde saem as
+ * estatísticas (mín/média/p99) e o trace no formato JSON do Chrome (chrome://tracing ou
+ * ui.perfetto.dev).
+ */
+
+#pragma once
+
+#include <glad/glad.h>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+struct ProfileEvent
+{
+    const char *name;
+    double startUs;    // relativo ao início do profiler, em microssegundos
+    double durationUs;
+    bool gpu;
+};
+
+struct FrameRecord
+{
+    uint64_t frameIndex;
+    double startUs;
+    double frameMs; // intervalo entre o início deste frame e o do anterior
+    double cpuMs;   // de beginFrame a endFrame
+    double gpuMs;   // < 0 enquanto (ou se) o resultado da GPU não estiver disponível
+    std::vector<ProfileEvent> events;
+};
+
+struct ProfileStat
+{
+    double min, avg, p99;
+    int samples;
+};
+
+class FrameProfiler
+{
+public:
+    static const int HISTORY = 512;
+    static const int QUERY_LATENCY = 4;
+
+    FrameProfiler() : frameCount(0), current(nullptr), gpuEnabled(false), gpuOffsetUs(0.0), lastFrameStartUs(-1.0)
+    {
+        origin = std::chrono::steady_clock::now();
+        history.resize(HISTORY);
+    }
+
+    // Aumenta o anel para guardar "frames" frames (nunca menos que HISTORY). Deve ser
+    // chamada antes do primeiro frame; o benchmark usa para cobrir a execução inteira.
+    void setHistory(int frames)
+    {
+        history.resize(frames > HISTORY ? frames : HISTORY);
+    }
+
+    // Cria as queries de GPU. Precisa de contexto OpenGL; sem chamar init() só a CPU é medida.
+    void init()
+    {
+        for (int i = 0; i < QUERY_LATENCY; i++)
+        {
+            glGenQueries(1, &slots[i].elapsedQuery);
+            slots[i].pending = false;
+        }
+        // Relógio da GPU (ns) -> relógio do profiler (us), para alinhar os eventos no trace
+        GLint64 gpuNow = 0;
+        glGetInteger64v(GL_TIMESTAMP, &gpuNow);
+        gpuOffsetUs = nowUs() - gpuNow / 1000.0;
+        gpuEnabled = true;
+    }
+
+    void destroy()
+    {
+        if (!gpuEnabled)
+            return;
+        for (int i = 0; i < QUERY_LATENCY; i++)
+        {
+            glDeleteQueries(1, &slots[i].elapsedQuery);
+            if (!slots[i].timestamps.empty())
+                glDeleteQueries((GLsizei)slots[i].timestamps.size(), slots[i].timestamps.data());
+            slots[i].timestamps.clear();
+        }
+        gpuEnabled = false;
+    }
+
+    void beginFrame()
+    {
+        double now = nowUs();
+        if (gpuEnabled)
+            collectGpu(false);
+
+        current = &history[frameCount % history.size()];
+        current->frameIndex = frameCount;
+        current->startUs = now;
+        current->frameMs = lastFrameStartUs < 0.0 ? 0.0 : (now - lastFrameStartUs) / 1000.0;
+        current->cpuMs = 0.0;
+        current->gpuMs = -1.0;
+        current->events.clear();
+        lastFrameStartUs = now;
+
+        if (gpuEnabled)
+        {
+            QuerySlot &slot = slots[frameCount % QUERY_LATENCY];
+            // Conjunto ainda ocupado (GPU mais de QUERY_LATENCY frames atrás): descarta o resultado
+            if (slot.pending)
+                collectSlot(slot, true);
+            slot.frameIndex = frameCount;
+            slot.scopes.clear();
+            slot.used = 0;
+            slot.pending = true;
+            glBeginQuery(GL_TIME_ELAPSED, slot.elapsedQuery);
+        }
+    }
+
+    void endFrame()
+    {
+        if (!current)
+            return;
+        if (gpuEnabled)
+            glEndQuery(GL_TIME_ELAPSED);
+        current->cpuMs = (nowUs() - current->startUs) / 1000.0;
+        current = nullptr;
+        frameCount++;
+    }
+
+    // Escopos de CPU (ver ProfileScope). Retorna o índice do evento para fechá-lo depois.
+    int beginCpu(const char *name)
+    {
+        if (!current)
+            return -1;
+        ProfileEvent e = {name, nowUs(), 0.0, false};
+        current->events.push_back(e);
+        return (int)current->events.size() - 1;
+    }
+
+    void endCpu(int event)
+    {
+        if (!current || event < 0)
+            return;
+        ProfileEvent &e = current->events[event];
+        e.durationUs = nowUs() - e.startUs;
+    }
+
+    // Escopos de GPU (ver GpuProfileScope): um par de timestamps no conjunto do frame atual
+    int beginGpu(const char *name)
+    {
+        if (!gpuEnabled || !current)
+            return -1;
+        QuerySlot &slot = slots[frameCount % QUERY_LATENCY];
+        GpuScope s = {name, slot.used, slot.used + 1};
+        slot.used += 2;
+        while ((int)slot.timestamps.size() < slot.used)
+        {
+            GLuint q;
+            glGenQueries(1, &q);
+            slot.timestamps.push_back(q);
+        }
+        glQueryCounter(slot.timestamps[s.beginQuery], GL_TIMESTAMP);
+        slot.scopes.push_back(s);
+        return (int)slot.scopes.size() - 1;
+    }
+
+    void endGpu(int scope)
+    {
+        if (!gpuEnabled || !current || scope < 0)
+            return;
+        QuerySlot &slot = slots[frameCount % QUERY_LATENCY];
+        glQueryCounter(slot.timestamps[slot.scopes[scope].endQuery], GL_TIMESTAMP);
+    }
+
+    // Estatísticas dos frames no histórico. Campo: 0 = frame, 1 = CPU, 2 = GPU.
+    ProfileStat stat(int field) const
+    {
+        std::vector<double> values;
+        int n = frameCount < (uint64_t)history.size() ? (int)frameCount : (int)history.size();
+        values.reserve(n);
+        for (int i = 0; i < n; i++)
+        {
+            const FrameRecord &r = history[i];
+            if (r.frameIndex >= frameCount)
+                continue; // frame em andamento
+            double v = field == 0 ? r.frameMs : (field == 1 ? r.cpuMs : r.gpuMs);
+            if (field == 0 && r.frameIndex == 0)
+                continue; // o primeiro frame não tem anterior
+            if (v >= 0.0)
+                values.push_back(v);
+        }
+        ProfileStat s = {0.0, 0.0, 0.0, (int)values.size()};
+        if (values.empty())
+            return s;
+        // qsort em vez de std::sort: <algorithm> traz std::count, que colide com a global
+        // "count" de alguns exemplos (using namespace std)
+        qsort(values.data(), values.size(), sizeof(double), compareDouble);
+        double sum = 0.0;
+        for (double v : values)
+            sum += v;
+        s.min = values.front();
+        s.avg = sum / values.size();
+        size_t p99 = (size_t)(values.size() * 0.99);
+        s.p99 = values[p99 < values.size() ? p99 : values.size() - 1];
+        return s;
+    }
+
+    ProfileStat frameStat() const { return stat(0); }
+    ProfileStat cpuStat() const { return stat(1); }
+    ProfileStat gpuStat() const { return stat(2); }
+
+    // Texto curto para a barra de título
+    std::string summary() const
+    {
+        ProfileStat f = frameStat(), c = cpuStat(), g = gpuStat();
+        char tmp[256];
+        int n = snprintf(tmp, sizeof(tmp), "FPS %.1f | frame %.2f/%.2f ms (med/p99) | CPU %.2f ms",
+                         f.avg > 0.0 ? 1000.0 / f.avg : 0.0, f.avg, f.p99, c.avg);
+        if (g.samples > 0)
+            snprintf(tmp + n, sizeof(tmp) - n, " | GPU %.2f ms", g.avg);
+        return tmp;
+    }
+
+    void printStats() const
+    {
+        const char *names[3] = {"frame", "CPU", "GPU"};
+        for (int i = 0; i < 3; i++)
+        {
+            ProfileStat s = stat(i);
+            printf("%-5s  min %7.3f  media %7.3f  p99 %7.3f ms  (%d amostras)\n", names[i], s.min, s.avg, s.p99, s.samples);
+        }
+    }
+
+    // Grava os frames do histórico no formato Trace Event do Chrome
+    bool exportChromeTrace(const char *path)
+    {
+        if (gpuEnabled)
+            collectGpu(false);
+        FILE *f = fopen(path, "w");
+        if (!f)
+            return false;
+        fprintf(f, "{\"traceEvents\":[\n");
+        fprintf(f, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,\"args\":{\"name\":\"CPU\"}},\n");
+        fprintf(f, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":2,\"args\":{\"name\":\"GPU\"}}");
+        uint64_t first = frameCount > history.size() ? frameCount - history.size() : 0;
+        for (uint64_t i = first; i < frameCount; i++)
+        {
+            const FrameRecord &r = history[i % history.size()];
+            fprintf(f, ",\n{\"name\":\"frame %llu\",\"cat\":\"frame\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":1}",
+                    (unsigned long long)r.frameIndex, r.startUs, r.cpuMs * 1000.0);
+            for (const ProfileEvent &e : r.events)
+                fprintf(f, ",\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%d}",
+                        e.name, e.gpu ? "gpu" : "cpu", e.startUs, e.durationUs, e.gpu ? 2 : 1);
+        }
+        fprintf(f, "\n]}\n");
+        fclose(f);
+        return true;
+    }
+
+    uint64_t frames() const { return frameCount; }
+
+    // Registro de um frame já finalizado (0 = o mais recente)
+    const FrameRecord &recent(int back) const { return history[(frameCount - 1 - back) % history.size()]; }
+
+private:
+    struct GpuScope
+    {
+        const char *name;
+        int beginQuery, endQuery;
+    };
+
+    struct QuerySlot
+    {
+        GLuint elapsedQuery;
+        std::vector<GLuint> timestamps; // cresce conforme o número de escopos por frame
+        std::vector<GpuScope> scopes;
+        int used;
+        uint64_t frameIndex;
+        bool pending;
+    };
+
+    std::chrono::steady_clock::time_point origin;
+    std::vector<FrameRecord> history;
+    QuerySlot slots[QUERY_LATENCY];
+    uint64_t frameCount;
+    FrameRecord *current;
+    bool gpuEnabled;
+    double gpuOffsetUs;
+    double lastFrameStartUs;
+
+    static int compareDouble(const void *a, const void *b)
+    {
+        double x = *(const double *)a, y = *(const double *)b;
+        return x < y ? -1 : (x > y ? 1 : 0);
+    }
+
+    double nowUs() const
+    {
+        return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - origin).count();
+    }
+
+    void collectGpu(bool discard)
+    {
+        for (int i = 0; i < QUERY_LATENCY; i++)
+            if (slots[i].pending && slots[i].frameIndex < frameCount)
+                collectSlot(slots[i], discard);
+    }
+
+    // Lê os resultados do conjunto se estiverem prontos; com discard, libera-o mesmo sem resultado
+    void collectSlot(QuerySlot &slot, bool discard)
+    {
+        GLint available = 0;
+        glGetQueryObjectiv(slot.elapsedQuery, GL_QUERY_RESULT_AVAILABLE, &available);
+        if (available && slot.used > 0)
+        {
+            // As queries terminam em ordem: se a última está pronta, todas estão
+            glGetQueryObjectiv(slot.timestamps[slot.used - 1], GL_QUERY_RESULT_AVAILABLE, &available);
+        }
+        if (!available)
+        {
+            if (discard)
+                slot.pending = false;
+            return;
+        }
+        slot.pending = false;
+
+        // O registro pode ter sido sobrescrito se a GPU estiver mais frames atrás do que cabem no anel
+        if (frameCount - slot.frameIndex > history.size())
+            return;
+        FrameRecord &r = history[slot.frameIndex % history.size()];
+
+        GLuint64 elapsedNs = 0;
+        glGetQueryObjectui64v(slot.elapsedQuery, GL_QUERY_RESULT, &elapsedNs);
+        r.gpuMs = elapsedNs / 1.0e6;
+
+        for (const GpuScope &s : slot.scopes)
+        {
+            GLuint64 t0 = 0, t1 = 0;
+            glGetQueryObjectui64v(slot.timestamps[s.beginQuery], GL_QUERY_RESULT, &t0);
+            glGetQueryObjectui64v(slot.timestamps[s.endQuery], GL_QUERY_RESULT, &t1);
+            ProfileEvent e = {s.name, t0 / 1000.0 + gpuOffsetUs, (t1 - t0) / 1000.0, true};
+            r.events.push_back(e);
+        }
+    }
+};
+
+// Mede o tempo de CPU de um bloco de código (do construtor ao destrutor)
+class ProfileScope
+{
+public:
+    ProfileScope(FrameProfiler &profiler, const char *name) : profiler(profiler), event(profiler.beginCpu(name)) {}
+    ~ProfileScope() { profiler.endCpu(event); }
+
+private:
+    FrameProfiler &profiler;
+    int event;
+};
+
+// Mede o tempo de GPU dos comandos emitidos dentro do bloco
+class GpuProfileScope
+{
+public:
+    GpuProfileScope(FrameProfiler &profiler, const char *name) : profiler(profiler), scope(profiler.beginGpu(name)) {}
+    ~GpuProfileScope() { profiler.endGpu(scope); }
+
+private:
+    FrameProfiler &profiler;
+    int scope;
+};
@@ -0,0 +1,62 @@
+/*
+ * GLExt - funções OpenGL posteriores à versão 4.0
+ *
+ * A GLAD deste repositório foi gerada para OpenGL 4.0. Algumas técnicas dos exemplos
+ * (buffers persistentes, multi-draw indireto etc.) usam funções de versões posteriores.
+ * Este cabeçalho declara essas funções no mesmo estilo da GLAD e as carrega via GLFW.
+ * Se a GLAD for regerada com uma versão mais nova, as declarações daqui são ignoradas.
+ *
+ * Uso: chamar loadGLExt() logo após gladLoadGLLoader(). Cada função pode continuar nula
+ * se o driver não a suportar; quem usa deve testar antes (ex.: if (glBufferStorage)).
+ */
+
+#pragma once
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+// OpenGL 4.2 - desenho com baseInstance (desloca os atributos instanciados)
+#ifndef GL_VERSION_4_2
+typedef void (APIENTRYP PFNGLDRAWELEMENTSINSTANCEDBASEVERTEXBASEINSTANCEPROC)(GLenum mode, GLsizei count, GLenum type, const void *indices, GLsizei instancecount, GLint basevertex, GLuint baseinstance);
+inline PFNGLDRAWELEMENTSINSTANCEDBASEVERTEXBASEINSTANCEPROC glext_glDrawElementsInstancedBaseVertexBaseInstance = nullptr;
+#define glDrawElementsInstancedBaseVertexBaseInstance glext_glDrawElementsInstancedBaseVertexBaseInstance
+#endif
+
+// OpenGL 4.3 - vários desenhos indiretos numa única chamada
+#ifndef GL_VERSION_4_3
+typedef void (APIENTRYP PFNGLMULTIDRAWELEMENTSINDIRECTPROC)(GLenum mode, GLenum type, const void *indirect, GLsizei drawcount, GLsizei stride);
+inline PFNGLMULTIDRAWELEMENTSINDIRECTPROC glext_glMultiDrawElementsIndirect = nullptr;
+#define glMultiDrawElementsIndirect glext_glMultiDrawElementsIndirect
+#endif
+
+// OpenGL 4.4 - armazenamento imutável de buffers (mapeamento persistente)
+#ifndef GL_VERSION_4_4
+#define GL_MAP_PERSISTENT_BIT 0x0040
+#define GL_MAP_COHERENT_BIT 0x0080
+#define GL_DYNAMIC_STORAGE_BIT 0x0100
+#define GL_CLIENT_STORAGE_BIT 0x0200
+typedef void (APIENTRYP PFNGLBUFFERSTORAGEPROC)(GLenum target, GLsizeiptr size, const void *data, GLbitfield flags);
+inline PFNGLBUFFERSTORAGEPROC glext_glBufferStorage = nullptr;
+#define glBufferStorage glext_glBufferStorage
+#endif
+
+// Carrega as funções declaradas acima. Retorna false se alguma não estiver disponível.
+inline bool loadGLExt()
+{
+    bool ok = true;
+#ifndef GL_VERSION_4_2
+    glext_glDrawElementsInstancedBaseVertexBaseInstance = (PFNGLDRAWELEMENTSINSTANCEDBASEVERTEXBASEINSTANCEPROC)glfwGetProcAddress("glDrawElementsInstancedBaseVertexBaseInstance");
+#endif
+#ifndef GL_VERSION_4_3
+    glext_glMultiDrawElementsIndirect = (PFNGLMULTIDRAWELEMENTSINDIRECTPROC)glfwGetProcAddress("glMultiDrawElementsIndirect");
+#endif
+#ifndef GL_VERSION_4_4
+    glext_glBufferStorage = (PFNGLBUFFERSTORAGEPROC)glfwGetProcAddress("glBufferStorage");
+    if (!glext_glBufferStorage)
+        glext_glBufferStorage = (PFNGLBUFFERSTORAGEPROC)glfwGetProcAddress("glBufferStorageARB");
+#endif
+    ok = ok && glDrawElementsInstancedBaseVertexBaseInstance != nullptr;
+    ok = ok && glMultiDrawElementsIndirect != nullptr;
+    ok = ok && glBufferStorage != nullptr;
+    return ok;
+}
@@ -0,0 +1,80 @@
+/*
+ * GameLoop - passo fixo de simulação, independente da taxa de quadros
+ *
+ * Mover "pos += vel" uma vez por frame faz a velocidade depender do FPS. Aqui o tempo
+ * real de cada frame entra num acumulador, e a simulação avança em passos de duração
+ * fixa (por padrão 1/60 s) enquanto houver tempo acumulado:
+ *
+ *     int steps = gameLoop.advance(elapsed_s);
+ *     for (int i = 0; i < steps; i++)
+ *         simula(gameLoop.step());          // guarda o estado anterior antes de mudar
+ *     desenha(mix(anterior, atual, gameLoop.alpha()));
+ *
+ * alpha() é a fração de passo que sobrou no acumulador: desenhar o estado interpolado
+ * entre o passo anterior e o atual evita trepidação quando FPS e passo não coincidem.
+ *
+ * Se um frame demorar muito (janela arrastada, breakpoint), simular todo o atraso de
+ * uma vez deixaria o frame seguinte ainda mais lento ("espiral da morte"). Por isso
+ * cada chamada roda no máximo maxSteps passos; o excedente é descartado e contado em
+ * droppedSteps(). Com o mesmo passo, a simulação é determinística: dá o mesmo
+ * resultado com qualquer FPS, e pode rodar sem renderizar a milhares de passos/s.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+class FixedTimestep
+{
+public:
+    FixedTimestep(double stepSeconds = 1.0 / 60.0, int maxSteps = 5)
+        : stepSeconds(stepSeconds), maxSteps(maxSteps), accumulator(0.0), ticks(0), dropped(0)
+    {
+    }
+
+    // Acrescenta o tempo real do frame e retorna quantos passos simular agora
+    int advance(double elapsedSeconds)
+    {
+        if (elapsedSeconds < 0.0)
+            elapsedSeconds = 0.0;
+        accumulator += elapsedSeconds;
+
+        int steps = (int)(accumulator / stepSeconds);
+        if (steps > maxSteps)
+        {
+            dropped += (uint64_t)(steps - maxSteps);
+            steps = maxSteps;
+            // Mantém só a fração de passo: o atraso descartado não volta nos próximos frames
+            accumulator -= (int)(accumulator / stepSeconds) * stepSeconds;
+        }
+        else
+            accumulator -= steps * stepSeconds;
+
+        ticks += (uint64_t)steps;
+        return steps;
+    }
+
+    // Fração [0, 1) do próximo passo já decorrida, para interpolar o desenho
+    float alpha() const { return (float)(accumulator / stepSeconds); }
+
+    double step() const { return stepSeconds; }
+    uint64_t tick() const { return ticks; }
+    double simulatedTime() const { return ticks * stepSeconds; }
+    uint64_t droppedSteps() const { return dropped; }
+
+    void setMaxSteps(int steps) { maxSteps = steps; }
+
+    void reset()
+    {
+        accumulator = 0.0;
+        ticks = 0;
+        dropped = 0;
+    }
+
+private:
+    double stepSeconds;
+    int maxSteps;
+    double accumulator;
+    uint64_t ticks;
+    uint64_t dropped;
+};
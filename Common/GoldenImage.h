@@ -0,0 +1,224 @@
+/*
+ * GoldenImage - captura de um frame e comparação com uma imagem de referência (PNG)
+ *
+ * Serve para validar que uma otimização não mudou o que aparece na tela. O frame é
+ * copiado com glReadPixels para um pixel buffer object (PBO): a cópia é assíncrona e só
+ * é lida (glMapBuffer) no final da execução, sem travar o frame capturado.
+ *
+ * A comparação tolera pequenas diferenças de rasterização entre drivers: a diferença de
+ * cada pixel é a distância RGB ponderada pela sensibilidade do olho a cada canal (pesos
+ * de luminância 0.299/0.587/0.114), normalizada em [0, 1]. Um pixel conta como diferente
+ * se passar de pixelTolerance; a imagem falha se a fração de pixels diferentes passar de
+ * maxDifferentFraction. Na falha é gravada uma imagem de diferenças: a referência em
+ * cinza escuro com os pixels diferentes em vermelho (mais forte = maior diferença).
+ *
+ * Precisa da stb_image (leitura do PNG) com a implementação definida no exemplo. A
+ * stb_image_write é incluída aqui com implementação estática.
+ */
+
+#pragma once
+
+#include <glad/glad.h>
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <stb_image.h>
+
+#define STB_IMAGE_WRITE_STATIC
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include <stb_image_write.h>
+
+struct ImageDiff
+{
+    int width, height;
+    int differentPixels;
+    double differentFraction;
+    double maxDelta, meanDelta;
+    bool passed;
+};
+
+// Compara duas imagens RGBA8 do mesmo tamanho. Se diffImage não for nulo, recebe a
+// imagem de diferenças (RGBA8).
+inline ImageDiff compareImages(const uint8_t *actual, const uint8_t *golden, int width, int height,
+                               double pixelTolerance, double maxDifferentFraction, std::vector<uint8_t> *diffImage)
+{
+    ImageDiff d = {width, height, 0, 0.0, 0.0, 0.0, true};
+    size_t n = (size_t)width * height;
+    if (diffImage)
+        diffImage->resize(n * 4);
+
+    double sum = 0.0;
+    for (size_t i = 0; i < n; i++)
+    {
+        const uint8_t *a = actual + i * 4;
+        const uint8_t *g = golden + i * 4;
+        double dr = (a[0] - g[0]) / 255.0;
+        double dg = (a[1] - g[1]) / 255.0;
+        double db = (a[2] - g[2]) / 255.0;
+        double delta = sqrt(0.299 * dr * dr + 0.587 * dg * dg + 0.114 * db * db);
+        sum += delta;
+        if (delta > d.maxDelta)
+            d.maxDelta = delta;
+        bool different = delta > pixelTolerance;
+        if (different)
+            d.differentPixels++;
+
+        if (diffImage)
+        {
+            uint8_t *o = diffImage->data() + i * 4;
+            if (different)
+            {
+                double k = 0.5 + 0.5 * (delta < 1.0 ? delta : 1.0);
+                o[0] = (uint8_t)(255.0 * k);
+                o[1] = 0;
+                o[2] = 0;
+            }
+            else
+            {
+                uint8_t gray = (uint8_t)((g[0] * 77 + g[1] * 150 + g[2] * 29) >> 10); // ~1/4 da luminância
+                o[0] = o[1] = o[2] = gray;
+            }
+            o[3] = 255;
+        }
+    }
+    d.meanDelta = n > 0 ? sum / n : 0.0;
+    d.differentFraction = n > 0 ? (double)d.differentPixels / n : 0.0;
+    d.passed = d.differentFraction <= maxDifferentFraction;
+    return d;
+}
+
+// Grava RGBA8 em PNG. flipY: as linhas vêm de baixo para cima (como no glReadPixels).
+inline bool writePNG(const char *path, const uint8_t *rgba, int width, int height, bool flipY)
+{
+    stbi_flip_vertically_on_write(flipY ? 1 : 0);
+    int ok = stbi_write_png(path, width, height, 4, rgba, width * 4);
+    stbi_flip_vertically_on_write(0);
+    return ok != 0;
+}
+
+// Cópia assíncrona do framebuffer atual para um PBO
+class FrameCapture
+{
+public:
+    FrameCapture() : pbo(0), width(0), height(0), pending(false) {}
+
+    // Inicia a cópia (não espera a GPU). Lê do framebuffer de leitura ligado no momento.
+    void request(int w, int h)
+    {
+        width = w;
+        height = h;
+        if (!pbo)
+            glGenBuffers(1, &pbo);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, pbo);
+        glBufferData(GL_PIXEL_PACK_BUFFER, (GLsizeiptr)w * h * 4, nullptr, GL_STREAM_READ);
+        glPixelStorei(GL_PACK_ALIGNMENT, 1);
+        glReadPixels(0, 0, w, h, GL_RGBA, GL_UNSIGNED_BYTE, (void *)0);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        pending = true;
+    }
+
+    bool hasCapture() const { return pending; }
+
+    // Copia os pixels capturados (linhas de baixo para cima) para "out"
+    bool read(std::vector<uint8_t> &out)
+    {
+        if (!pending)
+            return false;
+        out.resize((size_t)width * height * 4);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, pbo);
+        void *ptr = glMapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY);
+        bool ok = ptr != nullptr;
+        if (ok)
+        {
+            memcpy(out.data(), ptr, out.size());
+            glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+        }
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        return ok;
+    }
+
+    void destroy()
+    {
+        if (pbo)
+            glDeleteBuffers(1, &pbo);
+        pbo = 0;
+        pending = false;
+    }
+
+    int captureWidth() const { return width; }
+    int captureHeight() const { return height; }
+
+private:
+    GLuint pbo;
+    int width, height;
+    bool pending;
+};
+
+// Compara a captura com o PNG de referência (ou o cria/atualiza, com update = true).
+// Na falha grava "<prefixo>_actual.png" e "<prefixo>_diff.png" na pasta atual.
+// Sem arquivo de referência o teste é pulado (retorna true, avisando): as referências
+// dependem do driver e são geradas na máquina de teste com --update-golden. Um arquivo
+// que existe mas não pode ser lido é falha.
+inline bool checkGolden(const std::vector<uint8_t> &captured, int width, int height, const char *goldenPath,
+                        const char *prefix, bool update, double pixelTolerance, double maxDifferentFraction)
+{
+    if (update)
+    {
+        bool ok = writePNG(goldenPath, captured.data(), width, height, true);
+        printf("Golden %s: %s\n", goldenPath, ok ? "atualizada" : "erro ao gravar");
+        return ok;
+    }
+
+    // A referência é gravada de cima para baixo; a captura vem de baixo para cima
+    std::vector<uint8_t> actual(captured.size());
+    size_t row = (size_t)width * 4;
+    for (int y = 0; y < height; y++)
+        memcpy(actual.data() + y * row, captured.data() + (height - 1 - y) * row, row);
+
+    FILE *exists = fopen(goldenPath, "rb");
+    if (!exists)
+    {
+        printf("Golden %s: PULADO -- sem referencia (crie com --update-golden ou o alvo golden_update)\n",
+               goldenPath);
+        return true;
+    }
+    fclose(exists);
+
+    int gw = 0, gh = 0, channels = 0;
+    unsigned char *golden = stbi_load(goldenPath, &gw, &gh, &channels, 4);
+    if (!golden)
+    {
+        printf("Golden %s: FALHOU -- referencia invalida (%s)\n", goldenPath, stbi_failure_reason());
+        return false;
+    }
+
+    std::string actualPath = std::string(prefix) + "_actual.png";
+    std::string diffPath = std::string(prefix) + "_diff.png";
+    bool passed = false;
+    if (gw != width || gh != height)
+    {
+        printf("Golden %s: tamanho %dx%d, captura %dx%d\n", goldenPath, gw, gh, width, height);
+        writePNG(actualPath.c_str(), actual.data(), width, height, false);
+    }
+    else
+    {
+        std::vector<uint8_t> diff;
+        ImageDiff d = compareImages(actual.data(), golden, width, height, pixelTolerance, maxDifferentFraction, &diff);
+        passed = d.passed;
+        printf("Golden %s: %s -- %d pixels diferentes (%.4f%%), diferenca max %.4f, media %.6f\n", goldenPath,
+               passed ? "OK" : "FALHOU", d.differentPixels, d.differentFraction * 100.0, d.maxDelta, d.meanDelta);
+        if (!passed)
+        {
+            writePNG(actualPath.c_str(), actual.data(), width, height, false);
+            writePNG(diffPath.c_str(), diff.data(), width, height, false);
+            printf("Imagens gravadas: %s, %s\n", actualPath.c_str(), diffPath.c_str());
+        }
+    }
+    stbi_image_free(golden);
+    return passed;
+}
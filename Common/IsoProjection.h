@@ -0,0 +1,83 @@
+/*
+ * IsoProjection - projeção isométrica (losangos 2:1) de um tilemap e percurso dos tiles visíveis
+ *
+ * Coordenadas do mapa (u, v): o tile (col, row) ocupa [col, col+1) x [row, row+1), com
+ * u crescendo para a direita-abaixo na tela e v para a esquerda-abaixo. Na tela (y para
+ * cima, como na projeção ortográfica dos exemplos), o canto superior do tile (0, 0) fica
+ * em (originX, originY):
+ *
+ *   x = originX + (u - v) * tileW/2
+ *   y = originY - (u + v) * tileH/2
+ *
+ * Num mapa isométrico, quem está mais abaixo na tela (u + v maior) fica na frente.
+ * depthKey(u, v) normaliza u + v para [0, 1] e pode ir direto para o depth buffer, no
+ * lugar de ordenar tiles e sprites na CPU.
+ *
+ * forEachVisible visita só os tiles cujo losango cruza um retângulo da tela: as linhas e,
+ * em cada linha, o intervalo de colunas saem das inversas da projeção, sem testar o mapa
+ * inteiro. O custo acompanha o número de tiles visíveis, não o tamanho do mapa.
+ */
+
+#pragma once
+
+#include <cmath>
+
+struct IsoProjection
+{
+    float tileW = 64.0f, tileH = 32.0f; // largura e altura do losango na tela
+    float originX = 0.0f, originY = 0.0f;
+
+    void toScreen(float u, float v, float &x, float &y) const
+    {
+        x = originX + (u - v) * tileW * 0.5f;
+        y = originY - (u + v) * tileH * 0.5f;
+    }
+
+    void toMap(float x, float y, float &u, float &v) const
+    {
+        float a = (x - originX) / (tileW * 0.5f); // u - v
+        float b = (originY - y) / (tileH * 0.5f); // u + v
+        u = (a + b) * 0.5f;
+        v = (b - a) * 0.5f;
+    }
+
+    // 0 no canto de trás do mapa (u = v = 0), 1 no canto da frente (u = cols, v = rows)
+    static float depthKey(float u, float v, int cols, int rows)
+    {
+        return (u + v) / (float)(cols + rows);
+    }
+
+    // fn(col, row) para cada tile do mapa cujo losango cruza o retângulo da tela.
+    // Retorna quantos tiles foram visitados.
+    template <typename F>
+    int forEachVisible(int cols, int rows, float minX, float minY, float maxX, float maxY, F fn) const
+    {
+        // O retângulo vira faixas em a = u - v e b = u + v
+        float aMin = (minX - originX) / (tileW * 0.5f), aMax = (maxX - originX) / (tileW * 0.5f);
+        float bMin = (originY - maxY) / (tileH * 0.5f), bMax = (originY - minY) / (tileH * 0.5f);
+
+        // O tile (c, r) cobre a em [c-r-1, c-r+1] e b em [c+r, c+r+2]
+        int r0 = (int)floorf((bMin - aMax) * 0.5f) - 1;
+        int r1 = (int)ceilf((bMax - aMin) * 0.5f) + 1;
+        if (r0 < 0)
+            r0 = 0;
+        if (r1 > rows - 1)
+            r1 = rows - 1;
+
+        int visited = 0;
+        for (int r = r0; r <= r1; r++)
+        {
+            int c0 = (int)floorf(fmaxf(aMin + r - 1.0f, bMin - r - 2.0f));
+            int c1 = (int)ceilf(fminf(aMax + r + 1.0f, bMax - r));
+            if (c0 < 0)
+                c0 = 0;
+            if (c1 > cols - 1)
+                c1 = cols - 1;
+            for (int c = c0; c <= c1; c++)
+                fn(c, r);
+            if (c1 >= c0)
+                visited += c1 - c0 + 1;
+        }
+        return visited;
+    }
+};
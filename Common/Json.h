@@ -0,0 +1,326 @@
+/*
+ * Json - leitor mínimo de JSON para arquivos de configuração dos exemplos
+ *
+ * Lê o texto inteiro para uma árvore de JsonValue (null, bool, número, string, array,
+ * objeto). Suficiente para descrições de assets escritas à mão: não trata \u fora do
+ * ASCII e guarda todos os números como double.
+ *
+ *     JsonValue doc;
+ *     std::string erro;
+ *     if (!loadJsonFile("../assets/sprites/x.json", doc, &erro)) ...
+ *     double w = doc["frameWidth"].asNumber(16);
+ *     for (size_t i = 0; i < doc["clips"].size(); i++) ... doc["clips"][i]["name"].asString()
+ *
+ * Acessar uma chave ou índice inexistente devolve um valor null, então a leitura de
+ * campos opcionais não precisa de testes encadeados.
+ */
+
+#pragma once
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+enum JsonType
+{
+    JSON_NULL = 0,
+    JSON_BOOL,
+    JSON_NUMBER,
+    JSON_STRING,
+    JSON_ARRAY,
+    JSON_OBJECT
+};
+
+class JsonValue
+{
+public:
+    JsonType type = JSON_NULL;
+    bool boolean = false;
+    double number = 0.0;
+    std::string string;
+    std::vector<JsonValue> array;
+    std::vector<std::pair<std::string, JsonValue>> object;
+
+    bool isNull() const { return type == JSON_NULL; }
+    bool isNumber() const { return type == JSON_NUMBER; }
+    bool isString() const { return type == JSON_STRING; }
+    bool isArray() const { return type == JSON_ARRAY; }
+    bool isObject() const { return type == JSON_OBJECT; }
+
+    double asNumber(double def = 0.0) const { return type == JSON_NUMBER ? number : def; }
+    int asInt(int def = 0) const { return type == JSON_NUMBER ? (int)number : def; }
+    bool asBool(bool def = false) const { return type == JSON_BOOL ? boolean : def; }
+    std::string asString(const char *def = "") const { return type == JSON_STRING ? string : std::string(def); }
+
+    // Número de elementos (array) ou de chaves (objeto)
+    size_t size() const
+    {
+        if (type == JSON_ARRAY)
+            return array.size();
+        if (type == JSON_OBJECT)
+            return object.size();
+        return 0;
+    }
+
+    bool has(const char *key) const { return !(*this)[key].isNull(); }
+
+    const JsonValue &operator[](const char *key) const
+    {
+        if (type == JSON_OBJECT)
+        {
+            for (const auto &kv : object)
+                if (kv.first == key)
+                    return kv.second;
+        }
+        return nullValue();
+    }
+
+    const JsonValue &operator[](size_t i) const
+    {
+        if (type == JSON_ARRAY && i < array.size())
+            return array[i];
+        return nullValue();
+    }
+
+private:
+    static const JsonValue &nullValue()
+    {
+        static const JsonValue null;
+        return null;
+    }
+};
+
+class JsonParser
+{
+public:
+    JsonParser(const char *text) : begin(text), p(text) {}
+
+    bool parse(JsonValue &out, std::string *error)
+    {
+        bool ok = parseValue(out, 0);
+        skipSpace();
+        if (ok && *p != '\0')
+            ok = fail("conteudo depois do valor principal");
+        if (!ok && error)
+            *error = message;
+        return ok;
+    }
+
+private:
+    static const int MAX_DEPTH = 64;
+
+    const char *begin;
+    const char *p;
+    std::string message;
+
+    bool fail(const char *what)
+    {
+        // Linha do erro, para a mensagem apontar o lugar no arquivo
+        int line = 1;
+        for (const char *c = begin; c < p; c++)
+            if (*c == '\n')
+                line++;
+        char buf[128];
+        snprintf(buf, sizeof(buf), "linha %d: %s", line, what);
+        message = buf;
+        return false;
+    }
+
+    void skipSpace()
+    {
+        while (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r')
+            p++;
+    }
+
+    bool literal(const char *word)
+    {
+        size_t n = strlen(word);
+        if (strncmp(p, word, n) != 0)
+            return fail("valor invalido");
+        p += n;
+        return true;
+    }
+
+    bool parseValue(JsonValue &v, int depth)
+    {
+        if (depth > MAX_DEPTH)
+            return fail("aninhamento profundo demais");
+        skipSpace();
+        switch (*p)
+        {
+        case '{':
+            return parseObject(v, depth);
+        case '[':
+            return parseArray(v, depth);
+        case '"':
+            v.type = JSON_STRING;
+            return parseString(v.string);
+        case 't':
+            v.type = JSON_BOOL;
+            v.boolean = true;
+            return literal("true");
+        case 'f':
+            v.type = JSON_BOOL;
+            v.boolean = false;
+            return literal("false");
+        case 'n':
+            v.type = JSON_NULL;
+            return literal("null");
+        default:
+            return parseNumber(v);
+        }
+    }
+
+    bool parseNumber(JsonValue &v)
+    {
+        char *end = nullptr;
+        double d = strtod(p, &end);
+        if (end == p)
+            return fail("valor invalido");
+        p = end;
+        v.type = JSON_NUMBER;
+        v.number = d;
+        return true;
+    }
+
+    bool parseString(std::string &s)
+    {
+        p++; // aspas de abertura
+        s.clear();
+        while (*p != '"')
+        {
+            if (*p == '\0')
+                return fail("string sem fechamento");
+            if (*p != '\\')
+            {
+                s += *p++;
+                continue;
+            }
+            p++;
+            switch (*p)
+            {
+            case '"': s += '"'; break;
+            case '\\': s += '\\'; break;
+            case '/': s += '/'; break;
+            case 'b': s += '\b'; break;
+            case 'f': s += '\f'; break;
+            case 'n': s += '\n'; break;
+            case 'r': s += '\r'; break;
+            case 't': s += '\t'; break;
+            case 'u':
+            {
+                // Só o intervalo ASCII; o resto vira '?'
+                char hex[5] = {0};
+                for (int i = 0; i < 4; i++)
+                {
+                    if (!p[1 + i])
+                        return fail("escape \\u incompleto");
+                    hex[i] = p[1 + i];
+                }
+                long code = strtol(hex, nullptr, 16);
+                s += code < 128 ? (char)code : '?';
+                p += 4;
+                break;
+            }
+            default:
+                return fail("escape invalido");
+            }
+            p++;
+        }
+        p++; // aspas de fechamento
+        return true;
+    }
+
+    bool parseArray(JsonValue &v, int depth)
+    {
+        v.type = JSON_ARRAY;
+        p++;
+        skipSpace();
+        if (*p == ']')
+        {
+            p++;
+            return true;
+        }
+        for (;;)
+        {
+            v.array.emplace_back();
+            if (!parseValue(v.array.back(), depth + 1))
+                return false;
+            skipSpace();
+            if (*p == ',')
+                p++;
+            else if (*p == ']')
+            {
+                p++;
+                return true;
+            }
+            else
+                return fail("esperado ',' ou ']'");
+        }
+    }
+
+    bool parseObject(JsonValue &v, int depth)
+    {
+        v.type = JSON_OBJECT;
+        p++;
+        skipSpace();
+        if (*p == '}')
+        {
+            p++;
+            return true;
+        }
+        for (;;)
+        {
+            skipSpace();
+            if (*p != '"')
+                return fail("esperada chave entre aspas");
+            v.object.emplace_back();
+            if (!parseString(v.object.back().first))
+                return false;
+            skipSpace();
+            if (*p != ':')
+                return fail("esperado ':'");
+            p++;
+            if (!parseValue(v.object.back().second, depth + 1))
+                return false;
+            skipSpace();
+            if (*p == ',')
+                p++;
+            else if (*p == '}')
+            {
+                p++;
+                return true;
+            }
+            else
+                return fail("esperado ',' ou '}'");
+        }
+    }
+};
+
+inline bool parseJson(const std::string &text, JsonValue &out, std::string *error = nullptr)
+{
+    out = JsonValue();
+    JsonParser parser(text.c_str());
+    return parser.parse(out, error);
+}
+
+inline bool loadJsonFile(const char *path, JsonValue &out, std::string *error = nullptr)
+{
+    FILE *f = fopen(path, "rb");
+    if (!f)
+    {
+        if (error)
+            *error = std::string("nao foi possivel abrir ") + path;
+        return false;
+    }
+    std::string text;
+    char buf[4096];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), f)) > 0)
+        text.append(buf, n);
+    fclose(f);
+    return parseJson(text, out, error);
+}
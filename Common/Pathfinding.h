@@ -0,0 +1,864 @@
+/*
+ * Pathfinding - busca de caminhos sobre a grade do tilemap: A*, Jump Point Search e HPA*
+ *
+ * PathGrid guarda só quais células são andáveis (pode ser montada a partir de uma
+ * TileCollisionLayer). O movimento é em 8 direções, com custo 1 nas retas e sqrt(2) nas
+ * diagonais, e uma diagonal só é permitida se as duas células retas ao lado estiverem
+ * livres (ninguém "corta a quina" de uma parede). Células são (col, row), linha 0 no topo.
+ *
+ * GridAStar é o A* de referência, opcionalmente limitado a um retângulo da grade.
+ *
+ * JumpPointSearch dá o mesmo custo ótimo do A*, mas só coloca na lista aberta os "pontos
+ * de salto": ao seguir numa direção, pula direto as células cujos vizinhos não trazem
+ * nenhuma alternativa nova, e só para onde uma parede força um desvio. Boa para consultas
+ * avulsas sem pré-processamento.
+ *
+ * HierarchicalPathfinder (HPA*) divide o mapa em clusters de clusterSize x clusterSize
+ * células. Em cada borda entre dois clusters, os trechos livres dos dois lados viram
+ * "entradas" (uma no meio dos trechos curtos, duas nas pontas dos longos); as células das
+ * entradas são os nós de um grafo abstrato, com as distâncias entre os nós de um mesmo
+ * cluster calculadas de antemão. Um caminho longo vira uma busca nesse grafo pequeno,
+ * refinada depois em trechos curtos dentro de cada cluster. O custo fica alguns por cento
+ * acima do ótimo, em troca de buscas muito mais rápidas em mapas grandes.
+ *
+ * Quando um tile muda, setBlocked() refaz só as bordas do cluster daquela célula e os
+ * clusters vizinhos a elas, não o mapa inteiro.
+ *
+ * As classes de busca guardam memória de trabalho do tamanho da grade (uma instância por
+ * thread) e não alocam nada por consulta depois da primeira.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "TileCollision.h"
+
+struct GridPoint
+{
+    int col, row;
+
+    bool operator==(const GridPoint &o) const { return col == o.col && row == o.row; }
+    bool operator!=(const GridPoint &o) const { return !(*this == o); }
+};
+
+const float PATH_SQRT2 = 1.41421356f;
+const float PATH_INF = 1e30f;
+
+// Distância octil: o custo de um caminho sem obstáculos (heurística exata numa grade vazia)
+inline float octileDistance(int dc, int dr)
+{
+    dc = dc < 0 ? -dc : dc;
+    dr = dr < 0 ? -dr : dr;
+    int lo = dc < dr ? dc : dr, hi = dc < dr ? dr : dc;
+    return (float)(hi - lo) + PATH_SQRT2 * (float)lo;
+}
+
+class PathGrid
+{
+public:
+    int cols = 0, rows = 0;
+
+    void resize(int nCols, int nRows)
+    {
+        cols = nCols;
+        rows = nRows;
+        blocked.assign((size_t)cols * rows, 0);
+    }
+
+    // Bloqueia as células sólidas da camada de colisão
+    void build(const TileCollisionLayer &layer)
+    {
+        resize(layer.cols, layer.rows);
+        for (int r = 0; r < rows; r++)
+            for (int c = 0; c < cols; c++)
+                blocked[(size_t)r * cols + c] = layer.solidAt(c, r) ? 1 : 0;
+    }
+
+    bool inside(int col, int row) const { return col >= 0 && row >= 0 && col < cols && row < rows; }
+    bool walkable(int col, int row) const { return inside(col, row) && !blocked[(size_t)row * cols + col]; }
+    void setBlocked(int col, int row, bool b)
+    {
+        if (inside(col, row))
+            blocked[(size_t)row * cols + col] = b ? 1 : 0;
+    }
+
+    int index(int col, int row) const { return row * cols + col; }
+    GridPoint point(int idx) const { return {idx % cols, idx / cols}; }
+    int size() const { return cols * rows; }
+
+    // Passo de (col, row) para (col + dc, row + dr), com |dc|, |dr| <= 1, sem cortar quinas
+    bool canStep(int col, int row, int dc, int dr) const
+    {
+        if (!walkable(col + dc, row + dr))
+            return false;
+        return dc == 0 || dr == 0 || (walkable(col + dc, row) && walkable(col, row + dr));
+    }
+
+private:
+    std::vector<uint8_t> blocked;
+};
+
+// Estado de uma busca por célula (g, pai, aberta/fechada). Uma "rodada" por consulta
+// invalida tudo de uma vez, sem limpar os vetores.
+struct PathSearchNodes
+{
+    std::vector<float> g;
+    std::vector<int> parent;
+    std::vector<uint32_t> seen, closedIn;
+    uint32_t round = 0;
+
+    void resize(int n)
+    {
+        if ((int)g.size() == n)
+            return;
+        g.assign(n, PATH_INF);
+        parent.assign(n, -1);
+        seen.assign(n, 0);
+        closedIn.assign(n, 0);
+        round = 0;
+    }
+
+    void begin()
+    {
+        if (++round == 0)
+        {
+            std::fill(seen.begin(), seen.end(), 0);
+            std::fill(closedIn.begin(), closedIn.end(), 0);
+            round = 1;
+        }
+    }
+
+    float cost(int i) const { return seen[i] == round ? g[i] : PATH_INF; }
+    bool closed(int i) const { return closedIn[i] == round; }
+    void close(int i) { closedIn[i] = round; }
+
+    // Retorna true se o novo custo melhorou o nó
+    bool relax(int i, float newG, int from)
+    {
+        if (seen[i] == round && g[i] <= newG)
+            return false;
+        seen[i] = round;
+        g[i] = newG;
+        parent[i] = from;
+        return true;
+    }
+};
+
+// Lista aberta: heap binário de (f, nó). Entradas velhas (nó já fechado) são descartadas no pop.
+class PathOpenList
+{
+public:
+    void clear() { heap.clear(); }
+    bool empty() const { return heap.empty(); }
+
+    void push(float f, int node)
+    {
+        heap.push_back({f, node});
+        std::push_heap(heap.begin(), heap.end(), greater);
+    }
+
+    float topF() const { return heap.front().f; }
+
+    int pop()
+    {
+        std::pop_heap(heap.begin(), heap.end(), greater);
+        int node = heap.back().node;
+        heap.pop_back();
+        return node;
+    }
+
+private:
+    struct Entry
+    {
+        float f;
+        int node;
+    };
+    static bool greater(const Entry &a, const Entry &b) { return a.f > b.f; }
+    std::vector<Entry> heap;
+};
+
+// Retângulo de células [col0, col1] x [row0, row1]
+struct GridRect
+{
+    int col0, row0, col1, row1;
+
+    bool contains(int col, int row) const { return col >= col0 && col <= col1 && row >= row0 && row <= row1; }
+};
+
+class GridAStar
+{
+public:
+    explicit GridAStar(const PathGrid &grid) : grid(grid), expandedCount(0) {}
+
+    // Caminho de start até goal (inclusive), só por células dentro de bounds.
+    // Com goal = {-1, -1}, vira um Dijkstra que cobre bounds inteiro (ver costTo).
+    bool findPath(GridPoint start, GridPoint goal, std::vector<GridPoint> &path, float *cost = nullptr)
+    {
+        return findPath(start, goal, {0, 0, grid.cols - 1, grid.rows - 1}, path, cost);
+    }
+
+    bool findPath(GridPoint start, GridPoint goal, const GridRect &bounds, std::vector<GridPoint> &path,
+                  float *cost = nullptr)
+    {
+        path.clear();
+        if (!search(start, goal, bounds))
+            return false;
+        int g = grid.index(goal.col, goal.row);
+        for (int i = g; i != -1; i = nodes.parent[i])
+            path.push_back(grid.point(i));
+        std::reverse(path.begin(), path.end());
+        if (cost)
+            *cost = nodes.cost(g);
+        return true;
+    }
+
+    // Busca sem montar o caminho; retorna se goal foi alcançado
+    bool search(GridPoint start, GridPoint goal, const GridRect &bounds)
+    {
+        nodes.resize(grid.size());
+        nodes.begin();
+        open.clear();
+        expandedCount = 0;
+        if (!grid.walkable(start.col, start.row) || !bounds.contains(start.col, start.row))
+            return false;
+        bool toGoal = goal.col >= 0;
+        int goalIdx = toGoal ? grid.index(goal.col, goal.row) : -1;
+
+        int s = grid.index(start.col, start.row);
+        nodes.relax(s, 0.0f, -1);
+        open.push(toGoal ? octileDistance(goal.col - start.col, goal.row - start.row) : 0.0f, s);
+        while (!open.empty())
+        {
+            int cur = open.pop();
+            if (nodes.closed(cur))
+                continue;
+            nodes.close(cur);
+            expandedCount++;
+            if (cur == goalIdx)
+                return true;
+            int col = cur % grid.cols, row = cur / grid.cols;
+            float g = nodes.g[cur];
+            for (int d = 0; d < 8; d++)
+            {
+                int dc = DIR_C[d], dr = DIR_R[d];
+                int nc = col + dc, nr = row + dr;
+                if (!bounds.contains(nc, nr) || !grid.canStep(col, row, dc, dr))
+                    continue;
+                int n = grid.index(nc, nr);
+                float ng = g + ((dc && dr) ? PATH_SQRT2 : 1.0f);
+                if (nodes.closed(n) || !nodes.relax(n, ng, cur))
+                    continue;
+                open.push(ng + (toGoal ? octileDistance(goal.col - nc, goal.row - nr) : 0.0f), n);
+            }
+        }
+        return false;
+    }
+
+    // Custo até a célula na última busca (PATH_INF se não alcançada)
+    float costTo(GridPoint p) const { return nodes.cost(grid.index(p.col, p.row)); }
+    int expanded() const { return expandedCount; }
+
+private:
+    static constexpr int DIR_C[8] = {1, -1, 0, 0, 1, 1, -1, -1};
+    static constexpr int DIR_R[8] = {0, 0, 1, -1, 1, -1, 1, -1};
+
+    const PathGrid &grid;
+    PathSearchNodes nodes;
+    PathOpenList open;
+    int expandedCount;
+};
+
+class JumpPointSearch
+{
+public:
+    explicit JumpPointSearch(const PathGrid &grid) : grid(grid), expandedCount(0) {}
+
+    // Caminho completo (célula a célula) de start até goal, inclusive
+    bool findPath(GridPoint start, GridPoint goal, std::vector<GridPoint> &path, float *cost = nullptr)
+    {
+        path.clear();
+        nodes.resize(grid.size());
+        nodes.begin();
+        open.clear();
+        expandedCount = 0;
+        if (!grid.walkable(start.col, start.row) || !grid.walkable(goal.col, goal.row))
+            return false;
+        gc = goal.col;
+        gr = goal.row;
+        int goalIdx = grid.index(gc, gr);
+
+        int s = grid.index(start.col, start.row);
+        nodes.relax(s, 0.0f, -1);
+        open.push(octileDistance(gc - start.col, gr - start.row), s);
+        while (!open.empty())
+        {
+            int cur = open.pop();
+            if (nodes.closed(cur))
+                continue;
+            nodes.close(cur);
+            expandedCount++;
+            if (cur == goalIdx)
+            {
+                buildPath(cur, path);
+                if (cost)
+                    *cost = nodes.g[cur];
+                return true;
+            }
+
+            int col = cur % grid.cols, row = cur / grid.cols;
+            int dirs[8][2];
+            int nDirs = prunedDirections(cur, col, row, dirs);
+            for (int d = 0; d < nDirs; d++)
+            {
+                int jp = jump(col + dirs[d][0], row + dirs[d][1], dirs[d][0], dirs[d][1]);
+                if (jp < 0 || nodes.closed(jp))
+                    continue;
+                int jc = jp % grid.cols, jr = jp / grid.cols;
+                float ng = nodes.g[cur] + octileDistance(jc - col, jr - row);
+                if (nodes.relax(jp, ng, cur))
+                    open.push(ng + octileDistance(gc - jc, gr - jr), jp);
+            }
+        }
+        return false;
+    }
+
+    int expanded() const { return expandedCount; }
+
+private:
+    const PathGrid &grid;
+    PathSearchNodes nodes;
+    PathOpenList open;
+    int expandedCount;
+    int gc = 0, gr = 0;
+
+    bool walk(int col, int row) const { return grid.walkable(col, row); }
+
+    // Direções que valem a pena a partir de um nó, dada a direção de chegada
+    int prunedDirections(int cur, int col, int row, int dirs[8][2]) const
+    {
+        int n = 0;
+        int p = nodes.parent[cur];
+        if (p < 0)
+        {
+            for (int dr = -1; dr <= 1; dr++)
+                for (int dc = -1; dc <= 1; dc++)
+                    if ((dc || dr) && grid.canStep(col, row, dc, dr))
+                    {
+                        dirs[n][0] = dc;
+                        dirs[n][1] = dr;
+                        n++;
+                    }
+            return n;
+        }
+        int dc = sign(col - p % grid.cols), dr = sign(row - p / grid.cols);
+        auto add = [&](int a, int b) {
+            dirs[n][0] = a;
+            dirs[n][1] = b;
+            n++;
+        };
+        if (dc && dr)
+        {
+            bool h = walk(col + dc, row), v = walk(col, row + dr);
+            if (v)
+                add(0, dr);
+            if (h)
+                add(dc, 0);
+            if (h && v)
+                add(dc, dr);
+        }
+        else if (dc)
+        {
+            bool next = walk(col + dc, row), up = walk(col, row - 1), down = walk(col, row + 1);
+            if (next)
+            {
+                add(dc, 0);
+                if (up)
+                    add(dc, -1);
+                if (down)
+                    add(dc, 1);
+            }
+            if (up)
+                add(0, -1);
+            if (down)
+                add(0, 1);
+        }
+        else
+        {
+            bool next = walk(col, row + dr), lft = walk(col - 1, row), rgt = walk(col + 1, row);
+            if (next)
+            {
+                add(0, dr);
+                if (lft)
+                    add(-1, dr);
+                if (rgt)
+                    add(1, dr);
+            }
+            if (lft)
+                add(-1, 0);
+            if (rgt)
+                add(1, 0);
+        }
+        return n;
+    }
+
+    // Anda na direção (dc, dr) a partir de (col, row) até achar um ponto de salto
+    // (o destino, ou uma célula com vizinho forçado). Retorna -1 se bater numa parede.
+    int jump(int col, int row, int dc, int dr) const
+    {
+        while (true)
+        {
+            if (!walk(col, row))
+                return -1;
+            if (col == gc && row == gr)
+                return grid.index(col, row);
+            if (dc && dr)
+            {
+                // Na diagonal, para se alguma das retas que saem daqui achar algo
+                if (jump(col + dc, row, dc, 0) >= 0 || jump(col, row + dr, 0, dr) >= 0)
+                    return grid.index(col, row);
+                if (!walk(col + dc, row) || !walk(col, row + dr))
+                    return -1;
+            }
+            else if (dc)
+            {
+                // Parede logo atrás de um lado livre: por ali abre um caminho novo
+                if ((walk(col, row - 1) && !walk(col - dc, row - 1)) || (walk(col, row + 1) && !walk(col - dc, row + 1)))
+                    return grid.index(col, row);
+            }
+            else
+            {
+                if ((walk(col - 1, row) && !walk(col - 1, row - dr)) || (walk(col + 1, row) && !walk(col + 1, row - dr)))
+                    return grid.index(col, row);
+            }
+            col += dc;
+            row += dr;
+        }
+    }
+
+    // Os pontos de salto estão ligados por retas ou diagonais puras: preenche as células entre eles
+    void buildPath(int last, std::vector<GridPoint> &path) const
+    {
+        for (int i = last; i != -1; i = nodes.parent[i])
+        {
+            GridPoint a = grid.point(i);
+            path.push_back(a);
+            int p = nodes.parent[i];
+            if (p < 0)
+                break;
+            GridPoint b = grid.point(p);
+            int dc = sign(b.col - a.col), dr = sign(b.row - a.row);
+            for (GridPoint c = {a.col + dc, a.row + dr}; c != b; c.col += dc, c.row += dr)
+                path.push_back(c);
+        }
+        std::reverse(path.begin(), path.end());
+    }
+
+    static int sign(int v) { return (v > 0) - (v < 0); }
+};
+
+class HierarchicalPathfinder
+{
+public:
+    HierarchicalPathfinder(PathGrid &grid, int clusterSize = 16)
+        : grid(grid), clusterSize(clusterSize), maxSlots(4 * clusterSize), local(grid), clustersX(0), clustersY(0),
+          expandedCount(0) {}
+
+    // Monta entradas e distâncias de todos os clusters (chamar depois de preencher a grade)
+    void build()
+    {
+        clustersX = (grid.cols + clusterSize - 1) / clusterSize;
+        clustersY = (grid.rows + clusterSize - 1) / clusterSize;
+        int n = clustersX * clustersY;
+        clusters.assign(n, Cluster());
+        east.assign(n, std::vector<Transition>());
+        south.assign(n, std::vector<Transition>());
+        for (int k = 0; k < n; k++)
+        {
+            findEastEntrances(k);
+            findSouthEntrances(k);
+        }
+        for (int k = 0; k < n; k++)
+            rebuildCluster(k);
+        for (int k = 0; k < n; k++)
+            linkCluster(k);
+    }
+
+    // Troca uma célula da grade e conserta o grafo abstrato em volta dela
+    void setBlocked(int col, int row, bool blocked)
+    {
+        if (!grid.inside(col, row) || grid.walkable(col, row) == !blocked)
+            return;
+        grid.setBlocked(col, row, blocked);
+
+        int cx = col / clusterSize, cy = row / clusterSize;
+        int k = cx + cy * clustersX;
+        // Uma célula de borda muda as entradas daquela borda e os nós do cluster vizinho;
+        // uma célula interna só muda as distâncias dentro do próprio cluster
+        int rebuilt[5], nRebuilt = 0;
+        if (col % clusterSize == 0 && cx > 0)
+        {
+            findEastEntrances(k - 1);
+            rebuilt[nRebuilt++] = k - 1;
+        }
+        if ((col + 1) % clusterSize == 0 && cx + 1 < clustersX)
+        {
+            findEastEntrances(k);
+            rebuilt[nRebuilt++] = k + 1;
+        }
+        if (row % clusterSize == 0 && cy > 0)
+        {
+            findSouthEntrances(k - clustersX);
+            rebuilt[nRebuilt++] = k - clustersX;
+        }
+        if ((row + 1) % clusterSize == 0 && cy + 1 < clustersY)
+        {
+            findSouthEntrances(k);
+            rebuilt[nRebuilt++] = k + clustersX;
+        }
+        rebuilt[nRebuilt++] = k;
+        for (int i = 0; i < nRebuilt; i++)
+            rebuildCluster(rebuilt[i]);
+        // Os nós dos clusters refeitos mudaram de posição: refaz as travessias deles e dos vizinhos
+        for (int i = 0; i < nRebuilt; i++)
+        {
+            int r = rebuilt[i], rx = r % clustersX, ry = r / clustersX;
+            linkCluster(r);
+            if (rx > 0)
+                linkCluster(r - 1);
+            if (rx + 1 < clustersX)
+                linkCluster(r + 1);
+            if (ry > 0)
+                linkCluster(r - clustersX);
+            if (ry + 1 < clustersY)
+                linkCluster(r + clustersX);
+        }
+    }
+
+    bool findPath(GridPoint start, GridPoint goal, std::vector<GridPoint> &path, float *cost = nullptr)
+    {
+        path.clear();
+        expandedCount = 0;
+        if (!grid.walkable(start.col, start.row) || !grid.walkable(goal.col, goal.row))
+            return false;
+        int ks = clusterOf(start), kg = clusterOf(goal);
+        const Cluster &cs = clusters[ks], &cg = clusters[kg];
+
+        // Liga início e destino aos nós dos seus clusters (Dijkstra dentro do cluster)
+        clusterDistances(ks, start);
+        startDist.resize(cs.nodes.size());
+        for (size_t i = 0; i < cs.nodes.size(); i++)
+            startDist[i] = localCost(cs.nodes[i]);
+        float best = ks == kg ? localCost(goal) : PATH_INF; // sem sair do cluster
+        clusterDistances(kg, goal);
+        goalDist.resize(cg.nodes.size());
+        for (size_t i = 0; i < cg.nodes.size(); i++)
+            goalDist[i] = localCost(cg.nodes[i]);
+
+        // A* no grafo abstrato. Nó = cluster * maxSlots + posição no cluster, então a memória
+        // da busca é pequena e os nós de um cluster ficam juntos; pai -1 = ligado ao início.
+        nodes.resize(clustersX * clustersY * maxSlots);
+        nodes.begin();
+        open.clear();
+        for (size_t i = 0; i < cs.nodes.size(); i++)
+        {
+            int id = ks * maxSlots + (int)i;
+            if (startDist[i] < PATH_INF && nodes.relax(id, startDist[i], -1))
+                open.push(startDist[i] + heuristic(cs.nodes[i], goal), id);
+        }
+        int bestLast = -1;
+        while (!open.empty() && open.topF() < best)
+        {
+            int u = open.pop();
+            if (nodes.closed(u))
+                continue;
+            nodes.close(u);
+            expandedCount++;
+            float gu = nodes.g[u];
+            int ku = u / maxSlots, slot = u % maxSlots;
+            const Cluster &c = clusters[ku];
+
+            if (ku == kg && gu + goalDist[slot] < best)
+            {
+                best = gu + goalDist[slot];
+                bestLast = u;
+            }
+            int n = (int)c.nodes.size();
+            const float *row = &c.dist[(size_t)slot * n];
+            for (int j = 0; j < n; j++)
+            {
+                int v = ku * maxSlots + j;
+                if (row[j] < PATH_INF && !nodes.closed(v) && nodes.relax(v, gu + row[j], u))
+                    open.push(gu + row[j] + heuristic(c.nodes[j], goal), v);
+            }
+            for (int e = 0; e < 2; e++)
+            {
+                int v = c.cross[slot * 2 + e];
+                if (v < 0)
+                    continue;
+                // Travessia de borda: um passo reto para o vizinho
+                if (!nodes.closed(v) && nodes.relax(v, gu + 1.0f, u))
+                    open.push(gu + 1.0f + heuristic(cellOf(v), goal), v);
+            }
+        }
+        if (best >= PATH_INF)
+            return false;
+
+        // Sequência abstrata: início, células de entrada, destino
+        abstractPath.clear();
+        abstractPath.push_back(goal);
+        for (int i = bestLast; i != -1; i = nodes.parent[i])
+            abstractPath.push_back(cellOf(i));
+        abstractPath.push_back(start);
+        std::reverse(abstractPath.begin(), abstractPath.end());
+
+        // Refinamento: trechos dentro de um cluster viram caminhos locais; travessias de
+        // borda já são um passo só
+        path.push_back(start);
+        for (size_t i = 1; i < abstractPath.size(); i++)
+        {
+            GridPoint a = abstractPath[i - 1], b = abstractPath[i];
+            if (a == b)
+                continue;
+            int ka = clusterOf(a);
+            if (ka != clusterOf(b))
+            {
+                path.push_back(b);
+                continue;
+            }
+            local.findPath(a, b, rectOf(ka), segment);
+            path.insert(path.end(), segment.begin() + 1, segment.end());
+        }
+        if (cost)
+            *cost = best;
+        return true;
+    }
+
+    int nodeCount() const
+    {
+        int n = 0;
+        for (const Cluster &c : clusters)
+            n += (int)c.nodes.size();
+        return n;
+    }
+
+    // Nós abstratos expandidos na última busca
+    int expanded() const { return expandedCount; }
+
+private:
+    // Trechos livres de borda mais curtos que isso ganham uma entrada só, no meio
+    static const int ENTRANCE_SPLIT = 6;
+
+    struct Transition
+    {
+        int a, b; // célula do lado deste cluster e a do vizinho (leste ou sul), como índices da grade
+    };
+
+    struct Cluster
+    {
+        std::vector<GridPoint> nodes; // células de entrada do cluster
+        std::vector<float> dist;      // nodes.size()^2 distâncias por dentro do cluster
+        std::vector<int> cross;       // 2 por nó: nó do outro lado de uma borda, ou -1
+    };
+
+    PathGrid &grid;
+    int clusterSize, maxSlots;
+    GridAStar local;
+    int clustersX, clustersY;
+    std::vector<Cluster> clusters;
+    std::vector<std::vector<Transition>> east, south; // bordas leste e sul de cada cluster
+
+    PathSearchNodes nodes;
+    PathOpenList open;
+    std::vector<float> startDist, goalDist;
+    std::vector<GridPoint> abstractPath, segment;
+    int expandedCount;
+
+    // Dijkstra dentro de um cluster, em vetores do tamanho do cluster (cabem no cache)
+    std::vector<float> localG;
+    std::vector<uint8_t> localDone;
+    PathOpenList localOpen;
+    GridRect localRect = {0, 0, -1, -1};
+
+    int clusterOf(GridPoint p) const { return p.col / clusterSize + (p.row / clusterSize) * clustersX; }
+    GridPoint cellOf(int id) const { return clusters[id / maxSlots].nodes[id % maxSlots]; }
+
+    GridRect rectOf(int k) const
+    {
+        int cx = k % clustersX, cy = k / clustersX;
+        return {cx * clusterSize, cy * clusterSize, std::min((cx + 1) * clusterSize, grid.cols) - 1,
+                std::min((cy + 1) * clusterSize, grid.rows) - 1};
+    }
+
+    static float heuristic(GridPoint p, GridPoint goal) { return octileDistance(goal.col - p.col, goal.row - p.row); }
+
+    static int slotOf(const Cluster &c, GridPoint p)
+    {
+        for (size_t i = 0; i < c.nodes.size(); i++)
+            if (c.nodes[i] == p)
+                return (int)i;
+        return -1;
+    }
+
+    void clusterDistances(int k, GridPoint source)
+    {
+        localRect = rectOf(k);
+        int w = localRect.col1 - localRect.col0 + 1, h = localRect.row1 - localRect.row0 + 1;
+        localG.assign((size_t)w * h, PATH_INF);
+        localDone.assign((size_t)w * h, 0);
+        localOpen.clear();
+        int s = (source.row - localRect.row0) * w + (source.col - localRect.col0);
+        localG[s] = 0.0f;
+        localOpen.push(0.0f, s);
+        while (!localOpen.empty())
+        {
+            int cur = localOpen.pop();
+            if (localDone[cur])
+                continue;
+            localDone[cur] = 1;
+            int lc = cur % w, lr = cur / w;
+            int col = localRect.col0 + lc, row = localRect.row0 + lr;
+            for (int dr = -1; dr <= 1; dr++)
+                for (int dc = -1; dc <= 1; dc++)
+                {
+                    if ((!dc && !dr) || lc + dc < 0 || lc + dc >= w || lr + dr < 0 || lr + dr >= h ||
+                        !grid.canStep(col, row, dc, dr))
+                        continue;
+                    int n = cur + dr * w + dc;
+                    float ng = localG[cur] + ((dc && dr) ? PATH_SQRT2 : 1.0f);
+                    if (ng < localG[n])
+                    {
+                        localG[n] = ng;
+                        localOpen.push(ng, n);
+                    }
+                }
+        }
+    }
+
+    // Custo até uma célula do cluster na última clusterDistances
+    float localCost(GridPoint p) const
+    {
+        int w = localRect.col1 - localRect.col0 + 1;
+        return localG[(p.row - localRect.row0) * w + (p.col - localRect.col0)];
+    }
+
+    // Divide a borda em trechos onde os dois lados estão livres. line(i, a, b) dá as
+    // células dos dois lados na posição i da borda.
+    template <typename F>
+    void findEntrances(std::vector<Transition> &out, int length, F line)
+    {
+        out.clear();
+        for (int i = 0; i < length;)
+        {
+            int a, b;
+            if (!line(i, a, b))
+            {
+                i++;
+                continue;
+            }
+            int begin = i;
+            while (i < length && line(i, a, b))
+                i++;
+            int len = i - begin;
+            if (len < ENTRANCE_SPLIT)
+            {
+                line(begin + len / 2, a, b);
+                out.push_back({a, b});
+            }
+            else
+            {
+                line(begin, a, b);
+                out.push_back({a, b});
+                line(i - 1, a, b);
+                out.push_back({a, b});
+            }
+        }
+    }
+
+    void findEastEntrances(int k)
+    {
+        GridRect r = rectOf(k);
+        east[k].clear();
+        if (r.col1 + 1 >= grid.cols)
+            return;
+        findEntrances(east[k], r.row1 - r.row0 + 1, [&](int i, int &a, int &b) {
+            int row = r.row0 + i;
+            a = grid.index(r.col1, row);
+            b = grid.index(r.col1 + 1, row);
+            return grid.walkable(r.col1, row) && grid.walkable(r.col1 + 1, row);
+        });
+    }
+
+    void findSouthEntrances(int k)
+    {
+        GridRect r = rectOf(k);
+        south[k].clear();
+        if (r.row1 + 1 >= grid.rows)
+            return;
+        findEntrances(south[k], r.col1 - r.col0 + 1, [&](int i, int &a, int &b) {
+            int col = r.col0 + i;
+            a = grid.index(col, r.row1);
+            b = grid.index(col, r.row1 + 1);
+            return grid.walkable(col, r.row1) && grid.walkable(col, r.row1 + 1);
+        });
+    }
+
+    // Nós do cluster (células das entradas das quatro bordas) e distâncias entre eles
+    void rebuildCluster(int k)
+    {
+        Cluster &c = clusters[k];
+        std::vector<int> cells;
+        int cx = k % clustersX, cy = k / clustersX;
+        for (const Transition &t : east[k])
+            cells.push_back(t.a);
+        for (const Transition &t : south[k])
+            cells.push_back(t.a);
+        if (cx > 0)
+            for (const Transition &t : east[k - 1])
+                cells.push_back(t.b);
+        if (cy > 0)
+            for (const Transition &t : south[k - clustersX])
+                cells.push_back(t.b);
+        std::sort(cells.begin(), cells.end());
+        cells.erase(std::unique(cells.begin(), cells.end()), cells.end());
+        c.nodes.clear();
+        for (int cell : cells)
+            c.nodes.push_back(grid.point(cell));
+
+        int n = (int)c.nodes.size();
+        c.dist.assign((size_t)n * n, PATH_INF);
+        for (int i = 0; i < n; i++)
+        {
+            clusterDistances(k, c.nodes[i]);
+            for (int j = 0; j < n; j++)
+                c.dist[(size_t)i * n + j] = localCost(c.nodes[j]);
+        }
+    }
+
+    // Liga cada nó do cluster ao nó do outro lado das suas travessias de borda
+    // (uma célula de quina pode atravessar duas bordas)
+    void linkCluster(int k)
+    {
+        Cluster &c = clusters[k];
+        c.cross.assign(c.nodes.size() * 2, -1);
+        int cx = k % clustersX, cy = k / clustersX;
+        auto link = [&](int here, int there, int kThere) {
+            int slot = slotOf(c, grid.point(here));
+            int other = slotOf(clusters[kThere], grid.point(there));
+            int &e = c.cross[slot * 2] < 0 ? c.cross[slot * 2] : c.cross[slot * 2 + 1];
+            e = kThere * maxSlots + other;
+        };
+        for (const Transition &t : east[k])
+            link(t.a, t.b, k + 1);
+        for (const Transition &t : south[k])
+            link(t.a, t.b, k + clustersX);
+        if (cx > 0)
+            for (const Transition &t : east[k - 1])
+                link(t.b, t.a, k - 1);
+        if (cy > 0)
+            for (const Transition &t : south[k - clustersX])
+                link(t.b, t.a, k - clustersX);
+    }
+};
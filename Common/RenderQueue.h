@@ -0,0 +1,265 @@
+/*
+ * RenderQueue - fila de desenho ordenada por chave de 64 bits
+ *
+ * Cada chamada de desenho é submetida com uma chave (sort key) que codifica,
+ * do bit mais significativo para o menos significativo:
+ *
+ *   Opacos:       | camada (4) | 0 | shader (12) | textura (12) | profundidade (24) | livre (11) |
+ *   Transparentes:| camada (4) | 1 | profundidade invertida (24) | shader (12) | textura (12) | livre (11) |
+ *
+ * Assim, ao ordenar as chaves em ordem crescente:
+ *   - as camadas são desenhadas em ordem (mundo, depois sobreposição, depois interface);
+ *   - dentro de uma camada, todos os opacos vêm antes dos transparentes;
+ *   - os opacos ficam agrupados por shader e textura (menos trocas de estado) e,
+ *     dentro do mesmo estado, da frente para trás (aproveita o early-z);
+ *   - os transparentes são desenhados de trás para frente, como a mistura exige.
+ *
+ * A ordenação é um radix sort LSD de 8 bits por passada; passadas em que todas as
+ * chaves têm o mesmo byte são puladas.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include <glad/glad.h>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+// Camadas de desenho (ocupam os 4 bits mais significativos da chave)
+enum RenderLayer
+{
+    LAYER_WORLD = 0,
+    LAYER_OVERLAY = 1,
+    LAYER_UI = 2,
+    MAX_RENDER_LAYERS = 16
+};
+
+// Uma chamada de desenho completa: estado necessário + parâmetros do draw
+struct RenderCommand
+{
+    uint64_t key;
+    GLuint shaderID;
+    GLuint VAO;
+    GLuint texID;
+    GLenum mode;
+    GLint first;
+    GLsizei count;
+    glm::mat4 model;
+    glm::vec2 offsetTex;
+};
+
+// Contadores de trocas de estado do último execute()
+struct RenderQueueStats
+{
+    int drawCalls;
+    int shaderChanges;
+    int textureChanges;
+    int vaoChanges;
+    int depthStateChanges;
+};
+
+class RenderQueue
+{
+public:
+    RenderQueue()
+    {
+        for (int i = 0; i < MAX_RENDER_LAYERS; i++)
+            layerDepthTest[i] = true;
+        stats = {};
+    }
+
+    // Monta a chave de ordenação. depth01 é a distância normalizada à câmera [0,1].
+    // shader e textura entram pelos 12 bits menos significativos do identificador OpenGL:
+    // colisões só pioram o agrupamento, nunca a corretude (o execute compara o estado real).
+    static uint64_t makeKey(int layer, bool translucent, GLuint shaderID, GLuint texID, float depth01)
+    {
+        if (depth01 < 0.0f)
+            depth01 = 0.0f;
+        if (depth01 > 1.0f)
+            depth01 = 1.0f;
+        uint64_t depth = (uint64_t)(depth01 * 16777215.0f); // 24 bits
+        uint64_t shader = shaderID & 0xFFF;
+        uint64_t tex = texID & 0xFFF;
+
+        uint64_t key = ((uint64_t)(layer & 0xF)) << 60;
+        if (!translucent)
+        {
+            key |= shader << 47;
+            key |= tex << 35;
+            key |= depth << 11;
+        }
+        else
+        {
+            key |= 1ull << 59;
+            key |= (0xFFFFFFull - depth) << 35;
+            key |= shader << 23;
+            key |= tex << 11;
+        }
+        return key;
+    }
+
+    static bool isTranslucent(uint64_t key) { return (key >> 59) & 1; }
+    static int layerOf(uint64_t key) { return (int)(key >> 60); }
+
+    // Liga/desliga o teste de profundidade para uma camada inteira (ex.: sobreposição sempre visível)
+    void setLayerDepthTest(int layer, bool enabled) { layerDepthTest[layer & 0xF] = enabled; }
+
+    void clear()
+    {
+        commands.clear();
+        entries.clear();
+    }
+
+    void reserve(size_t n)
+    {
+        commands.reserve(n);
+        entries.reserve(n);
+        scratch.reserve(n);
+    }
+
+    void submit(const RenderCommand &cmd)
+    {
+        entries.push_back({cmd.key, (uint32_t)commands.size()});
+        commands.push_back(cmd);
+    }
+
+    size_t size() const { return commands.size(); }
+
+    // Radix sort LSD (8 bits por passada) sobre os pares (chave, índice). Estável.
+    void sort()
+    {
+        size_t n = entries.size();
+        if (n < 2)
+            return;
+        scratch.resize(n);
+
+        // Histogramas das 8 passadas calculados numa única varredura
+        uint32_t histo[8][256];
+        memset(histo, 0, sizeof(histo));
+        for (size_t i = 0; i < n; i++)
+        {
+            uint64_t k = entries[i].key;
+            for (int p = 0; p < 8; p++)
+                histo[p][(k >> (p * 8)) & 0xFF]++;
+        }
+
+        SortEntry *src = entries.data();
+        SortEntry *dst = scratch.data();
+        for (int p = 0; p < 8; p++)
+        {
+            // Se todas as chaves têm o mesmo byte nesta posição, a passada é inútil
+            uint32_t *h = histo[p];
+            if (h[(src[0].key >> (p * 8)) & 0xFF] == n)
+                continue;
+
+            uint32_t offset[256];
+            uint32_t sum = 0;
+            for (int b = 0; b < 256; b++)
+            {
+                offset[b] = sum;
+                sum += h[b];
+            }
+            for (size_t i = 0; i < n; i++)
+            {
+                int b = (src[i].key >> (p * 8)) & 0xFF;
+                dst[offset[b]++] = src[i];
+            }
+            SortEntry *tmp = src;
+            src = dst;
+            dst = tmp;
+        }
+        if (src != entries.data())
+            entries.swap(scratch);
+    }
+
+    // Percorre os comandos já ordenados, trocando estado OpenGL apenas quando necessário
+    void execute()
+    {
+        stats = {};
+        GLuint currentShader = 0, currentVAO = 0, currentTex = 0;
+        GLint modelLoc = -1, offsetLoc = -1;
+        int currentDepthTest = -1, currentDepthWrite = -1;
+        bool first = true;
+
+        for (size_t i = 0; i < entries.size(); i++)
+        {
+            const RenderCommand &cmd = commands[entries[i].index];
+
+            if (first || cmd.shaderID != currentShader)
+            {
+                glUseProgram(cmd.shaderID);
+                currentShader = cmd.shaderID;
+                // Localizações consultadas apenas quando o programa muda
+                modelLoc = glGetUniformLocation(currentShader, "model");
+                offsetLoc = glGetUniformLocation(currentShader, "offset_tex");
+                stats.shaderChanges++;
+            }
+            if (first || cmd.VAO != currentVAO)
+            {
+                glBindVertexArray(cmd.VAO);
+                currentVAO = cmd.VAO;
+                stats.vaoChanges++;
+            }
+            if (first || cmd.texID != currentTex)
+            {
+                glBindTexture(GL_TEXTURE_2D, cmd.texID);
+                currentTex = cmd.texID;
+                stats.textureChanges++;
+            }
+
+            int depthTest = layerDepthTest[layerOf(entries[i].key)] ? 1 : 0;
+            if (depthTest != currentDepthTest)
+            {
+                if (depthTest)
+                    glEnable(GL_DEPTH_TEST);
+                else
+                    glDisable(GL_DEPTH_TEST);
+                currentDepthTest = depthTest;
+                stats.depthStateChanges++;
+            }
+            // Transparentes testam mas não escrevem profundidade
+            int depthWrite = isTranslucent(entries[i].key) ? 0 : 1;
+            if (depthWrite != currentDepthWrite)
+            {
+                glDepthMask(depthWrite ? GL_TRUE : GL_FALSE);
+                currentDepthWrite = depthWrite;
+                stats.depthStateChanges++;
+            }
+            first = false;
+
+            if (modelLoc >= 0)
+                glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(cmd.model));
+            if (offsetLoc >= 0)
+                glUniform2f(offsetLoc, cmd.offsetTex.x, cmd.offsetTex.y);
+
+            glDrawArrays(cmd.mode, cmd.first, cmd.count);
+            stats.drawCalls++;
+        }
+
+        // Deixa o estado padrão para quem desenhar depois da fila
+        glDepthMask(GL_TRUE);
+        glEnable(GL_DEPTH_TEST);
+    }
+
+    const RenderQueueStats &lastStats() const { return stats; }
+
+    // Acesso à ordem resultante (usado pelo benchmark para validar a ordenação)
+    uint64_t sortedKey(size_t i) const { return entries[i].key; }
+
+private:
+    struct SortEntry
+    {
+        uint64_t key;
+        uint32_t index;
+    };
+
+    std::vector<RenderCommand> commands;
+    std::vector<SortEntry> entries;
+    std::vector<SortEntry> scratch;
+    bool layerDepthTest[MAX_RENDER_LAYERS];
+    RenderQueueStats stats;
+};
@@ -0,0 +1,255 @@
+/*
+ * SpatialGrid - grade uniforme com hash para consultas espaciais e colisão entre sprites 2D
+ *
+ * O plano é dividido em células quadradas de cellSize pixels. Cada entidade fica na
+ * célula do seu centro, numa lista ligada por índices (head/next/prev), então inserir,
+ * remover e mover uma entidade custa O(1): mover só mexe nas listas quando o centro
+ * troca de célula, e atualizar N entidades por passo custa O(N).
+ *
+ * As células não são alocadas uma a uma: a coordenada (cx, cy) passa por um hash para
+ * uma tabela de tamanho fixo, o que permite mundos sem limite definido. Células
+ * diferentes podem cair no mesmo balde; por isso cada entidade guarda a sua célula e as
+ * consultas ignoram as que não são da célula visitada (assim também ninguém aparece duas vezes).
+ *
+ * Consultas:
+ *   queryRect(minX, minY, maxX, maxY, fn)   entidades cuja caixa cruza o retângulo
+ *   queryRadius(x, y, r, fn)                 entidades cuja caixa cruza o círculo
+ *   nearest(x, y, maxDist)                   centro mais próximo, em anéis de células
+ * Como a entidade está só na célula do centro, as consultas alargam a área visitada
+ * pela maior meia-largura/meia-altura já inserida. Entidades de tamanhos muito
+ * diferentes funcionam, mas as grandes tornam todas as consultas mais largas.
+ *
+ * A colisão das entidades com o tilemap fica em TileCollision.h (TileCollisionLayer).
+ */
+
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+class SpatialGrid
+{
+public:
+    // buckets é arredondado para potência de 2
+    explicit SpatialGrid(float cellSize = 32.0f, int buckets = 1 << 16)
+        : cellSize(cellSize), invCell(1.0f / cellSize), maxHalfW(0.0f), maxHalfH(0.0f), count(0)
+    {
+        int n = 1;
+        while (n < buckets)
+            n <<= 1;
+        head.assign(n, -1);
+        mask = n - 1;
+    }
+
+    int size() const { return count; }
+    float cell() const { return cellSize; }
+    bool contains(int id) const { return id >= 0 && id < (int)alive.size() && alive[id]; }
+
+    void clear()
+    {
+        head.assign(head.size(), -1);
+        alive.assign(alive.size(), 0);
+        count = 0;
+        maxHalfW = maxHalfH = 0.0f;
+    }
+
+    // id é escolhido por quem chama (ex.: o índice da entidade nos seus arrays)
+    void insert(int id, float x, float y, float halfW, float halfH)
+    {
+        if (id >= (int)alive.size())
+            grow(id + 1);
+        if (alive[id])
+            remove(id);
+        px[id] = x;
+        py[id] = y;
+        hw[id] = halfW;
+        hh[id] = halfH;
+        if (halfW > maxHalfW)
+            maxHalfW = halfW;
+        if (halfH > maxHalfH)
+            maxHalfH = halfH;
+        link(id, cellCoord(x), cellCoord(y));
+        alive[id] = 1;
+        count++;
+    }
+
+    void remove(int id)
+    {
+        if (!contains(id))
+            return;
+        unlink(id);
+        alive[id] = 0;
+        count--;
+    }
+
+    // Nova posição do centro. Retorna true se a entidade mudou de célula.
+    bool update(int id, float x, float y)
+    {
+        px[id] = x;
+        py[id] = y;
+        int cx = cellCoord(x), cy = cellCoord(y);
+        if (cx == cellX[id] && cy == cellY[id])
+            return false;
+        unlink(id);
+        link(id, cx, cy);
+        return true;
+    }
+
+    // A entidade "from" passa a se chamar "to" (para remoções com troca pela última,
+    // como em SpriteEntities::remove). "to" não pode estar em uso.
+    void rename(int from, int to)
+    {
+        if (!contains(from) || from == to)
+            return;
+        if (to >= (int)alive.size())
+            grow(to + 1);
+        int cx = cellX[from], cy = cellY[from];
+        unlink(from);
+        alive[from] = 0;
+        px[to] = px[from];
+        py[to] = py[from];
+        hw[to] = hw[from];
+        hh[to] = hh[from];
+        link(to, cx, cy);
+        alive[to] = 1;
+    }
+
+    float x(int id) const { return px[id]; }
+    float y(int id) const { return py[id]; }
+
+    // fn(int id) para cada entidade cuja caixa cruza o retângulo
+    template <typename F>
+    void queryRect(float minX, float minY, float maxX, float maxY, F fn) const
+    {
+        int cx0 = cellCoord(minX - maxHalfW), cx1 = cellCoord(maxX + maxHalfW);
+        int cy0 = cellCoord(minY - maxHalfH), cy1 = cellCoord(maxY + maxHalfH);
+        for (int cy = cy0; cy <= cy1; cy++)
+        {
+            for (int cx = cx0; cx <= cx1; cx++)
+            {
+                for (int id = head[bucket(cx, cy)]; id != -1; id = next[id])
+                {
+                    if (cellX[id] != cx || cellY[id] != cy)
+                        continue;
+                    if (px[id] + hw[id] < minX || px[id] - hw[id] > maxX ||
+                        py[id] + hh[id] < minY || py[id] - hh[id] > maxY)
+                        continue;
+                    fn(id);
+                }
+            }
+        }
+    }
+
+    // fn(int id) para cada entidade cuja caixa cruza o círculo
+    template <typename F>
+    void queryRadius(float x, float y, float r, F fn) const
+    {
+        float r2 = r * r;
+        queryRect(x - r, y - r, x + r, y + r, [&](int id) {
+            // Ponto da caixa mais próximo do centro do círculo
+            float dx = fabsf(x - px[id]) - hw[id];
+            float dy = fabsf(y - py[id]) - hh[id];
+            dx = dx > 0.0f ? dx : 0.0f;
+            dy = dy > 0.0f ? dy : 0.0f;
+            if (dx * dx + dy * dy <= r2)
+                fn(id);
+        });
+    }
+
+    // Entidade com o centro mais próximo de (x, y), até maxDist; -1 se não houver.
+    // Visita anéis de células em volta do ponto e para quando o próximo anel já está
+    // mais longe que o melhor candidato.
+    int nearest(float x, float y, float maxDist, int ignore = -1) const
+    {
+        if (count == 0)
+            return -1;
+        int best = -1;
+        float best2 = maxDist * maxDist;
+        int cx = cellCoord(x), cy = cellCoord(y);
+        int maxRing = (int)(maxDist * invCell) + 1;
+        for (int ring = 0; ring <= maxRing; ring++)
+        {
+            // Qualquer ponto do anel está a pelo menos (ring - 1) células do ponto
+            float ringDist = (ring - 1) * cellSize;
+            if (ring > 1 && ringDist * ringDist > best2)
+                break;
+            for (int dy = -ring; dy <= ring; dy++)
+            {
+                // Nas linhas do meio, só as duas células das pontas fazem parte do anel
+                int step = (dy == -ring || dy == ring) ? 1 : 2 * ring;
+                for (int dx = -ring; dx <= ring; dx += step)
+                {
+                    int ccx = cx + dx, ccy = cy + dy;
+                    for (int id = head[bucket(ccx, ccy)]; id != -1; id = next[id])
+                    {
+                        if (cellX[id] != ccx || cellY[id] != ccy || id == ignore)
+                            continue;
+                        float ex = px[id] - x, ey = py[id] - y;
+                        float d2 = ex * ex + ey * ey;
+                        if (d2 <= best2)
+                        {
+                            best2 = d2;
+                            best = id;
+                        }
+                    }
+                }
+            }
+        }
+        return best;
+    }
+
+private:
+    float cellSize, invCell;
+    int mask;
+    float maxHalfW, maxHalfH;
+    int count;
+
+    std::vector<int> head;         // primeira entidade de cada balde
+    std::vector<int> next, prev;   // lista ligada dentro do balde
+    std::vector<int> cellX, cellY; // célula atual de cada entidade
+    std::vector<float> px, py, hw, hh;
+    std::vector<uint8_t> alive;
+
+    int cellCoord(float v) const { return (int)floorf(v * invCell); }
+
+    int bucket(int cx, int cy) const
+    {
+        return (int)(((uint32_t)cx * 73856093u) ^ ((uint32_t)cy * 19349663u)) & mask;
+    }
+
+    void grow(int n)
+    {
+        next.resize(n, -1);
+        prev.resize(n, -1);
+        cellX.resize(n, 0);
+        cellY.resize(n, 0);
+        px.resize(n, 0.0f);
+        py.resize(n, 0.0f);
+        hw.resize(n, 0.0f);
+        hh.resize(n, 0.0f);
+        alive.resize(n, 0);
+    }
+
+    void link(int id, int cx, int cy)
+    {
+        int b = bucket(cx, cy);
+        cellX[id] = cx;
+        cellY[id] = cy;
+        prev[id] = -1;
+        next[id] = head[b];
+        if (head[b] != -1)
+            prev[head[b]] = id;
+        head[b] = id;
+    }
+
+    void unlink(int id)
+    {
+        if (prev[id] != -1)
+            next[prev[id]] = next[id];
+        else
+            head[bucket(cellX[id], cellY[id])] = next[id];
+        if (next[id] != -1)
+            prev[next[id]] = prev[id];
+    }
+};
@@ -0,0 +1,259 @@
+/*
+ * SpriteAnimation - clipes de animação descritos em arquivo e reprodução por entidade
+ *
+ * AnimationLibrary lê a descrição de uma spritesheet em JSON (ver
+ * assets/sprites/enemies-spritesheet1.json): grade de colunas x linhas e uma lista de
+ * clipes com nome, quadros e duração de cada quadro. Na carga, cada quadro vira um
+ * AnimFrame com o retângulo de textura (UVRect) já calculado; quem desenha só copia
+ * o retângulo para o shader, sem refazer iFrame * ds a cada frame.
+ *
+ * Formato:
+ *   {
+ *     "texture": "enemies-spritesheet1.png",   // relativo à pasta do .json
+ *     "columns": 2, "rows": 12,
+ *     "clips": [
+ *       { "name": "voador_0", "row": 4, "durations": [0.08, 0.12] },
+ *       { "name": "blob_0", "row": 0, "cols": [0, 1, 0], "frameDuration": 0.2, "loop": false }
+ *     ]
+ *   }
+ *   "cols" é opcional (padrão: todas as colunas da linha, em ordem); "durations" dá a
+ *   duração de cada quadro e "frameDuration" uma duração única; "loop" vale true se omitido.
+ *   Linhas e colunas fora da grade invalidam o arquivo. Como os nomes vêm dos dados,
+ *   requireClip() é o jeito de buscar um clipe na inicialização: avisa qual falta.
+ *
+ * AnimationPlayers guarda o estado de reprodução de todas as entidades em arrays
+ * (clipe, quadro atual, tempo no quadro, velocidade) e avança todas juntas em update(),
+ * uma vez por passo de simulação.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "Json.h"
+
+// Retângulo de um quadro na textura: (s0, t0) é o canto superior esquerdo e (s1, t1) o
+// inferior direito. t cresce para baixo na imagem, pois a stb_image carrega a primeira
+// linha do arquivo em t = 0.
+struct UVRect
+{
+    float s0, t0, s1, t1;
+};
+
+struct AnimFrame
+{
+    UVRect uv;
+    float duration; // segundos
+};
+
+struct AnimClip
+{
+    std::string name;
+    int first;   // índice do primeiro quadro em AnimationLibrary::frames
+    int count;   // número de quadros
+    bool loop;
+    float length; // soma das durações
+};
+
+class AnimationLibrary
+{
+public:
+    std::vector<AnimFrame> frames;
+    std::vector<AnimClip> clips;
+    std::string texturePath; // caminho da textura, já com a pasta do .json
+    int columns = 1, rows = 1;
+
+    // Retorna false (com a mensagem no terminal) se o arquivo não existir ou for inválido
+    bool load(const char *path)
+    {
+        JsonValue doc;
+        std::string error;
+        if (!loadJsonFile(path, doc, &error))
+        {
+            fprintf(stderr, "AnimationLibrary: %s: %s\n", path, error.c_str());
+            return false;
+        }
+
+        columns = doc["columns"].asInt(1);
+        rows = doc["rows"].asInt(1);
+        if (columns < 1 || rows < 1)
+        {
+            fprintf(stderr, "AnimationLibrary: %s: grade invalida\n", path);
+            return false;
+        }
+        source = path;
+        std::string dir(path);
+        size_t slash = dir.find_last_of("/\\");
+        dir = slash == std::string::npos ? "" : dir.substr(0, slash + 1);
+        texturePath = dir + doc["texture"].asString();
+
+        frames.clear();
+        clips.clear();
+        const JsonValue &list = doc["clips"];
+        for (size_t c = 0; c < list.size(); c++)
+        {
+            const JsonValue &desc = list[c];
+            AnimClip clip;
+            clip.name = desc["name"].asString();
+            clip.first = (int)frames.size();
+            clip.loop = desc["loop"].asBool(true);
+            clip.length = 0.0f;
+
+            int row = desc["row"].asInt(0);
+            if (row < 0 || row >= rows)
+            {
+                fprintf(stderr, "AnimationLibrary: %s: clipe %s na linha %d, fora da grade\n", path,
+                        clip.name.c_str(), row);
+                return false;
+            }
+            const JsonValue &cols = desc["cols"];
+            int n = cols.isArray() ? (int)cols.size() : columns;
+            for (int i = 0; i < n; i++)
+            {
+                int col = cols.isArray() ? cols[i].asInt(0) : i;
+                if (col < 0 || col >= columns)
+                {
+                    fprintf(stderr, "AnimationLibrary: %s: clipe %s na coluna %d, fora da grade\n", path,
+                            clip.name.c_str(), col);
+                    return false;
+                }
+                // Quadro sem duração própria usa a do clipe; duração zero travaria o update
+                float d = (float)desc["durations"][i].asNumber(desc["frameDuration"].asNumber(0.1));
+                if (d < 0.001f)
+                    d = 0.001f;
+                frames.push_back({cellRect(col, row), d});
+                clip.length += d;
+            }
+            clip.count = n;
+            if (clip.name.empty() || n == 0)
+            {
+                fprintf(stderr, "AnimationLibrary: %s: clipe %d sem nome ou sem quadros\n", path, (int)c);
+                return false;
+            }
+            clips.push_back(clip);
+        }
+        return true;
+    }
+
+    // Índice do clipe pelo nome, ou -1
+    int findClip(const char *name) const
+    {
+        for (size_t i = 0; i < clips.size(); i++)
+            if (clips[i].name == name)
+                return (int)i;
+        return -1;
+    }
+
+    // Como findClip, mas avisa no terminal quando o clipe não existe no arquivo
+    int requireClip(const char *name) const
+    {
+        int i = findClip(name);
+        if (i < 0)
+            fprintf(stderr, "AnimationLibrary: %s: clipe %s nao encontrado\n", source.c_str(), name);
+        return i;
+    }
+
+    bool validClip(int clipIndex) const { return clipIndex >= 0 && clipIndex < (int)clips.size(); }
+
+    UVRect cellRect(int col, int row) const
+    {
+        float ds = 1.0f / columns, dt = 1.0f / rows;
+        return {col * ds, row * dt, (col + 1) * ds, (row + 1) * dt};
+    }
+
+private:
+    std::string source; // arquivo carregado, para as mensagens
+};
+
+class AnimationPlayers
+{
+public:
+    std::vector<int32_t> clip;  // clipe em reprodução
+    std::vector<int32_t> frame; // quadro atual (índice em AnimationLibrary::frames)
+    std::vector<float> timer;   // tempo já passado no quadro atual
+    std::vector<float> speed;   // 1 = velocidade normal
+    std::vector<uint8_t> finished; // clipe sem loop que chegou ao último quadro
+
+    explicit AnimationPlayers(const AnimationLibrary &library) : library(library) {}
+
+    int size() const { return (int)clip.size(); }
+
+    // Retorna o índice da entidade, ou -1 (sem adicionar) se o clipe não existir
+    int add(int clipIndex, float playbackSpeed = 1.0f)
+    {
+        if (!library.validClip(clipIndex))
+        {
+            fprintf(stderr, "AnimationPlayers: clipe %d invalido\n", clipIndex);
+            return -1;
+        }
+        clip.push_back(clipIndex);
+        frame.push_back(library.clips[clipIndex].first);
+        timer.push_back(0.0f);
+        speed.push_back(playbackSpeed);
+        finished.push_back(0);
+        return size() - 1;
+    }
+
+    // Troca o clipe da entidade. Pedir o clipe que já está tocando não o reinicia,
+    // a não ser com restart = true (para chamar a cada passo sem travar no 1º quadro).
+    // Retorna false (sem trocar) se o clipe não existir.
+    bool play(int i, int clipIndex, bool restart = false)
+    {
+        if (!library.validClip(clipIndex))
+        {
+            fprintf(stderr, "AnimationPlayers: clipe %d invalido\n", clipIndex);
+            return false;
+        }
+        if (clip[i] == clipIndex && !restart)
+            return true;
+        clip[i] = clipIndex;
+        frame[i] = library.clips[clipIndex].first;
+        timer[i] = 0.0f;
+        finished[i] = 0;
+        return true;
+    }
+
+    // Avança a animação de todas as entidades (um passo de simulação)
+    void update(float dt)
+    {
+        const AnimFrame *frames = library.frames.data();
+        const AnimClip *clips = library.clips.data();
+        int n = size();
+        for (int i = 0; i < n; i++)
+        {
+            if (finished[i])
+                continue;
+            float t = timer[i] + dt * speed[i];
+            int f = frame[i];
+            while (t >= frames[f].duration)
+            {
+                t -= frames[f].duration;
+                const AnimClip &c = clips[clip[i]];
+                if (++f == c.first + c.count)
+                {
+                    if (!c.loop)
+                    {
+                        f--;
+                        t = 0.0f;
+                        finished[i] = 1;
+                        break;
+                    }
+                    f = c.first;
+                }
+            }
+            frame[i] = f;
+            timer[i] = t;
+        }
+    }
+
+    const UVRect &uv(int i) const { return library.frames[frame[i]].uv; }
+
+    // Posição do quadro atual dentro do clipe (0 = primeiro quadro)
+    int clipFrame(int i) const { return frame[i] - library.clips[clip[i]].first; }
+
+private:
+    const AnimationLibrary &library;
+};
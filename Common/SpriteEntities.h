@@ -0,0 +1,195 @@
+/*
+ * SpriteEntities - estado de simulação de muitos sprites em estrutura de arrays (SoA)
+ *
+ * O struct Sprite dos exemplos guarda junto os handles de OpenGL (VAO, texID) e o estado
+ * que muda a cada passo (pos, vel, iFrame...). Para milhares de sprites isso desperdiça
+ * cache: atualizar a posição traz para a memória todos os outros campos. Aqui cada campo
+ * é um array contíguo (posX[], posY[], velX[]...), então o laço de atualização lê só o
+ * que usa e processa 4 sprites por instrução SSE2. O intervalo de entidades é dividido
+ * entre as threads de um ThreadPool.
+ *
+ * Os arrays também são a entrada do desenho: posX, posY, frame e animation vão para a
+ * GPU como atributos por instância, sem montar um array intermediário.
+ *
+ * A textura é uma spritesheet de animações em linhas e frames em colunas (como
+ * enemies-spritesheet*.png). Cada entidade troca de frame a cada frameTime segundos.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define SPRITE_ENTITIES_SSE2 1
+#endif
+
+#include "ThreadPool.h"
+
+struct SpriteBounds
+{
+    float minX, minY, maxX, maxY;
+};
+
+class SpriteEntities
+{
+public:
+    std::vector<float> posX, posY;
+    std::vector<float> velX, velY;     // pixels por segundo
+    std::vector<float> animTimer;      // tempo desde a última troca de frame
+    std::vector<float> frameTime;      // duração de cada frame da animação
+    std::vector<int32_t> frame;        // coluna na spritesheet
+    std::vector<int32_t> frameCount;   // número de frames da animação
+    std::vector<int32_t> animation;    // linha na spritesheet
+
+    int size() const { return (int)posX.size(); }
+
+    void reserve(int n)
+    {
+        posX.reserve(n);
+        posY.reserve(n);
+        velX.reserve(n);
+        velY.reserve(n);
+        animTimer.reserve(n);
+        frameTime.reserve(n);
+        frame.reserve(n);
+        frameCount.reserve(n);
+        animation.reserve(n);
+    }
+
+    void clear()
+    {
+        posX.clear();
+        posY.clear();
+        velX.clear();
+        velY.clear();
+        animTimer.clear();
+        frameTime.clear();
+        frame.clear();
+        frameCount.clear();
+        animation.clear();
+    }
+
+    int add(float x, float y, float vx, float vy, int anim, int nFrames, float secondsPerFrame)
+    {
+        posX.push_back(x);
+        posY.push_back(y);
+        velX.push_back(vx);
+        velY.push_back(vy);
+        animTimer.push_back(0.0f);
+        frameTime.push_back(secondsPerFrame);
+        frame.push_back(0);
+        frameCount.push_back(nFrames);
+        animation.push_back(anim);
+        return size() - 1;
+    }
+
+    // Remove trocando com a última (a ordem das entidades não é preservada)
+    void remove(int i)
+    {
+        int last = size() - 1;
+        posX[i] = posX[last];
+        posY[i] = posY[last];
+        velX[i] = velX[last];
+        velY[i] = velY[last];
+        animTimer[i] = animTimer[last];
+        frameTime[i] = frameTime[last];
+        frame[i] = frame[last];
+        frameCount[i] = frameCount[last];
+        animation[i] = animation[last];
+        posX.pop_back();
+        posY.pop_back();
+        velX.pop_back();
+        velY.pop_back();
+        animTimer.pop_back();
+        frameTime.pop_back();
+        frame.pop_back();
+        frameCount.pop_back();
+        animation.pop_back();
+    }
+
+    // Um passo de simulação: movimento com rebote nas bordas e avanço da animação.
+    // Com pool, o trabalho é dividido em blocos entre as threads.
+    void update(float dt, const SpriteBounds &bounds, ThreadPool *pool = nullptr)
+    {
+        if (!pool)
+        {
+            updateRange(0, size(), dt, bounds);
+            return;
+        }
+        // Blocos múltiplos de 4 (largura do SSE) e grandes o bastante para diluir a sincronização
+        pool->parallelFor(size(), 16384, [&](int begin, int end) { updateRange(begin, end, dt, bounds); });
+    }
+
+    void updateRange(int begin, int end, float dt, const SpriteBounds &b)
+    {
+        int i = begin;
+#ifdef SPRITE_ENTITIES_SSE2
+        const __m128 vdt = _mm_set1_ps(dt);
+        const __m128 minX = _mm_set1_ps(b.minX), maxX = _mm_set1_ps(b.maxX);
+        const __m128 minY = _mm_set1_ps(b.minY), maxY = _mm_set1_ps(b.maxY);
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 sign = _mm_set1_ps(-0.0f);
+        const __m128i one = _mm_set1_epi32(1);
+        for (; i + 4 <= end; i += 4)
+        {
+            // Movimento: p += v * dt; ao passar da borda indo para fora, inverte v e prende p
+            __m128 px = _mm_loadu_ps(&posX[i]), vx = _mm_loadu_ps(&velX[i]);
+            __m128 py = _mm_loadu_ps(&posY[i]), vy = _mm_loadu_ps(&velY[i]);
+            px = _mm_add_ps(px, _mm_mul_ps(vx, vdt));
+            py = _mm_add_ps(py, _mm_mul_ps(vy, vdt));
+            __m128 flipX = _mm_or_ps(_mm_and_ps(_mm_cmplt_ps(px, minX), _mm_cmplt_ps(vx, zero)),
+                                     _mm_and_ps(_mm_cmpgt_ps(px, maxX), _mm_cmpgt_ps(vx, zero)));
+            __m128 flipY = _mm_or_ps(_mm_and_ps(_mm_cmplt_ps(py, minY), _mm_cmplt_ps(vy, zero)),
+                                     _mm_and_ps(_mm_cmpgt_ps(py, maxY), _mm_cmpgt_ps(vy, zero)));
+            vx = _mm_xor_ps(vx, _mm_and_ps(flipX, sign));
+            vy = _mm_xor_ps(vy, _mm_and_ps(flipY, sign));
+            _mm_storeu_ps(&posX[i], _mm_min_ps(_mm_max_ps(px, minX), maxX));
+            _mm_storeu_ps(&posY[i], _mm_min_ps(_mm_max_ps(py, minY), maxY));
+            _mm_storeu_ps(&velX[i], vx);
+            _mm_storeu_ps(&velY[i], vy);
+
+            // Animação: timer += dt; onde passou de frameTime, desconta e avança o frame
+            __m128 t = _mm_add_ps(_mm_loadu_ps(&animTimer[i]), vdt);
+            __m128 ft = _mm_loadu_ps(&frameTime[i]);
+            __m128 step = _mm_cmpge_ps(t, ft);
+            _mm_storeu_ps(&animTimer[i], _mm_sub_ps(t, _mm_and_ps(step, ft)));
+            __m128i f = _mm_loadu_si128((const __m128i *)&frame[i]);
+            __m128i n = _mm_loadu_si128((const __m128i *)&frameCount[i]);
+            f = _mm_add_epi32(f, _mm_and_si128(_mm_castps_si128(step), one));
+            f = _mm_andnot_si128(_mm_cmpeq_epi32(f, n), f); // f == n volta para 0
+            _mm_storeu_si128((__m128i *)&frame[i], f);
+        }
+#endif
+        updateRangeScalar(i, end, dt, b);
+    }
+
+    // Versão escalar (resto do bloco e plataformas sem SSE2): mesmo resultado do laço SIMD
+    void updateRangeScalar(int begin, int end, float dt, const SpriteBounds &b)
+    {
+        for (int i = begin; i < end; i++)
+            updateOne(i, dt, b);
+    }
+
+private:
+    void updateOne(int i, float dt, const SpriteBounds &b)
+    {
+        float x = posX[i] + velX[i] * dt;
+        float y = posY[i] + velY[i] * dt;
+        if ((x < b.minX && velX[i] < 0.0f) || (x > b.maxX && velX[i] > 0.0f))
+            velX[i] = -velX[i];
+        if ((y < b.minY && velY[i] < 0.0f) || (y > b.maxY && velY[i] > 0.0f))
+            velY[i] = -velY[i];
+        posX[i] = x < b.minX ? b.minX : (x > b.maxX ? b.maxX : x);
+        posY[i] = y < b.minY ? b.minY : (y > b.maxY ? b.maxY : y);
+
+        float t = animTimer[i] + dt;
+        if (t >= frameTime[i])
+        {
+            t -= frameTime[i];
+            frame[i] = frame[i] + 1 == frameCount[i] ? 0 : frame[i] + 1;
+        }
+        animTimer[i] = t;
+    }
+};
@@ -0,0 +1,208 @@
+/*
+ * StreamBuffer - buffer circular mapeado persistentemente para dados por frame
+ *
+ * Um único buffer OpenGL é dividido em 3 regiões (triple buffering). A cada frame a CPU
+ * escreve numa região enquanto a GPU ainda pode estar lendo as outras duas. Um fence
+ * (glFenceSync) marca o fim do uso de cada região; antes de reutilizá-la, beginFrame()
+ * espera por esse fence - na prática a espera só acontece se a CPU estiver 3 frames à frente.
+ *
+ * O buffer é criado com glBufferStorage(GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT) e
+ * mapeado uma única vez: escrever nele é só escrever na memória, sem nenhuma chamada ao driver.
+ * A alocação dentro da região é um "bump pointer" atômico (sem lock), então várias threads
+ * podem reservar e preencher trechos ao mesmo tempo.
+ *
+ * Se o driver não tiver glBufferStorage (OpenGL < 4.4), usa-se uma cópia na CPU que é
+ * enviada com glBufferSubData em flush() - mesma interface, sem o ganho do mapeamento.
+ *
+ * Uso típico por frame:
+ *   stream.beginFrame();
+ *   StreamAlloc a = stream.allocate(n * sizeof(Instancia));
+ *   memcpy(a.ptr, ...);                     // ou escrever direto em a.ptr
+ *   stream.flush(a);                        // não faz nada no modo persistente
+ *   glVertexAttribPointer(..., (void*)a.offset);
+ *   glDrawArraysInstanced(...);
+ *   stream.endFrame();
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <iostream>
+
+#include <glad/glad.h>
+
+#include "GLExt.h"
+
+// Trecho reservado no buffer: ponteiro para escrita e deslocamento em bytes no buffer OpenGL
+struct StreamAlloc
+{
+    void *ptr;
+    GLintptr offset;
+    GLsizeiptr size;
+};
+
+class StreamBuffer
+{
+public:
+    static const int N_REGIONS = 3;
+
+    StreamBuffer() : bufferID(0), regionSize(0), uniformAlignment(256), region(0), mapped(nullptr), persistent(false), head(0), waitCount(0)
+    {
+        for (int i = 0; i < N_REGIONS; i++)
+        {
+            fences[i] = 0;
+        }
+    }
+
+    // Cria o buffer com "bytesPerFrame" bytes por região. target é só o ponto de ligação
+    // usado na criação; o mesmo buffer pode depois ser usado como VBO, UBO ou indirect.
+    bool init(GLsizeiptr bytesPerFrame, GLenum target = GL_ARRAY_BUFFER)
+    {
+        GLint uboAlign = 256;
+        glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &uboAlign);
+        uniformAlignment = uboAlign > 0 ? uboAlign : 256;
+
+        // Cada região começa alinhada para poder conter faixas de UBO
+        regionSize = (bytesPerFrame + uniformAlignment - 1) / uniformAlignment * uniformAlignment;
+        GLsizeiptr total = regionSize * N_REGIONS;
+
+        glGenBuffers(1, &bufferID);
+        glBindBuffer(target, bufferID);
+
+        if (glBufferStorage)
+        {
+            GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+            glBufferStorage(target, total, nullptr, flags);
+            mapped = (uint8_t *)glMapBufferRange(target, 0, total, flags);
+            persistent = mapped != nullptr;
+        }
+        if (!persistent)
+        {
+            std::cout << "StreamBuffer: mapeamento persistente indisponivel, usando glBufferSubData" << std::endl;
+            if (glBufferStorage)
+            {
+                // O armazenamento de glBufferStorage é imutável: glBufferData nele daria
+                // GL_INVALID_OPERATION. Troca por um buffer novo.
+                glBindBuffer(target, 0);
+                glDeleteBuffers(1, &bufferID);
+                glGenBuffers(1, &bufferID);
+                glBindBuffer(target, bufferID);
+            }
+            glBufferData(target, total, nullptr, GL_STREAM_DRAW);
+            fallback.resize(total);
+            mapped = fallback.data();
+        }
+
+        glBindBuffer(target, 0);
+        return bufferID != 0;
+    }
+
+    void destroy()
+    {
+        for (int i = 0; i < N_REGIONS; i++)
+        {
+            if (fences[i])
+                glDeleteSync(fences[i]);
+            fences[i] = 0;
+        }
+        if (persistent)
+        {
+            glBindBuffer(GL_ARRAY_BUFFER, bufferID);
+            glUnmapBuffer(GL_ARRAY_BUFFER);
+            glBindBuffer(GL_ARRAY_BUFFER, 0);
+        }
+        glDeleteBuffers(1, &bufferID);
+        bufferID = 0;
+        mapped = nullptr;
+    }
+
+    // Avança para a próxima região, esperando a GPU liberá-la se necessário
+    void beginFrame()
+    {
+        region = (region + 1) % N_REGIONS;
+        GLsync fence = fences[region];
+        if (fence)
+        {
+            GLenum status = glClientWaitSync(fence, 0, 0);
+            if (status == GL_TIMEOUT_EXPIRED)
+            {
+                // A GPU está atrasada: espera de fato (raro com 3 regiões)
+                waitCount++;
+                do
+                {
+                    status = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000); // 1 ms
+                } while (status == GL_TIMEOUT_EXPIRED);
+            }
+            glDeleteSync(fence);
+            fences[region] = 0;
+        }
+        head.store(0, std::memory_order_relaxed);
+    }
+
+    // Reserva "size" bytes na região atual. Sem lock: pode ser chamada por várias threads.
+    // Retorna ptr == nullptr se a região do frame estiver cheia.
+    StreamAlloc allocate(GLsizeiptr size, GLsizeiptr alignment = 16)
+    {
+        size_t cur = head.load(std::memory_order_relaxed);
+        size_t start, next;
+        do
+        {
+            start = (cur + alignment - 1) / alignment * alignment;
+            next = start + size;
+            if (next > (size_t)regionSize)
+                return {nullptr, 0, 0};
+        } while (!head.compare_exchange_weak(cur, next, std::memory_order_relaxed));
+
+        GLintptr offset = region * regionSize + start;
+        return {mapped + offset, offset, size};
+    }
+
+    // Reserva alinhada para uso como faixa de UBO (glBindBufferRange)
+    StreamAlloc allocateUniform(GLsizeiptr size)
+    {
+        return allocate(size, uniformAlignment);
+    }
+
+    void bindRange(GLenum target, GLuint index, const StreamAlloc &a) const
+    {
+        glBindBufferRange(target, index, bufferID, a.offset, a.size);
+    }
+
+    // Fecha o frame registrando o fence da região.
+    // Deve ser chamada depois do último draw que lê dados desta região.
+    void endFrame()
+    {
+        fences[region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    }
+
+    // No modo sem mapeamento persistente, envia o trecho já escrito para a GPU
+    void flush(const StreamAlloc &a)
+    {
+        if (persistent || a.size == 0)
+            return;
+        glBindBuffer(GL_ARRAY_BUFFER, bufferID);
+        glBufferSubData(GL_ARRAY_BUFFER, a.offset, a.size, a.ptr);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+
+    GLuint buffer() const { return bufferID; }
+    bool isPersistent() const { return persistent; }
+    GLsizeiptr capacity() const { return regionSize; }
+    GLsizeiptr bytesUsed() const { return (GLsizeiptr)head.load(std::memory_order_relaxed); }
+    int fenceWaits() const { return waitCount; }
+
+private:
+    GLuint bufferID;
+    GLsizeiptr regionSize;
+    GLsizeiptr uniformAlignment;
+    int region;
+    uint8_t *mapped;
+    bool persistent;
+    std::vector<uint8_t> fallback;
+    GLsync fences[N_REGIONS];
+    std::atomic<size_t> head;
+    int waitCount;
+};
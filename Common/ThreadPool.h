@@ -0,0 +1,130 @@
+/*
+ * ThreadPool - grupo fixo de threads para laços paralelos (parallelFor)
+ *
+ * As threads são criadas uma vez e ficam esperando trabalho; criar threads a cada
+ * frame custaria mais que a própria atualização. parallelFor(count, grain, fn) divide
+ * [0, count) em blocos de "grain" elementos, que as threads (e a thread que chamou, que
+ * também trabalha) pegam de um contador atômico até acabar. fn(begin, end) recebe
+ * intervalos disjuntos, então pode escrever nos elementos do seu bloco sem travas.
+ *
+ * parallelFor só retorna quando todos os blocos terminaram. Não é reentrante: fn não
+ * pode chamar parallelFor do mesmo pool.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class ThreadPool
+{
+public:
+    // threads = número total de threads trabalhando, incluindo a que chama parallelFor
+    // (0 = uma por núcleo)
+    explicit ThreadPool(int threads = 0) : generation(0), stopping(false), activeWorkers(0)
+    {
+        if (threads <= 0)
+            threads = (int)std::thread::hardware_concurrency();
+        if (threads <= 0)
+            threads = 1;
+        for (int i = 0; i < threads - 1; i++)
+            workers.emplace_back(&ThreadPool::workerLoop, this);
+    }
+
+    ~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+            generation++;
+        }
+        wake.notify_all();
+        for (std::thread &t : workers)
+            t.join();
+    }
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    int size() const { return (int)workers.size() + 1; }
+
+    void parallelFor(int count, int grain, const std::function<void(int, int)> &fn)
+    {
+        if (count <= 0)
+            return;
+        if (grain < 1)
+            grain = 1;
+        // Pouco trabalho ou nenhuma thread extra: roda direto, sem sincronização
+        if (workers.empty() || count <= grain)
+        {
+            fn(0, count);
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            job = &fn;
+            jobCount = count;
+            jobGrain = grain;
+            nextIndex.store(0);
+            activeWorkers = (int)workers.size();
+            generation++;
+        }
+        wake.notify_all();
+
+        runChunks();
+
+        std::unique_lock<std::mutex> lock(mutex);
+        done.wait(lock, [this] { return activeWorkers == 0; });
+        job = nullptr;
+    }
+
+private:
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wake, done;
+    unsigned generation;
+    bool stopping;
+    int activeWorkers;
+
+    const std::function<void(int, int)> *job = nullptr;
+    int jobCount = 0, jobGrain = 1;
+    std::atomic<int> nextIndex{0};
+
+    void runChunks()
+    {
+        for (;;)
+        {
+            int begin = nextIndex.fetch_add(jobGrain);
+            if (begin >= jobCount)
+                break;
+            int end = begin + jobGrain < jobCount ? begin + jobGrain : jobCount;
+            (*job)(begin, end);
+        }
+    }
+
+    void workerLoop()
+    {
+        unsigned seen = 0;
+        for (;;)
+        {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wake.wait(lock, [&] { return generation != seen; });
+                seen = generation;
+                if (stopping)
+                    return;
+            }
+            runChunks();
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                activeWorkers--;
+            }
+            done.notify_one();
+        }
+    }
+};
@@ -0,0 +1,172 @@
+/*
+ * TileAnimation - tiles animados resolvidos no shader, a partir de uma tabela num UBO
+ *
+ * Cada ID do tileset pode ter uma animação: uma lista de IDs (os quadros) e a duração de
+ * cada quadro. A tabela inteira vai para um Uniform Buffer Object uma única vez; o
+ * fragment shader troca o ID lido do mapa pelo quadro atual usando um uniform de tempo
+ * global. Água e lava animadas não custam nada na CPU por tile nem por frame: o mapa
+ * guarda só o ID base e nada é reescrito.
+ *
+ * Bloco no shader (std140, ligado ao ponto TILE_ANIM_UBO_BINDING):
+ *
+ *   struct TileAnim { int first; int count; float frameDuration; float pad; };
+ *   layout (std140) uniform TileAnimations
+ *   {
+ *       TileAnim tile_anim[TILE_ANIM_MAX_IDS];            // por ID base; count 0 = sem animação
+ *       ivec4 tile_frames[TILE_ANIM_MAX_FRAMES / 4];      // IDs dos quadros, 4 por ivec4
+ *   };
+ *
+ *   quadro = tile_frames[f / 4][f % 4], com f = first + int(time / frameDuration) % count
+ *
+ * (Com #version < 420 o bloco não aceita "binding = N": chame bindProgram(programa).)
+ *
+ * A tabela vem de um JSON (ver assets/tilesets/tileset.json):
+ *   { "animations": [ { "tile": 5, "frames": [5, 9, 10], "frameDuration": 0.6 } ] }
+ * Os quadros são tiles do próprio tileset (em geral colunas extras depois dos tiles do
+ * mapa); load() recusa IDs fora do tileset e o mesmo tile animado duas vezes.
+ */
+
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+#include <glad/glad.h>
+
+#include "Json.h"
+
+const GLuint TILE_ANIM_UBO_BINDING = 1;
+const int TILE_ANIM_MAX_IDS = 64;
+const int TILE_ANIM_MAX_FRAMES = 256;
+
+// Layout std140: a struct tem 16 bytes e um array de int32 empacotado bate com ivec4[N/4]
+struct TileAnimEntry
+{
+    int32_t first;
+    int32_t count;
+    float frameDuration;
+    float pad;
+};
+
+struct TileAnimBlock
+{
+    TileAnimEntry anim[TILE_ANIM_MAX_IDS];
+    int32_t frames[TILE_ANIM_MAX_FRAMES];
+};
+
+class TileAnimationTable
+{
+public:
+    TileAnimationTable() : uboID(0), nFrames(0), nAnimated(0) { memset(&block, 0, sizeof(block)); }
+
+    // Anima o tile de ID "tile" pelos quadros dados. Retorna false se não couber na tabela,
+    // se algum quadro for negativo ou se o tile já tiver animação.
+    bool add(int tile, const int *frames, int count, float frameDuration)
+    {
+        if (tile < 0 || tile >= TILE_ANIM_MAX_IDS || count < 1 || nFrames + count > TILE_ANIM_MAX_FRAMES)
+            return false;
+        if (block.anim[tile].count != 0)
+            return false;
+        for (int i = 0; i < count; i++)
+            if (frames[i] < 0)
+                return false;
+        nAnimated++;
+        block.anim[tile].first = nFrames;
+        block.anim[tile].count = count;
+        // Duração zero faria a divisão no shader explodir
+        block.anim[tile].frameDuration = frameDuration < 0.001f ? 0.001f : frameDuration;
+        for (int i = 0; i < count; i++)
+            block.frames[nFrames++] = frames[i];
+        return true;
+    }
+
+    // Retorna false (com a mensagem no terminal) se o arquivo não existir ou for inválido.
+    // nTiles é o número de tiles do tileset: tiles e quadros fora dele são erro.
+    bool load(const char *path, int nTiles)
+    {
+        JsonValue doc;
+        std::string error;
+        if (!loadJsonFile(path, doc, &error))
+        {
+            fprintf(stderr, "TileAnimationTable: %s: %s\n", path, error.c_str());
+            return false;
+        }
+
+        const JsonValue &list = doc["animations"];
+        for (size_t a = 0; a < list.size(); a++)
+        {
+            const JsonValue &desc = list[a];
+            const JsonValue &frameList = desc["frames"];
+            int frames[TILE_ANIM_MAX_FRAMES];
+            int count = (int)frameList.size();
+            if (count > TILE_ANIM_MAX_FRAMES)
+                count = TILE_ANIM_MAX_FRAMES;
+            int tile = desc["tile"].asInt(-1);
+            bool inRange = tile >= 0 && tile < nTiles;
+            for (int i = 0; i < count; i++)
+            {
+                frames[i] = frameList[i].asInt(-1);
+                if (frames[i] < 0 || frames[i] >= nTiles)
+                    inRange = false;
+            }
+            if (!inRange)
+            {
+                fprintf(stderr, "TileAnimationTable: %s: animacao %d usa tile fora do tileset (0..%d)\n", path, (int)a,
+                        nTiles - 1);
+                return false;
+            }
+            if (!add(tile, frames, count, (float)desc["frameDuration"].asNumber(0.25)))
+            {
+                fprintf(stderr, "TileAnimationTable: %s: animacao %d repetida, vazia ou sem espaco na tabela\n", path, (int)a);
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Mesma conta do shader, na CPU (para lógica de jogo ou conferência)
+    int frameAt(int tile, float time) const
+    {
+        if (tile < 0 || tile >= TILE_ANIM_MAX_IDS || block.anim[tile].count == 0)
+            return tile;
+        const TileAnimEntry &a = block.anim[tile];
+        int k = (int)floorf(time / a.frameDuration) % a.count;
+        return block.frames[a.first + k];
+    }
+
+    int animatedCount() const { return nAnimated; }
+
+    // Cria o UBO com a tabela e o liga ao ponto fixo. Chamar de novo após add/load reenvia.
+    void upload()
+    {
+        if (!uboID)
+            glGenBuffers(1, &uboID);
+        glBindBuffer(GL_UNIFORM_BUFFER, uboID);
+        glBufferData(GL_UNIFORM_BUFFER, sizeof(TileAnimBlock), &block, GL_STATIC_DRAW);
+        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+        glBindBufferBase(GL_UNIFORM_BUFFER, TILE_ANIM_UBO_BINDING, uboID);
+    }
+
+    // Liga o bloco "TileAnimations" de um programa ao ponto fixo (para GLSL < 4.20)
+    static void bindProgram(GLuint program)
+    {
+        GLuint index = glGetUniformBlockIndex(program, "TileAnimations");
+        if (index != GL_INVALID_INDEX)
+            glUniformBlockBinding(program, index, TILE_ANIM_UBO_BINDING);
+    }
+
+    void destroy()
+    {
+        glDeleteBuffers(1, &uboID);
+        uboID = 0;
+    }
+
+private:
+    GLuint uboID;
+    TileAnimBlock block;
+    int nFrames;
+    int nAnimated;
+};
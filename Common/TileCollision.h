@@ -0,0 +1,266 @@
+/*
+ * TileCollision - camada de colisão de um tilemap e controlador de personagem (AABB com varredura)
+ *
+ * TileCollisionLayer guarda, para cada célula do mapa, as flags do tile (TILE_SOLID...),
+ * tiradas de uma tabela indexada pelo ID do tile. Também guarda, para cada linha, os
+ * trechos contínuos de células sólidas ("runs", [início, fim) em colunas), em ordem.
+ * Uma varredura horizontal acha a próxima parede de uma linha com busca binária nesses
+ * trechos, sem visitar célula por célula, então andar 2 ou 2000 pixels custa o mesmo.
+ *
+ * CharacterController move uma caixa (AABB) pelo mapa eixo por eixo: primeiro em x,
+ * limitado pela parede mais próxima em cada linha que a caixa ocupa; depois em y,
+ * visitando só as poucas células entre a borda da caixa e o destino. A caixa nunca
+ * atravessa paredes, mesmo com deslocamentos maiores que um tile, e o custo depende do
+ * tamanho da caixa e do deslocamento, não do tamanho do mapa.
+ *
+ * Coordenadas como em HelloTiles: linha 0 no topo do mapa, canto superior esquerdo em
+ * (left, top) e y crescendo para cima. Fora do mapa conta como parede se outsideSolid.
+ */
+
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+enum TileFlags
+{
+    TILE_SOLID = 1 << 0, // bloqueia o movimento
+};
+
+class TileCollisionLayer
+{
+public:
+    int cols = 0, rows = 0;
+    float tileW = 1.0f, tileH = 1.0f;
+    float left = 0.0f, top = 0.0f;
+    bool outsideSolid = true;
+
+    // tiles: IDs em ordem de linhas (cols x rows); flagsById[id] = flags daquele tile
+    void build(const int *tiles, int nCols, int nRows, const uint8_t *flagsById, int nIds,
+               float tileWidth, float tileHeight, float mapLeft, float mapTop)
+    {
+        cols = nCols;
+        rows = nRows;
+        tileW = tileWidth;
+        tileH = tileHeight;
+        left = mapLeft;
+        top = mapTop;
+        edgeEps = 1e-3f * fminf(tileW, tileH);
+        idFlags.assign(flagsById, flagsById + nIds);
+        flags.assign((size_t)cols * rows, 0);
+        for (int i = 0; i < cols * rows; i++)
+            flags[i] = flagsOf(tiles[i]);
+        runStart.assign(rows, 0);
+        runCount.assign(rows, 0);
+        runs.clear();
+        garbage = 0;
+        for (int r = 0; r < rows; r++)
+            appendRuns(r);
+    }
+
+    uint8_t flagsAt(int col, int row) const
+    {
+        if (col < 0 || row < 0 || col >= cols || row >= rows)
+            return outsideSolid ? TILE_SOLID : 0;
+        return flags[(size_t)row * cols + col];
+    }
+
+    bool solidAt(int col, int row) const { return (flagsAt(col, row) & TILE_SOLID) != 0; }
+
+    // Troca o tile de uma célula (ex.: uma porta que abre) e refaz os trechos da linha
+    void setTile(int col, int row, int id)
+    {
+        if (col < 0 || row < 0 || col >= cols || row >= rows)
+            return;
+        flags[(size_t)row * cols + col] = flagsOf(id);
+        rebuildRow(row);
+    }
+
+    int colAt(float x) const { return (int)floorf((x - left) / tileW); }
+    int rowAt(float y) const { return (int)floorf((top - y) / tileH); }
+    float colLeft(int c) const { return left + c * tileW; }
+    float rowTop(int r) const { return top - r * tileH; }
+
+    // Maior deslocamento horizontal (com o sinal de dx) que a faixa vertical
+    // [minY, maxY] pode fazer a partir de [minX, maxX] sem entrar em célula sólida
+    float sweepX(float minX, float maxX, float minY, float maxY, float dx) const
+    {
+        if (dx == 0.0f)
+            return 0.0f;
+        int r0 = rowAt(maxY - edgeEps), r1 = rowAt(minY + edgeEps);
+        float allowed = dx;
+        for (int r = r0; r <= r1; r++)
+        {
+            if (r < 0 || r >= rows)
+                continue; // acima/abaixo do mapa: a varredura em y não deixa a caixa chegar lá
+            if (dx > 0.0f)
+            {
+                // Primeiro trecho que começa à direita da borda da caixa
+                int c = firstRunAtOrAfter(r, colAt(maxX - edgeEps) + 1);
+                float wall = c >= 0 ? colLeft(c) : (outsideSolid ? colLeft(cols) : INFINITY);
+                if (wall - maxX < allowed)
+                    allowed = wall - maxX;
+            }
+            else
+            {
+                // Último trecho que termina à esquerda da borda da caixa
+                int c = lastRunEndAtOrBefore(r, colAt(minX + edgeEps));
+                float wall = c >= 0 ? colLeft(c) : (outsideSolid ? colLeft(0) : -INFINITY);
+                if (wall - minX > allowed)
+                    allowed = wall - minX;
+            }
+        }
+        // A caixa já encostada (ou levemente dentro, por arredondamento) não anda para dentro
+        if ((dx > 0.0f && allowed < 0.0f) || (dx < 0.0f && allowed > 0.0f))
+            allowed = 0.0f;
+        return allowed;
+    }
+
+    // Idem na vertical: visita as linhas entre a borda da caixa e o destino
+    float sweepY(float minX, float maxX, float minY, float maxY, float dy) const
+    {
+        if (dy == 0.0f)
+            return 0.0f;
+        int c0 = colAt(minX + edgeEps), c1 = colAt(maxX - edgeEps);
+        if (dy > 0.0f)
+        {
+            // Subindo: linhas de índice menor, a partir da primeira acima da borda superior
+            int rFirst = rowAt(maxY - edgeEps) - 1, rLast = rowAt(maxY + dy - edgeEps);
+            for (int r = rFirst; r >= rLast; r--)
+                for (int c = c0; c <= c1; c++)
+                    if (solidAt(c, r))
+                        return fmaxf(0.0f, (rowTop(r) - tileH) - maxY);
+        }
+        else
+        {
+            int rFirst = rowAt(minY + edgeEps) + 1, rLast = rowAt(minY + dy + edgeEps);
+            for (int r = rFirst; r <= rLast; r++)
+                for (int c = c0; c <= c1; c++)
+                    if (solidAt(c, r))
+                        return fminf(0.0f, rowTop(r) - minY);
+        }
+        return dy;
+    }
+
+    // Trechos sólidos da linha (para desenhar ou depurar): pares [início, fim) em colunas
+    int rowRunCount(int row) const { return runCount[row]; }
+    int rowRunBegin(int row, int i) const { return runs[runStart[row] + i].begin; }
+    int rowRunEnd(int row, int i) const { return runs[runStart[row] + i].end; }
+
+private:
+    // Folga nas bordas: uma caixa encostada num tile não o ocupa. Proporcional ao tile
+    // para continuar maior que o erro de arredondamento em mapas grandes (coordenadas altas)
+    float edgeEps = 1e-3f;
+
+    struct Run
+    {
+        int begin, end;
+    };
+
+    std::vector<uint8_t> idFlags;
+    std::vector<uint8_t> flags;
+    std::vector<Run> runs;     // trechos de todas as linhas, linha após linha
+    std::vector<int> runStart; // primeiro trecho de cada linha em runs
+    std::vector<int> runCount;
+    int garbage = 0;           // trechos antigos ainda em runs, de linhas refeitas
+
+    uint8_t flagsOf(int id) const
+    {
+        return id >= 0 && id < (int)idFlags.size() ? idFlags[id] : 0;
+    }
+
+    void appendRuns(int r)
+    {
+        runStart[r] = (int)runs.size();
+        const uint8_t *row = &flags[(size_t)r * cols];
+        for (int c = 0; c < cols;)
+        {
+            if (!(row[c] & TILE_SOLID))
+            {
+                c++;
+                continue;
+            }
+            int begin = c;
+            while (c < cols && (row[c] & TILE_SOLID))
+                c++;
+            runs.push_back({begin, c});
+        }
+        runCount[r] = (int)runs.size() - runStart[r];
+    }
+
+    // Mudança num só tile: refaz a linha no fim do vetor e descarta a lista antiga
+    // dela; quando o lixo passa do tamanho útil, compacta tudo
+    void rebuildRow(int r)
+    {
+        garbage += runCount[r];
+        appendRuns(r);
+        if (garbage > (int)runs.size() / 2 + 64)
+        {
+            std::vector<Run> compact;
+            compact.reserve(runs.size() - garbage);
+            for (int i = 0; i < rows; i++)
+            {
+                int start = (int)compact.size();
+                for (int k = 0; k < runCount[i]; k++)
+                    compact.push_back(runs[runStart[i] + k]);
+                runStart[i] = start;
+            }
+            runs.swap(compact);
+            garbage = 0;
+        }
+    }
+
+    // Coluna inicial do primeiro trecho com begin >= col, ou -1
+    int firstRunAtOrAfter(int r, int col) const
+    {
+        const Run *rs = runs.data() + runStart[r];
+        int lo = 0, hi = runCount[r];
+        while (lo < hi)
+        {
+            int mid = (lo + hi) / 2;
+            if (rs[mid].begin < col)
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+        return lo < runCount[r] ? rs[lo].begin : -1;
+    }
+
+    // Coluna final (exclusiva) do último trecho com end <= col, ou -1
+    int lastRunEndAtOrBefore(int r, int col) const
+    {
+        const Run *rs = runs.data() + runStart[r];
+        int lo = 0, hi = runCount[r];
+        while (lo < hi)
+        {
+            int mid = (lo + hi) / 2;
+            if (rs[mid].end <= col)
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+        return lo > 0 ? rs[lo - 1].end : -1;
+    }
+};
+
+class CharacterController
+{
+public:
+    float halfW, halfH;
+    bool hitX = false, hitY = false; // o último move() foi barrado em x / em y
+
+    CharacterController(float halfW = 8.0f, float halfH = 8.0f) : halfW(halfW), halfH(halfH) {}
+
+    // Move o centro (x, y) por (dx, dy), parando nas paredes. Cada eixo é resolvido
+    // separadamente, então encostar numa parede em x não impede deslizar em y.
+    void move(const TileCollisionLayer &layer, float &x, float &y, float dx, float dy)
+    {
+        float mx = layer.sweepX(x - halfW, x + halfW, y - halfH, y + halfH, dx);
+        hitX = mx != dx;
+        x += mx;
+        float my = layer.sweepY(x - halfW, x + halfW, y - halfH, y + halfH, dy);
+        hitY = my != dy;
+        y += my;
+    }
+};
@@ -0,0 +1,294 @@
+/*
+ * TileLighting - luz de tochas no tilemap, espalhada por flood fill entre os tiles
+ *
+ * Cada fonte de luz (uma tocha, o jogador carregando uma lanterna) tem um nível de 1 a
+ * LIGHT_MAX na sua célula. A luz se espalha pelos 4 vizinhos perdendo 1 nível por
+ * passo (uma BFS), atravessa os tiles livres e pára nos sólidos: a parede recebe luz,
+ * mas não a passa adiante. O nível de cada célula é o maior que chega até ela, de
+ * qualquer fonte, e cabe em 4 bits.
+ *
+ * As mudanças são incrementais, como na luz de blocos dos jogos de voxel:
+ *   - acender (ou aumentar) uma fonte só empurra a BFS de adição a partir dela;
+ *   - apagar (ou mover) uma fonte faz uma BFS de remoção: zera as células que recebiam
+ *     menos luz que a onda (dependiam dela) e guarda a borda que continua acesa por
+ *     outras fontes, que depois volta a se espalhar pela área zerada;
+ *   - um tile que muda de sólido para livre (ou o contrário) é tratado como uma remoção
+ *     na célula, e os vizinhos acesos a iluminam de novo.
+ * O custo é proporcional à área alcançada pelas luzes envolvidas (~2·nível² células),
+ * não ao tamanho do mapa.
+ *
+ * As mudanças entram na fila com addLight/moveLight/removeLight/tileChanged e são
+ * aplicadas em update(); dirtyRect() dá o retângulo alterado, para enviar à textura.
+ *
+ * Coordenadas como em TileCollisionLayer: (col, row), linha 0 no topo.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "TileCollision.h"
+
+const int LIGHT_MAX = 15;
+
+class TileLightMap
+{
+public:
+    // Tiles sólidos da camada bloqueiam a luz
+    void init(const TileCollisionLayer &blockers)
+    {
+        layer = &blockers;
+        cols = blockers.cols;
+        rows = blockers.rows;
+        levels.assign((size_t)cols * rows, 0);
+        emission.assign((size_t)cols * rows, 0);
+        lights.clear();
+        freeIds.clear();
+        addQueue.clear();
+        removeQueue.clear();
+        clearDirty();
+    }
+
+    int addLight(int col, int row, int level)
+    {
+        Light l = {col, row, (uint8_t)std::min(std::max(level, 0), LIGHT_MAX), true};
+        int id;
+        if (!freeIds.empty())
+        {
+            id = freeIds.back();
+            freeIds.pop_back();
+            lights[id] = l;
+        }
+        else
+        {
+            lights.push_back(l);
+            id = (int)lights.size() - 1;
+        }
+        raiseEmission(col, row, l.level);
+        return id;
+    }
+
+    void moveLight(int id, int col, int row)
+    {
+        Light &l = lights[id];
+        if (l.col == col && l.row == row)
+            return;
+        int oldCol = l.col, oldRow = l.row;
+        l.col = col;
+        l.row = row;
+        lowerEmission(oldCol, oldRow, l.level);
+        raiseEmission(col, row, l.level);
+    }
+
+    void setLightLevel(int id, int level)
+    {
+        Light &l = lights[id];
+        uint8_t old = l.level;
+        l.level = (uint8_t)std::min(std::max(level, 0), LIGHT_MAX);
+        if (l.level > old)
+            raiseEmission(l.col, l.row, l.level);
+        else
+            lowerEmission(l.col, l.row, old);
+    }
+
+    void removeLight(int id)
+    {
+        Light &l = lights[id];
+        l.active = false;
+        lowerEmission(l.col, l.row, l.level);
+        freeIds.push_back(id);
+    }
+
+    // A célula mudou de sólida para livre (ou o contrário) na camada de bloqueio
+    void tileChanged(int col, int row)
+    {
+        if (inside(col, row))
+            queueRemoval(col, row);
+    }
+
+    // Aplica as mudanças pendentes: primeiro as remoções, depois a luz que se espalha.
+    // Retorna quantas células foram visitadas.
+    int update()
+    {
+        int visited = 0;
+        for (size_t head = 0; head < removeQueue.size(); head++)
+        {
+            Node n = removeQueue[head];
+            visited++;
+            for (int k = 0; k < 4; k++)
+            {
+                int c = n.col + NEIGHBOR_C[k], r = n.row + NEIGHBOR_R[k];
+                if (!inside(c, r))
+                    continue;
+                uint8_t l = levels[index(c, r)];
+                if (l != 0 && l < n.level)
+                    queueRemoval(c, r); // recebia luz pela onda apagada
+                else if (l != 0 && l >= n.level)
+                    addQueue.push_back({c, r, 0}); // aceso por outra fonte: volta a espalhar
+            }
+        }
+        removeQueue.clear();
+
+        for (size_t head = 0; head < addQueue.size(); head++)
+        {
+            Node n = addQueue[head];
+            visited++;
+            size_t i = index(n.col, n.row);
+            int l = levels[i];
+            if (l <= 1 || (emission[i] == 0 && layer->solidAt(n.col, n.row)))
+                continue; // parede sem fonte: recebe luz, mas não passa
+            for (int k = 0; k < 4; k++)
+            {
+                int c = n.col + NEIGHBOR_C[k], r = n.row + NEIGHBOR_R[k];
+                if (!inside(c, r))
+                    continue;
+                uint8_t &nl = levels[index(c, r)];
+                if (nl < l - 1)
+                {
+                    nl = (uint8_t)(l - 1);
+                    touch(c, r);
+                    addQueue.push_back({c, r, 0});
+                }
+            }
+        }
+        addQueue.clear();
+        return visited;
+    }
+
+    // Refaz o mapa inteiro a partir das fontes (para conferência e comparação)
+    void rebuild()
+    {
+        std::fill(levels.begin(), levels.end(), 0);
+        addQueue.clear();
+        removeQueue.clear();
+        for (int r = 0; r < rows; r++)
+            for (int c = 0; c < cols; c++)
+            {
+                size_t i = index(c, r);
+                if (emission[i] > 0)
+                {
+                    levels[i] = emission[i];
+                    addQueue.push_back({c, r, 0});
+                }
+            }
+        dirtyC0 = dirtyR0 = 0;
+        dirtyC1 = cols - 1;
+        dirtyR1 = rows - 1;
+        update();
+    }
+
+    uint8_t level(int col, int row) const { return inside(col, row) ? levels[index(col, row)] : 0; }
+    const std::vector<uint8_t> &data() const { return levels; }
+
+    // Retângulo (inclusivo) alterado desde a última chamada; false se nada mudou
+    bool dirtyRect(int &c0, int &r0, int &c1, int &r1)
+    {
+        if (dirtyC1 < dirtyC0)
+            return false;
+        c0 = dirtyC0;
+        r0 = dirtyR0;
+        c1 = dirtyC1;
+        r1 = dirtyR1;
+        clearDirty();
+        return true;
+    }
+
+private:
+    struct Light
+    {
+        int col, row;
+        uint8_t level;
+        bool active;
+    };
+
+    struct Node
+    {
+        int col, row;
+        uint8_t level; // na remoção: o nível que a célula tinha
+    };
+
+    static constexpr int NEIGHBOR_C[4] = {1, -1, 0, 0};
+    static constexpr int NEIGHBOR_R[4] = {0, 0, 1, -1};
+
+    const TileCollisionLayer *layer = nullptr;
+    int cols = 0, rows = 0;
+    std::vector<uint8_t> levels;   // luz de cada célula, 0..LIGHT_MAX
+    std::vector<uint8_t> emission; // maior fonte em cada célula
+    std::vector<Light> lights;
+    std::vector<int> freeIds;
+    std::vector<Node> addQueue, removeQueue;
+    int dirtyC0 = 0, dirtyR0 = 0, dirtyC1 = -1, dirtyR1 = -1;
+
+    bool inside(int col, int row) const { return col >= 0 && row >= 0 && col < cols && row < rows; }
+    size_t index(int col, int row) const { return (size_t)row * cols + col; }
+
+    // Uma fonte de nível "level" chegou na célula
+    void raiseEmission(int col, int row, uint8_t level)
+    {
+        if (!inside(col, row))
+            return;
+        size_t i = index(col, row);
+        if (level <= emission[i])
+            return;
+        emission[i] = level;
+        if (level > levels[i])
+        {
+            levels[i] = level;
+            touch(col, row);
+            addQueue.push_back({col, row, 0});
+        }
+    }
+
+    // Uma fonte de nível "level" saiu da célula. Só se ela era a mais forte é preciso
+    // procurar as que sobraram ali e apagar a diferença.
+    void lowerEmission(int col, int row, uint8_t level)
+    {
+        if (!inside(col, row))
+            return;
+        size_t i = index(col, row);
+        if (level < emission[i])
+            return;
+        uint8_t e = 0;
+        for (const Light &l : lights)
+            if (l.active && l.col == col && l.row == row)
+                e = std::max(e, l.level);
+        if (e == emission[i])
+            return;
+        emission[i] = e;
+        queueRemoval(col, row);
+    }
+
+    // Zera a célula e guarda o nível antigo para a onda de remoção. Se ela mesma é
+    // uma fonte, volta acesa com a própria emissão (e espalha depois).
+    void queueRemoval(int col, int row)
+    {
+        size_t i = index(col, row);
+        removeQueue.push_back({col, row, levels[i]});
+        levels[i] = emission[i];
+        if (emission[i] > 0)
+            addQueue.push_back({col, row, 0});
+        touch(col, row);
+    }
+
+    void touch(int col, int row)
+    {
+        if (dirtyC1 < dirtyC0)
+        {
+            dirtyC0 = dirtyC1 = col;
+            dirtyR0 = dirtyR1 = row;
+            return;
+        }
+        dirtyC0 = std::min(dirtyC0, col);
+        dirtyC1 = std::max(dirtyC1, col);
+        dirtyR0 = std::min(dirtyR0, row);
+        dirtyR1 = std::max(dirtyR1, row);
+    }
+
+    void clearDirty()
+    {
+        dirtyC0 = dirtyR0 = 0;
+        dirtyC1 = dirtyR1 = -1;
+    }
+};
@@ -0,0 +1,78 @@
+/*
+ * VoxelAO - oclusão ambiente por vértice para faces de voxels
+ *
+ * Cada canto de uma face exposta olha os 3 blocos que encostam nele do lado de fora da
+ * face: os dois vizinhos laterais e o da diagonal, todos na camada logo à frente da face.
+ *
+ *        lado1  canto          (vista de frente da face, camada à frente dela)
+ *          +------+
+ *          |  *   |  <- o vértice fica no ponto comum aos 3 blocos e ao bloco da face
+ *   face   +------+ lado2
+ *
+ * O termo vai de 0 (canto fechado pelos dois lados: mais escuro) a 3 (nada em volta).
+ * Com os dois lados sólidos o canto é 0 mesmo que o bloco da diagonal seja ar, pois ele
+ * não é visível dali. O valor é calculado ao montar a malha e guardado no vértice: no
+ * desenho só há a interpolação entre os vértices, sem custo por pixel.
+ *
+ * Como o quad é dividido em 2 triângulos, a interpolação depende da diagonal escolhida:
+ * com um canto escuro numa ponta da diagonal, o escuro se espalha ao longo dela e a
+ * sombra fica torta. aoFlipQuad() escolhe a diagonal que liga os cantos mais claros.
+ */
+
+#pragma once
+
+// Termo de oclusão de um canto, a partir dos 3 blocos em volta dele
+inline int vertexAO(bool side1, bool side2, bool corner)
+{
+    if (side1 && side2)
+        return 0;
+    return 3 - (int)side1 - (int)side2 - (int)corner;
+}
+
+// Os 3 blocos em volta de um canto da face "normal" do bloco (x, y, z), mais o bloco logo
+// à frente da face. cornerOffset é a posição do canto dentro do bloco (cada eixo 0 ou 1).
+// A luz suave dos cantos (ChunkMesher) usa as mesmas posições.
+struct FaceCornerSamples
+{
+    int front[3], side1[3], side2[3], corner[3];
+};
+
+inline FaceCornerSamples faceCornerSamples(int x, int y, int z, const int normal[3], const int cornerOffset[3])
+{
+    FaceCornerSamples s;
+    // Camada à frente da face
+    int p[3] = {x + normal[0], y + normal[1], z + normal[2]};
+    for (int i = 0; i < 3; i++)
+        s.front[i] = s.side1[i] = s.side2[i] = s.corner[i] = p[i];
+    // Os dois eixos da face e o sentido do canto em cada um
+    int axis[2], dir[2], k = 0;
+    for (int i = 0; i < 3 && k < 2; i++)
+    {
+        if (normal[i] != 0)
+            continue;
+        axis[k] = i;
+        dir[k] = cornerOffset[i] ? 1 : -1;
+        k++;
+    }
+    s.side1[axis[0]] += dir[0];
+    s.side2[axis[1]] += dir[1];
+    s.corner[axis[0]] += dir[0];
+    s.corner[axis[1]] += dir[1];
+    return s;
+}
+
+// Oclusão de um canto da face; solid(x, y, z) diz se um bloco é opaco
+template <class SolidFn>
+inline int faceCornerAO(const SolidFn &solid, int x, int y, int z, const int normal[3], const int cornerOffset[3])
+{
+    FaceCornerSamples s = faceCornerSamples(x, y, z, normal, cornerOffset);
+    return vertexAO(solid(s.side1[0], s.side1[1], s.side1[2]), solid(s.side2[0], s.side2[1], s.side2[2]),
+                    solid(s.corner[0], s.corner[1], s.corner[2]));
+}
+
+// Cantos 0..3 em ordem ao redor da face. A divisão padrão usa a diagonal 0-2,
+// triângulos (0, 1, 2) e (0, 2, 3); true pede a diagonal 1-3: (1, 2, 3) e (1, 3, 0).
+inline bool aoFlipQuad(const int ao[4])
+{
+    return ao[0] + ao[2] < ao[1] + ao[3];
+}
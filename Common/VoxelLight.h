@@ -0,0 +1,239 @@
+/*
+ * VoxelLight - luz do sol e luz de blocos no VoxelWorld, espalhada por flood fill
+ *
+ * Cada bloco guarda dois níveis de 0 a 15 no mesmo byte (Chunk::light): o sol nos 4 bits
+ * altos e a luz de blocos (blocos que brilham, como o mel) nos 4 baixos. Os dois canais se
+ * espalham do mesmo jeito, pelos 6 vizinhos perdendo 1 nível por passo e só pelo ar; a
+ * diferença é que o sol no nível máximo desce sem perder nada, então toda coluna aberta
+ * para o céu fica com 15 até o primeiro bloco sólido, e a partir dela a luz entra de lado
+ * nas cavernas e debaixo das saliências.
+ *
+ * computeAll() monta tudo do zero: preenche as colunas abertas para o céu, espalha o sol
+ * só a partir das bordas dessas colunas (onde há ar sem céu ao lado) e depois a luz das
+ * fontes. Editar um bloco é incremental, como em TileLighting.h, mas em 3D e atravessando
+ * as bordas dos chunks:
+ *   - blockChanged() zera os dois canais no bloco e guarda o nível antigo numa fila de
+ *     remoção; a BFS de remoção zera os vizinhos que dependiam dele e guarda a borda que
+ *     continua acesa por outro caminho;
+ *   - update() espalha de novo a partir dessa borda (e do próprio bloco, se ele brilha) e
+ *     marca para remesh os chunks cujas malhas leem as células alteradas.
+ * O custo de uma edição depende da área de luz que muda, não do tamanho do mundo.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "VoxelWorld.h"
+
+const int VOXEL_LIGHT_MAX = 15;
+
+// Nível emitido por cada tipo de bloco (luz de blocos)
+inline int blockEmission(uint8_t type)
+{
+    return type == BLOCK_HONEY ? 14 : 0;
+}
+
+class VoxelLighting
+{
+public:
+    void init(VoxelWorld &w)
+    {
+        world = &w;
+        for (int ch = 0; ch < 2; ch++)
+        {
+            addQueue[ch].clear();
+            removeQueue[ch].clear();
+        }
+    }
+
+    // Refaz a luz do mundo inteiro. Não marca chunks: é chamada junto com a geração do
+    // terreno, que já marca todos.
+    void computeAll()
+    {
+        int sx = world->sizeX(), sy = world->sizeY(), sz = world->sizeZ();
+        markChunks = false;
+        for (int i = 0; i < world->chunkCount(); i++)
+        {
+            Chunk &c = world->chunk(i);
+            for (int k = 0; k < CHUNK_VOLUME; k++)
+                c.light[k] = 0;
+        }
+
+        // Colunas abertas para o céu; sky[x + z * sx] é o y mais baixo com sol 15
+        std::vector<int> sky((size_t)sx * sz);
+        for (int z = 0; z < sz; z++)
+            for (int x = 0; x < sx; x++)
+            {
+                int y = sy - 1;
+                while (y >= 0 && world->getBlock(x, y, z) == BLOCK_AIR)
+                {
+                    world->setLight(x, y, z, VOXEL_LIGHT_MAX << 4);
+                    y--;
+                }
+                sky[x + (size_t)z * sx] = y + 1;
+            }
+
+        // Só as células de céu com ar sem céu ao lado precisam espalhar
+        for (int z = 0; z < sz; z++)
+            for (int x = 0; x < sx; x++)
+                for (int y = sky[x + (size_t)z * sx]; y < sy; y++)
+                {
+                    bool edge = false;
+                    for (int k = 0; k < 4 && !edge; k++)
+                    {
+                        int nx = x + NEIGHBOR[k][0], nz = z + NEIGHBOR[k][2];
+                        if (nx < 0 || nz < 0 || nx >= sx || nz >= sz)
+                            continue;
+                        edge = y < sky[nx + (size_t)nz * sx] && world->getBlock(nx, y, nz) == BLOCK_AIR;
+                    }
+                    if (edge)
+                        addQueue[SUN].push_back({x, y, z, 0});
+                }
+
+        // Fontes de luz de blocos
+        for (int y = 0; y < sy; y++)
+            for (int z = 0; z < sz; z++)
+                for (int x = 0; x < sx; x++)
+                {
+                    int e = blockEmission(world->getBlock(x, y, z));
+                    if (e > 0)
+                    {
+                        set(BLOCK, x, y, z, e);
+                        addQueue[BLOCK].push_back({x, y, z, 0});
+                    }
+                }
+
+        update();
+        markChunks = true;
+    }
+
+    // O bloco (x, y, z) já foi trocado no mundo: refaz a luz em volta dele no próximo update()
+    void blockChanged(int x, int y, int z)
+    {
+        if (!world->inside(x, y, z))
+            return;
+        queueRemoval(SUN, x, y, z);
+        queueRemoval(BLOCK, x, y, z);
+    }
+
+    // Aplica as mudanças pendentes: primeiro as remoções dos dois canais, depois a luz que
+    // se espalha. Retorna quantas células foram visitadas.
+    int update()
+    {
+        int visited = 0;
+        for (int ch = 0; ch < 2; ch++)
+        {
+            std::vector<Node> &queue = removeQueue[ch];
+            for (size_t head = 0; head < queue.size(); head++)
+            {
+                Node n = queue[head];
+                visited++;
+                for (int k = 0; k < 6; k++)
+                {
+                    int x = n.x + NEIGHBOR[k][0], y = n.y + NEIGHBOR[k][1], z = n.z + NEIGHBOR[k][2];
+                    if (!world->inside(x, y, z))
+                        continue;
+                    int l = get(ch, x, y, z);
+                    if (l == 0)
+                        continue;
+                    // Abaixo de um sol 15 a coluna inteira dependia dele
+                    bool column = ch == SUN && k == DOWN && n.level == VOXEL_LIGHT_MAX && l == VOXEL_LIGHT_MAX;
+                    if (l < n.level || column)
+                        queueRemoval(ch, x, y, z);
+                    else
+                        addQueue[ch].push_back({x, y, z, 0}); // aceso por outro caminho: volta a espalhar
+                }
+            }
+            queue.clear();
+        }
+
+        for (int ch = 0; ch < 2; ch++)
+        {
+            std::vector<Node> &queue = addQueue[ch];
+            for (size_t head = 0; head < queue.size(); head++)
+            {
+                Node n = queue[head];
+                visited++;
+                int l = get(ch, n.x, n.y, n.z);
+                if (l <= 1)
+                    continue;
+                for (int k = 0; k < 6; k++)
+                {
+                    int x = n.x + NEIGHBOR[k][0], y = n.y + NEIGHBOR[k][1], z = n.z + NEIGHBOR[k][2];
+                    if (!world->inside(x, y, z) || world->getBlock(x, y, z) != BLOCK_AIR)
+                        continue;
+                    int target = ch == SUN && k == DOWN && l == VOXEL_LIGHT_MAX ? l : l - 1;
+                    if (get(ch, x, y, z) < target)
+                    {
+                        set(ch, x, y, z, target);
+                        queue.push_back({x, y, z, 0});
+                    }
+                }
+            }
+            queue.clear();
+        }
+        return visited;
+    }
+
+    int sunLight(int x, int y, int z) const { return world->getLight(x, y, z) >> 4; }
+    int blockLight(int x, int y, int z) const { return world->getLight(x, y, z) & 15; }
+
+private:
+    enum Channel
+    {
+        SUN = 0,
+        BLOCK = 1
+    };
+
+    struct Node
+    {
+        int x, y, z;
+        int level; // na remoção: o nível que a célula tinha
+    };
+
+    // Os 4 primeiros são horizontais; DOWN é o vizinho de baixo
+    static constexpr int NEIGHBOR[6][3] = {{1, 0, 0}, {-1, 0, 0}, {0, 0, 1}, {0, 0, -1}, {0, -1, 0}, {0, 1, 0}};
+    static const int DOWN = 4;
+
+    VoxelWorld *world = nullptr;
+    std::vector<Node> addQueue[2], removeQueue[2];
+    bool markChunks = true;
+
+    int get(int ch, int x, int y, int z) const
+    {
+        uint8_t v = world->getLight(x, y, z);
+        return ch == SUN ? v >> 4 : v & 15;
+    }
+
+    void set(int ch, int x, int y, int z, int level)
+    {
+        uint8_t v = world->getLight(x, y, z);
+        v = ch == SUN ? (uint8_t)((v & 0x0F) | (level << 4)) : (uint8_t)((v & 0xF0) | level);
+        world->setLight(x, y, z, v);
+        if (markChunks)
+            world->markDirtyAround(x, y, z); // a luz suave dos cantos lê os 26 vizinhos
+    }
+
+    // Nível próprio da célula, que não depende de vizinhos: o sol entra pela camada de
+    // cima do mundo; a luz de blocos vem do tipo do bloco
+    int emission(int ch, int x, int y, int z) const
+    {
+        uint8_t type = world->getBlock(x, y, z);
+        if (ch == BLOCK)
+            return blockEmission(type);
+        return type == BLOCK_AIR && y == world->sizeY() - 1 ? VOXEL_LIGHT_MAX : 0;
+    }
+
+    // Zera a célula e guarda o nível antigo para a onda de remoção. Se ela mesma é uma
+    // fonte, volta acesa com a própria emissão (e espalha depois).
+    void queueRemoval(int ch, int x, int y, int z)
+    {
+        removeQueue[ch].push_back({x, y, z, get(ch, x, y, z)});
+        int e = emission(ch, x, y, z);
+        set(ch, x, y, z, e);
+        if (e > 0)
+            addQueue[ch].push_back({x, y, z, 0});
+    }
+};
@@ -0,0 +1,235 @@
+/*
+ * VoxelWorld - mundo de voxels dividido em chunks de 16x16x16 blocos
+ *
+ * Cada bloco é um byte (0 = ar, demais valores = tipo do bloco). Os chunks ficam num
+ * vetor contíguo, indexados por (cx, cy, cz). Alterar um bloco marca o chunk como
+ * "sujo" (e também os vizinhos que encostam no bloco, inclusive pelas arestas e quinas,
+ * pois as faces visíveis e a oclusão ambiente deles dependem do bloco alterado); o
+ * renderizador refaz a malha só desses chunks.
+ *
+ * Cada bloco também tem um byte de luz (sol nos 4 bits altos, blocos nos 4 baixos),
+ * mantido pelo VoxelLighting (Common/VoxelLight.h) e lido pelo ChunkMesher.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cmath>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+const int CHUNK_SIZE = 16;
+const int CHUNK_AREA = CHUNK_SIZE * CHUNK_SIZE;
+const int CHUNK_VOLUME = CHUNK_SIZE * CHUNK_SIZE * CHUNK_SIZE;
+
+// Tipos de bloco. O valor - 1 é a camada na textura array de blocos.
+enum BlockType
+{
+    BLOCK_AIR = 0,
+    BLOCK_GRASS,
+    BLOCK_DIRT,
+    BLOCK_STONE,
+    BLOCK_MOSS,
+    BLOCK_GOLD,
+    BLOCK_SPONGE,
+    BLOCK_HONEY,
+    BLOCK_ICE,
+    BLOCK_LOOM,
+    BLOCK_ROOTS,
+    N_BLOCK_TYPES
+};
+
+struct Chunk
+{
+    uint8_t blocks[CHUNK_VOLUME]; // índice: x + z * 16 + y * 256 (coordenadas locais)
+    uint8_t light[CHUNK_VOLUME];  // mesmo índice: sol << 4 | luz de blocos
+    int solidCount;               // chunks só de ar não geram malha
+    bool dirty;
+};
+
+inline int blockIndex(int x, int y, int z)
+{
+    return x + z * CHUNK_SIZE + y * CHUNK_AREA;
+}
+
+class VoxelWorld
+{
+public:
+    int chunksX, chunksY, chunksZ;
+
+    VoxelWorld() : chunksX(0), chunksY(0), chunksZ(0) {}
+
+    void init(int cx, int cy, int cz)
+    {
+        chunksX = cx;
+        chunksY = cy;
+        chunksZ = cz;
+        chunks.assign((size_t)cx * cy * cz, Chunk());
+        for (Chunk &c : chunks)
+        {
+            for (int i = 0; i < CHUNK_VOLUME; i++)
+            {
+                c.blocks[i] = BLOCK_AIR;
+                c.light[i] = 0;
+            }
+            c.solidCount = 0;
+            c.dirty = false;
+        }
+        dirtyList.clear();
+    }
+
+    int chunkCount() const { return (int)chunks.size(); }
+    int sizeX() const { return chunksX * CHUNK_SIZE; }
+    int sizeY() const { return chunksY * CHUNK_SIZE; }
+    int sizeZ() const { return chunksZ * CHUNK_SIZE; }
+
+    int chunkIndex(int cx, int cy, int cz) const
+    {
+        return cx + cz * chunksX + cy * chunksX * chunksZ;
+    }
+
+    glm::ivec3 chunkCoord(int index) const
+    {
+        int cx = index % chunksX;
+        int cz = (index / chunksX) % chunksZ;
+        int cy = index / (chunksX * chunksZ);
+        return glm::ivec3(cx, cy, cz);
+    }
+
+    Chunk &chunk(int index) { return chunks[index]; }
+    const Chunk &chunk(int index) const { return chunks[index]; }
+
+    bool inside(int x, int y, int z) const
+    {
+        return x >= 0 && y >= 0 && z >= 0 && x < sizeX() && y < sizeY() && z < sizeZ();
+    }
+
+    // Fora do mundo é sempre ar
+    uint8_t getBlock(int x, int y, int z) const
+    {
+        if (!inside(x, y, z))
+            return BLOCK_AIR;
+        const Chunk &c = chunks[chunkIndex(x / CHUNK_SIZE, y / CHUNK_SIZE, z / CHUNK_SIZE)];
+        return c.blocks[blockIndex(x % CHUNK_SIZE, y % CHUNK_SIZE, z % CHUNK_SIZE)];
+    }
+
+    // Altera um bloco e marca para remesh o chunk dele e os vizinhos que encostam no bloco
+    // (por face, aresta ou quina: a oclusão dos cantos olha os 26 blocos em volta)
+    void setBlock(int x, int y, int z, uint8_t type)
+    {
+        if (!inside(x, y, z))
+            return;
+        int cx = x / CHUNK_SIZE, cy = y / CHUNK_SIZE, cz = z / CHUNK_SIZE;
+        int lx = x % CHUNK_SIZE, ly = y % CHUNK_SIZE, lz = z % CHUNK_SIZE;
+        Chunk &c = chunks[chunkIndex(cx, cy, cz)];
+        uint8_t &b = c.blocks[blockIndex(lx, ly, lz)];
+        if (b == type)
+            return;
+        if (b == BLOCK_AIR)
+            c.solidCount++;
+        if (type == BLOCK_AIR)
+            c.solidCount--;
+        b = type;
+        markDirtyAround(x, y, z);
+    }
+
+    // Fora do mundo é céu aberto: sol máximo, sem luz de blocos
+    uint8_t getLight(int x, int y, int z) const
+    {
+        if (!inside(x, y, z))
+            return 0xF0;
+        const Chunk &c = chunks[chunkIndex(x / CHUNK_SIZE, y / CHUNK_SIZE, z / CHUNK_SIZE)];
+        return c.light[blockIndex(x % CHUNK_SIZE, y % CHUNK_SIZE, z % CHUNK_SIZE)];
+    }
+
+    // Escreve a luz sem marcar nada: quem espalha a luz decide o que precisa de remesh
+    void setLight(int x, int y, int z, uint8_t value)
+    {
+        Chunk &c = chunks[chunkIndex(x / CHUNK_SIZE, y / CHUNK_SIZE, z / CHUNK_SIZE)];
+        c.light[blockIndex(x % CHUNK_SIZE, y % CHUNK_SIZE, z % CHUNK_SIZE)] = value;
+    }
+
+    // Marca para remesh os chunks cujas malhas dependem do bloco (x, y, z): o dele e os
+    // que encostam nele por face, aresta ou quina
+    void markDirtyAround(int x, int y, int z)
+    {
+        int cx = x / CHUNK_SIZE, cy = y / CHUNK_SIZE, cz = z / CHUNK_SIZE;
+        int lx = x % CHUNK_SIZE, ly = y % CHUNK_SIZE, lz = z % CHUNK_SIZE;
+        int x0 = lx == 0 ? -1 : 0, x1 = lx == CHUNK_SIZE - 1 ? 1 : 0;
+        int y0 = ly == 0 ? -1 : 0, y1 = ly == CHUNK_SIZE - 1 ? 1 : 0;
+        int z0 = lz == 0 ? -1 : 0, z1 = lz == CHUNK_SIZE - 1 ? 1 : 0;
+        for (int dy = y0; dy <= y1; dy++)
+            for (int dz = z0; dz <= z1; dz++)
+                for (int dx = x0; dx <= x1; dx++)
+                    markDirty(cx + dx, cy + dy, cz + dz);
+    }
+
+    void markDirty(int cx, int cy, int cz)
+    {
+        if (cx < 0 || cy < 0 || cz < 0 || cx >= chunksX || cy >= chunksY || cz >= chunksZ)
+            return;
+        int index = chunkIndex(cx, cy, cz);
+        if (!chunks[index].dirty)
+        {
+            chunks[index].dirty = true;
+            dirtyList.push_back(index);
+        }
+    }
+
+    // Devolve (e limpa) a lista de chunks que precisam de nova malha
+    std::vector<int> takeDirty()
+    {
+        std::vector<int> out;
+        out.swap(dirtyList);
+        for (int index : out)
+            chunks[index].dirty = false;
+        return out;
+    }
+
+    // Terreno simples por mapa de alturas: pedra, terra e grama no topo, com alguns minérios
+    void generateTerrain()
+    {
+        for (int x = 0; x < sizeX(); x++)
+        {
+            for (int z = 0; z < sizeZ(); z++)
+            {
+                float h = sizeY() * 0.3f + 10.0f * sinf(x * 0.05f) * cosf(z * 0.04f) + 5.0f * sinf((x + z) * 0.11f);
+                int height = (int)h;
+                if (height >= sizeY())
+                    height = sizeY() - 1;
+                for (int y = 0; y <= height; y++)
+                {
+                    uint8_t type = BLOCK_STONE;
+                    if (y == height)
+                        type = BLOCK_GRASS;
+                    else if (y > height - 4)
+                        type = BLOCK_DIRT;
+                    else if ((((unsigned)x * 73856093u) ^ ((unsigned)y * 19349663u) ^ ((unsigned)z * 83492791u)) % 97u == 0)
+                        type = BLOCK_GOLD;
+                    rawSet(x, y, z, type);
+                }
+            }
+        }
+        dirtyList.clear();
+        for (int i = 0; i < chunkCount(); i++)
+        {
+            chunks[i].dirty = true;
+            dirtyList.push_back(i);
+        }
+    }
+
+private:
+    // Escrita sem marcar vizinhos (usada na geração, que já marca tudo no final)
+    void rawSet(int x, int y, int z, uint8_t type)
+    {
+        Chunk &c = chunks[chunkIndex(x / CHUNK_SIZE, y / CHUNK_SIZE, z / CHUNK_SIZE)];
+        uint8_t &b = c.blocks[blockIndex(x % CHUNK_SIZE, y % CHUNK_SIZE, z % CHUNK_SIZE)];
+        if (b == BLOCK_AIR && type != BLOCK_AIR)
+            c.solidCount++;
+        b = type;
+    }
+
+    std::vector<Chunk> chunks;
+    std::vector<int> dirtyList;
+};
@@ -0,0 +1,40 @@
+/*
+ * BenchCommon - medição de tempo e conferências usadas por vários benchmarks
+ *
+ * Cada benchmark mede trechos com high_resolution_clock e confere resultados comparando
+ * duas versões de uma grade célula por célula; as funções ficam aqui em vez de copiadas
+ * em cada arquivo.
+ */
+
+#pragma once
+
+#include <chrono>
+
+typedef std::chrono::high_resolution_clock::time_point BenchTime;
+
+// Tempo desde t0, em segundos, milissegundos e microssegundos
+inline double secondsSince(BenchTime t0)
+{
+    return std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - t0).count();
+}
+
+inline double msSince(BenchTime t0)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - t0).count();
+}
+
+inline double usSince(BenchTime t0)
+{
+    return std::chrono::duration<double, std::micro>(std::chrono::high_resolution_clock::now() - t0).count();
+}
+
+// same(c, r) vale para todas as células de uma grade cols x rows?
+template <typename F>
+bool everyCell(int cols, int rows, F same)
+{
+    for (int r = 0; r < rows; r++)
+        for (int c = 0; c < cols; c++)
+            if (!same(c, r))
+                return false;
+    return true;
+}
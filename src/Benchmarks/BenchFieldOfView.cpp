@@ -0,0 +1,164 @@
+/*
+ * BenchFieldOfView - mede o campo de visão e a névoa de guerra (Common/FieldOfView.h)
+ *
+ * Num mapa de 2048x2048 tiles com 15% de paredes espalhadas e salas fechadas, espalha
+ * 1000 observadores com raio 12 que andam ao acaso (cada um troca de célula de vez em
+ * quando) enquanto alguns tiles abrem e fecham. Mede o custo de cada update() e compara
+ * com recalcular todos os observadores e o mapa inteiro do zero.
+ *
+ * Confere que o mapa visível mantido incrementalmente é igual ao de um FogOfWar montado
+ * do zero, que "explored" contém o visível e que, sem paredes, o observador vê todo o
+ * círculo do seu raio. Não precisa de OpenGL.
+ */
+
+#include <iostream>
+#include <vector>
+#include <random>
+#include <chrono>
+
+#include "FieldOfView.h"
+#include "BenchCommon.h"
+
+using namespace std;
+
+const int N = 2048;
+const int N_VIEWERS = 1000;
+const int RADIUS = 12;
+
+// Tile 0 = chão, tile 1 = parede
+const uint8_t TILE_FLAGS[2] = {0, TILE_SOLID};
+
+void makeMap(vector<int> &tiles, mt19937 &rng)
+{
+	tiles.assign((size_t)N * N, 0);
+	uniform_real_distribution<float> u(0.0f, 1.0f);
+	for (size_t i = 0; i < tiles.size(); i++)
+		tiles[i] = u(rng) < 0.15f ? 1 : 0;
+
+	// Salas de 10x10 com uma porta
+	uniform_int_distribution<int> pos(0, N - 12);
+	for (int k = 0; k < 4000; k++)
+	{
+		int c0 = pos(rng), r0 = pos(rng);
+		for (int i = 0; i <= 10; i++)
+		{
+			tiles[(size_t)r0 * N + c0 + i] = tiles[(size_t)(r0 + 10) * N + c0 + i] = 1;
+			tiles[(size_t)(r0 + i) * N + c0] = tiles[(size_t)(r0 + i) * N + c0 + 10] = 1;
+		}
+		tiles[(size_t)(r0 + 5) * N + c0] = 0;
+	}
+}
+
+bool sameVisible(const FogOfWar &a, const FogOfWar &b)
+{
+	return everyCell(N, N, [&](int c, int r) { return a.visible(c, r) == b.visible(c, r); });
+}
+
+int main()
+{
+	mt19937 rng(47);
+	bool correto = true;
+
+	vector<int> tiles;
+	makeMap(tiles, rng);
+	TileCollisionLayer layer;
+	layer.build(tiles.data(), N, N, TILE_FLAGS, 2, 1.0f, 1.0f, 0.0f, (float)N);
+
+	FogOfWar fog;
+	fog.init(layer);
+	uniform_int_distribution<int> cell(0, N - 1);
+	vector<int> col(N_VIEWERS), row(N_VIEWERS), id(N_VIEWERS);
+	for (int i = 0; i < N_VIEWERS; i++)
+	{
+		col[i] = cell(rng);
+		row[i] = cell(rng);
+		id[i] = fog.addViewer(col[i], row[i], RADIUS);
+	}
+	auto t0 = chrono::high_resolution_clock::now();
+	fog.update();
+	double firstMs = msSince(t0);
+
+	// Recalcular tudo do zero: todos os observadores e o mapa inteiro
+	const int FULL_REPS = 3;
+	t0 = chrono::high_resolution_clock::now();
+	for (int k = 0; k < FULL_REPS; k++)
+	{
+		FogOfWar full;
+		full.init(layer);
+		for (int i = 0; i < N_VIEWERS; i++)
+			full.addViewer(col[i], row[i], RADIUS);
+		full.update();
+	}
+	double fullMs = msSince(t0) / FULL_REPS;
+
+	// Passos: cada observador dá um passo com chance de 1/8; alguns tiles mudam
+	const int N_TICKS = 300, CHANGES_PER_TICK = 4;
+	uniform_int_distribution<int> step(-1, 1), chance(0, 7);
+	double updateMs = 0.0;
+	long recomputed = 0;
+	for (int t = 0; t < N_TICKS; t++)
+	{
+		for (int i = 0; i < N_VIEWERS; i++)
+		{
+			if (chance(rng) != 0)
+				continue;
+			int c = col[i] + step(rng), r = row[i] + step(rng);
+			if (layer.solidAt(c, r))
+				continue;
+			col[i] = c;
+			row[i] = r;
+			fog.moveViewer(id[i], c, r);
+		}
+		for (int k = 0; k < CHANGES_PER_TICK; k++)
+		{
+			int c = cell(rng), r = cell(rng);
+			int &tile = tiles[(size_t)r * N + c];
+			tile = 1 - tile;
+			layer.setTile(c, r, tile);
+			fog.tileChanged(c, r);
+		}
+		auto t1 = chrono::high_resolution_clock::now();
+		recomputed += fog.update();
+		updateMs += msSince(t1);
+	}
+
+	cout << "Mapa " << N << "x" << N << ", " << N_VIEWERS << " observadores com raio " << RADIUS << endl;
+	cout << "  Primeiro update (todos): " << firstMs << " ms; tudo do zero: " << fullMs << " ms" << endl;
+	cout << "  Passo: " << updateMs / N_TICKS << " ms por update (" << recomputed / N_TICKS
+		 << " observadores recalculados em media), " << fullMs / (updateMs / N_TICKS) << "x mais rapido" << endl;
+
+	// O mapa incremental tem que ser igual a um montado do zero
+	FogOfWar fresh;
+	fresh.init(layer);
+	for (int i = 0; i < N_VIEWERS; i++)
+		fresh.addViewer(col[i], row[i], RADIUS);
+	fresh.update();
+	if (!sameVisible(fog, fresh))
+		correto = false;
+	for (int r = 0; r < N && correto; r++)
+		for (int c = 0; c < N; c++)
+			if (fog.visible(c, r) && !fog.explored(c, r))
+			{
+				correto = false;
+				break;
+			}
+
+	// Sem paredes por perto, o círculo inteiro é visível e nada fora dele
+	vector<int> open((size_t)64 * 64, 0);
+	TileCollisionLayer openLayer;
+	openLayer.build(open.data(), 64, 64, TILE_FLAGS, 2, 1.0f, 1.0f, 0.0f, 64.0f);
+	FogOfWar openFog;
+	openFog.init(openLayer);
+	openFog.addViewer(32, 32, RADIUS);
+	openFog.update();
+	for (int r = 0; r < 64; r++)
+		for (int c = 0; c < 64; c++)
+		{
+			int dc = c - 32, dr = r - 32;
+			if (openFog.visible(c, r) != (dc * dc + dr * dr <= RADIUS * RADIUS + RADIUS))
+				correto = false;
+		}
+
+	cout << "Visibilidade " << (correto ? "correta" : "INCORRETA") << endl;
+	return correto ? 0 : 1;
+}
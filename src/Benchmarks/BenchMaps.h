@@ -0,0 +1,48 @@
+/*
+ * BenchMaps - mapa de obstáculos compartilhado pelos benchmarks de busca de caminhos
+ *
+ * BenchPathfinding e BenchFlowField medem sobre o mesmo tipo de mapa: 20% de células
+ * fechadas ao acaso e 60 paredes longas com passagens de 4 tiles a cada 80, que obrigam
+ * desvios grandes. Com a mesma semente, os dois geram exatamente o mesmo mapa.
+ */
+
+#pragma once
+
+#include <random>
+
+#include "Pathfinding.h"
+
+const float BENCH_MAP_DENSITY = 0.20f;
+
+inline void makeObstacleMap(PathGrid &grid, int n, std::mt19937 &rng)
+{
+    grid.resize(n, n);
+    std::uniform_real_distribution<float> u(0.0f, 1.0f);
+    for (int r = 0; r < n; r++)
+        for (int c = 0; c < n; c++)
+            if (u(rng) < BENCH_MAP_DENSITY)
+                grid.setBlocked(c, r, true);
+
+    // Paredes longas com poucas passagens
+    std::uniform_int_distribution<int> pos(0, n - 1), len(100, 400);
+    for (int w = 0; w < 60; w++)
+    {
+        int c = pos(rng), r = pos(rng), l = len(rng);
+        bool vertical = w % 2 == 0;
+        for (int i = 0; i < l; i++)
+            if (i % 80 >= 4) // passagem de 4 tiles a cada 80
+                grid.setBlocked(vertical ? c : c + i, vertical ? r + i : r, true);
+    }
+}
+
+// Célula aberta sorteada
+inline GridPoint randomFree(const PathGrid &grid, std::mt19937 &rng)
+{
+    std::uniform_int_distribution<int> col(0, grid.cols - 1), row(0, grid.rows - 1);
+    GridPoint p;
+    do
+    {
+        p = {col(rng), row(rng)};
+    } while (!grid.walkable(p.col, p.row));
+    return p;
+}
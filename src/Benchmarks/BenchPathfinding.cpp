@@ -0,0 +1,198 @@
+/*
+ * BenchPathfinding - mede a busca de caminhos sobre tilemaps (Common/Pathfinding.h)
+ *
+ * Num mapa de 1024x1024 tiles com 20% de obstáculos espalhados e algumas paredes longas
+ * (com passagens), sorteia pares início/destino e mede consultas por segundo do A*
+ * simples, do Jump Point Search e do HPA* (clusters de 16x16), além do tempo para montar
+ * a hierarquia e para repará-la quando um tile muda.
+ *
+ * Depois simula 500 agentes andando pelos seus caminhos enquanto tiles são trocados: só
+ * quem tem a célula alterada no resto do caminho pede uma rota nova.
+ *
+ * Confere que o JPS acha o mesmo custo do A*, que todo caminho devolvido é válido (passos
+ * vizinhos, sem cortar quinas) e que o HPA* reparado dá os mesmos custos de um montado do
+ * zero. Não precisa de OpenGL.
+ */
+
+#include <iostream>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <cmath>
+
+#include "Pathfinding.h"
+#include "BenchCommon.h"
+#include "BenchMaps.h"
+
+using namespace std;
+
+const int N = 1024;
+
+bool validPath(const PathGrid &grid, const vector<GridPoint> &path, GridPoint start, GridPoint goal)
+{
+	if (path.empty() || path.front() != start || path.back() != goal)
+		return false;
+	for (size_t i = 1; i < path.size(); i++)
+	{
+		int dc = path[i].col - path[i - 1].col, dr = path[i].row - path[i - 1].row;
+		if (abs(dc) > 1 || abs(dr) > 1 || (dc == 0 && dr == 0))
+			return false;
+		if (!grid.canStep(path[i - 1].col, path[i - 1].row, dc, dr))
+			return false;
+	}
+	return true;
+}
+
+float pathCost(const vector<GridPoint> &path)
+{
+	float c = 0.0f;
+	for (size_t i = 1; i < path.size(); i++)
+		c += octileDistance(path[i].col - path[i - 1].col, path[i].row - path[i - 1].row);
+	return c;
+}
+
+int main()
+{
+	mt19937 rng(45);
+	bool correto = true;
+
+	PathGrid grid;
+	makeObstacleMap(grid, N, rng);
+	GridAStar astar(grid);
+	JumpPointSearch jps(grid);
+
+	// Pares com caminho (no componente principal), decididos pelo A*
+	const int N_PAIRS = 200;
+	vector<GridPoint> starts, goals;
+	vector<float> optimal;
+	vector<GridPoint> path;
+	double astarS = 0.0;
+	long astarExpanded = 0;
+	while ((int)starts.size() < N_PAIRS)
+	{
+		GridPoint s = randomFree(grid, rng), g = randomFree(grid, rng);
+		float cost;
+		auto t0 = chrono::high_resolution_clock::now();
+		bool found = astar.findPath(s, g, path, &cost);
+		astarS += secondsSince(t0);
+		astarExpanded += astar.expanded();
+		if (!found)
+			continue;
+		starts.push_back(s);
+		goals.push_back(g);
+		optimal.push_back(cost);
+	}
+
+	double jpsS = 0.0;
+	long jpsExpanded = 0;
+	for (int i = 0; i < N_PAIRS; i++)
+	{
+		float cost = 0.0f;
+		auto t0 = chrono::high_resolution_clock::now();
+		bool found = jps.findPath(starts[i], goals[i], path, &cost);
+		jpsS += secondsSince(t0);
+		jpsExpanded += jps.expanded();
+		if (!found || fabsf(cost - optimal[i]) > 1e-3f * optimal[i] || !validPath(grid, path, starts[i], goals[i]) ||
+			fabsf(pathCost(path) - cost) > 1e-3f * cost)
+			correto = false;
+	}
+
+	HierarchicalPathfinder hpa(grid, 16);
+	auto tb = chrono::high_resolution_clock::now();
+	hpa.build();
+	double buildS = secondsSince(tb);
+
+	double hpaS = 0.0;
+	long hpaExpanded = 0;
+	double ratio = 0.0;
+	for (int i = 0; i < N_PAIRS; i++)
+	{
+		float cost = 0.0f;
+		auto t0 = chrono::high_resolution_clock::now();
+		bool found = hpa.findPath(starts[i], goals[i], path, &cost);
+		hpaS += secondsSince(t0);
+		hpaExpanded += hpa.expanded();
+		if (!found || cost < optimal[i] - 1e-3f * optimal[i] || !validPath(grid, path, starts[i], goals[i]) ||
+			fabsf(pathCost(path) - cost) > 1e-3f * cost)
+			correto = false;
+		ratio += optimal[i] > 0.0f ? cost / optimal[i] : 1.0f;
+	}
+
+	cout << "Mapa " << N << "x" << N << ", " << N_PAIRS << " consultas" << endl;
+	cout << "  A*:   " << N_PAIRS / astarS << " consultas/s (" << astarExpanded / N_PAIRS << " nos expandidos)" << endl;
+	cout << "  JPS:  " << N_PAIRS / jpsS << " consultas/s (" << jpsExpanded / N_PAIRS << " nos expandidos)" << endl;
+	cout << "  HPA*: " << N_PAIRS / hpaS << " consultas/s (" << hpaExpanded / N_PAIRS << " nos abstratos expandidos, "
+		 << "custo " << ratio / N_PAIRS << "x o otimo)" << endl;
+	cout << "  HPA*: hierarquia montada em " << buildS * 1000.0 << " ms (" << hpa.nodeCount() << " nos)" << endl;
+
+	// Agentes: cada um segue o seu caminho; tiles mudam no meio e só os caminhos afetados são refeitos
+	const int N_AGENTS = 500, N_TICKS = 200, CHANGES_PER_TICK = 5;
+	vector<vector<GridPoint>> paths(N_AGENTS);
+	vector<size_t> step(N_AGENTS, 0);
+	vector<GridPoint> goal(N_AGENTS);
+	for (int a = 0; a < N_AGENTS; a++)
+	{
+		GridPoint s = randomFree(grid, rng);
+		goal[a] = randomFree(grid, rng);
+		hpa.findPath(s, goal[a], paths[a]);
+	}
+
+	uniform_int_distribution<int> cell(0, N - 1);
+	double repairS = 0.0, replanS = 0.0;
+	int repairs = 0, replans = 0;
+	for (int t = 0; t < N_TICKS; t++)
+	{
+		for (int k = 0; k < CHANGES_PER_TICK; k++)
+		{
+			int c = cell(rng), r = cell(rng);
+			bool block = grid.walkable(c, r); // alterna: fecha tiles livres, abre paredes
+			auto t0 = chrono::high_resolution_clock::now();
+			hpa.setBlocked(c, r, block);
+			repairS += secondsSince(t0);
+			repairs++;
+			if (!block)
+				continue; // abrir um tile não invalida caminho nenhum
+			for (int a = 0; a < N_AGENTS; a++)
+			{
+				vector<GridPoint> &p = paths[a];
+				bool hit = false;
+				for (size_t i = step[a]; i < p.size() && !hit; i++)
+					hit = p[i].col == c && p[i].row == r;
+				if (!hit)
+					continue;
+				GridPoint here = p[step[a]];
+				if (!grid.walkable(here.col, here.row)) // o tile fechou em cima do agente
+					here = randomFree(grid, rng);
+				auto t1 = chrono::high_resolution_clock::now();
+				hpa.findPath(here, goal[a], p);
+				replanS += secondsSince(t1);
+				step[a] = 0;
+				replans++;
+			}
+		}
+		for (int a = 0; a < N_AGENTS; a++)
+			if (step[a] + 1 < paths[a].size())
+				step[a]++;
+	}
+	cout << "  Reparo: " << repairS * 1e6 / repairs << " us por tile trocado; " << replans << " replanejamentos de "
+		 << N_AGENTS << " agentes em " << N_TICKS << " passos (" << (replans ? replanS * 1000.0 / replans : 0.0)
+		 << " ms cada)" << endl;
+
+	// A hierarquia reparada tem que responder igual a uma montada do zero
+	HierarchicalPathfinder fresh(grid, 16);
+	fresh.build();
+	for (int i = 0; i < 100; i++)
+	{
+		GridPoint s = randomFree(grid, rng), g = randomFree(grid, rng);
+		float c1 = -1.0f, c2 = -1.0f;
+		bool f1 = hpa.findPath(s, g, path, &c1);
+		if (f1 && !validPath(grid, path, s, g))
+			correto = false;
+		bool f2 = fresh.findPath(s, g, path, &c2);
+		if (f1 != f2 || (f1 && fabsf(c1 - c2) > 1e-3f * c2))
+			correto = false;
+	}
+
+	cout << "Caminhos " << (correto ? "corretos" : "INCORRETOS") << endl;
+	return correto ? 0 : 1;
+}
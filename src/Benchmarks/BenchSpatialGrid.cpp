@@ -0,0 +1,161 @@
+/*
+ * BenchSpatialGrid - mede a grade espacial (Common/SpatialGrid.h)
+ *
+ * Para 25k, 50k, 100k e 200k entidades andando num mundo de 4096 x 4096 pixels, mede o
+ * custo da atualização incremental por passo (mover + update na grade). Se a
+ * atualização for O(n), o tempo por entidade fica praticamente constante entre as linhas.
+ * Com 100k entidades, mede também consultas de raio, de vizinho mais próximo e a fase
+ * ampla de colisão (pares sobrepostos), conferindo amostras contra a força bruta.
+ * Não precisa de OpenGL.
+ */
+
+#include <iostream>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <cmath>
+
+#include "SpatialGrid.h"
+#include "BenchCommon.h"
+
+using namespace std;
+
+const float WORLD = 4096.0f;
+const float CELL = 32.0f;
+const float HALF = 6.0f; // meia-largura das entidades
+const int N_TICKS = 60;
+const int N_QUERIES = 2000;
+
+struct World
+{
+	vector<float> x, y, vx, vy;
+};
+
+World spawn(int n, mt19937 &rng)
+{
+	uniform_real_distribution<float> pos(0.0f, WORLD), vel(-120.0f, 120.0f);
+	World w;
+	for (int i = 0; i < n; i++)
+	{
+		w.x.push_back(pos(rng));
+		w.y.push_back(pos(rng));
+		w.vx.push_back(vel(rng));
+		w.vy.push_back(vel(rng));
+	}
+	return w;
+}
+
+// Um passo: anda com rebote nas bordas e atualiza a grade
+void step(World &w, SpatialGrid &grid, float dt)
+{
+	int n = (int)w.x.size();
+	for (int i = 0; i < n; i++)
+	{
+		w.x[i] += w.vx[i] * dt;
+		w.y[i] += w.vy[i] * dt;
+		if (w.x[i] < 0.0f || w.x[i] > WORLD)
+			w.vx[i] = -w.vx[i];
+		if (w.y[i] < 0.0f || w.y[i] > WORLD)
+			w.vy[i] = -w.vy[i];
+		grid.update(i, w.x[i], w.y[i]);
+	}
+}
+
+int main()
+{
+	mt19937 rng(7);
+	bool correto = true;
+
+	cout << "Atualizacao incremental (" << N_TICKS << " passos de 1/60 s)" << endl;
+	const int sizes[] = {25000, 50000, 100000, 200000};
+	for (int n : sizes)
+	{
+		World w = spawn(n, rng);
+		SpatialGrid grid(CELL);
+		auto t0 = chrono::high_resolution_clock::now();
+		for (int i = 0; i < n; i++)
+			grid.insert(i, w.x[i], w.y[i], HALF, HALF);
+		double insertMs = msSince(t0);
+
+		t0 = chrono::high_resolution_clock::now();
+		for (int t = 0; t < N_TICKS; t++)
+			step(w, grid, 1.0f / 60.0f);
+		double tickMs = msSince(t0) / N_TICKS;
+
+		cout << "  " << n << " entidades: insercao " << insertMs << " ms, passo " << tickMs << " ms ("
+			 << tickMs * 1e6 / n << " ns/entidade)" << endl;
+	}
+
+	// Consultas com 100k entidades
+	const int N = 100000;
+	World w = spawn(N, rng);
+	SpatialGrid grid(CELL);
+	for (int i = 0; i < N; i++)
+		grid.insert(i, w.x[i], w.y[i], HALF, HALF);
+
+	uniform_real_distribution<float> pos(0.0f, WORLD);
+	vector<float> qx(N_QUERIES), qy(N_QUERIES);
+	for (int q = 0; q < N_QUERIES; q++)
+	{
+		qx[q] = pos(rng);
+		qy[q] = pos(rng);
+	}
+
+	const float R = 64.0f;
+	long long found = 0;
+	auto t0 = chrono::high_resolution_clock::now();
+	for (int q = 0; q < N_QUERIES; q++)
+		grid.queryRadius(qx[q], qy[q], R, [&](int) { found++; });
+	double radiusUs = msSince(t0) * 1000.0 / N_QUERIES;
+
+	vector<int> nearestIds(N_QUERIES);
+	t0 = chrono::high_resolution_clock::now();
+	for (int q = 0; q < N_QUERIES; q++)
+		nearestIds[q] = grid.nearest(qx[q], qy[q], 512.0f);
+	double nearestUs = msSince(t0) * 1000.0 / N_QUERIES;
+
+	// Fase ampla: cada par sobreposto contado uma vez (id menor primeiro)
+	long long pairs = 0;
+	t0 = chrono::high_resolution_clock::now();
+	for (int i = 0; i < N; i++)
+	{
+		grid.queryRect(w.x[i] - HALF, w.y[i] - HALF, w.x[i] + HALF, w.y[i] + HALF, [&](int j) {
+			if (j > i)
+				pairs++;
+		});
+	}
+	double pairsMs = msSince(t0);
+
+	// Confere as primeiras consultas contra a força bruta
+	for (int q = 0; q < 100 && correto; q++)
+	{
+		long long brute = 0, grade = 0;
+		int bruteNearest = -1;
+		float best = 512.0f * 512.0f;
+		for (int i = 0; i < N; i++)
+		{
+			float dx = fabsf(qx[q] - w.x[i]) - HALF, dy = fabsf(qy[q] - w.y[i]) - HALF;
+			dx = dx > 0.0f ? dx : 0.0f;
+			dy = dy > 0.0f ? dy : 0.0f;
+			if (dx * dx + dy * dy <= R * R)
+				brute++;
+			float ex = w.x[i] - qx[q], ey = w.y[i] - qy[q];
+			if (ex * ex + ey * ey <= best)
+			{
+				best = ex * ex + ey * ey;
+				bruteNearest = i;
+			}
+		}
+		grid.queryRadius(qx[q], qy[q], R, [&](int) { grade++; });
+		if (brute != grade || bruteNearest != nearestIds[q])
+			correto = false;
+	}
+
+	cout << "Consultas com " << N << " entidades:" << endl;
+	cout << "  raio " << R << ": " << radiusUs << " us/consulta (" << (double)found / N_QUERIES << " encontradas em media)" << endl;
+	cout << "  mais proximo: " << nearestUs << " us/consulta" << endl;
+	cout << "  pares sobrepostos: " << pairs << " em " << pairsMs << " ms" << endl;
+	cout << "Consultas " << (correto ? "corretas" : "INCORRETAS") << " (comparadas com forca bruta)" << endl;
+
+	return correto ? 0 : 1;
+}
@@ -0,0 +1,132 @@
+/*
+ * BenchSpriteSoA - mede a atualização de 1M sprites animados (Common/SpriteEntities.h)
+ *
+ * Compara, para o mesmo passo de simulação (movimento com rebote + troca de frame):
+ *   - AoS escalar: um struct por sprite, como o Sprite dos exemplos (com os campos de
+ *     desenho junto do estado);
+ *   - SoA escalar: SpriteEntities::updateRangeScalar;
+ *   - SoA SSE2: SpriteEntities::update sem pool;
+ *   - SoA SSE2 + ThreadPool: SpriteEntities::update dividindo o trabalho entre as threads.
+ * Ao final confere se as versões SoA chegaram ao mesmo estado. Não precisa de OpenGL.
+ */
+
+#include <iostream>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <cmath>
+
+#include "SpriteEntities.h"
+#include "BenchCommon.h"
+
+using namespace std;
+
+const int N_SPRITES = 1000000;
+const int N_TICKS = 120;
+const float DT = 1.0f / 60.0f;
+
+// Layout "um struct por sprite", com os mesmos campos que o Sprite de HelloSpritesheet
+struct SpriteAoS
+{
+	unsigned int VAO, texID;
+	float posX, posY, posZ;
+	float dimX, dimY, angle;
+	float velX, velY;
+	float animTimer, frameTime;
+	int frame, frameCount, animation;
+	float ds, dt;
+};
+
+void updateAoS(vector<SpriteAoS> &sprites, float dt, const SpriteBounds &b)
+{
+	for (SpriteAoS &s : sprites)
+	{
+		float x = s.posX + s.velX * dt;
+		float y = s.posY + s.velY * dt;
+		if ((x < b.minX && s.velX < 0.0f) || (x > b.maxX && s.velX > 0.0f))
+			s.velX = -s.velX;
+		if ((y < b.minY && s.velY < 0.0f) || (y > b.maxY && s.velY > 0.0f))
+			s.velY = -s.velY;
+		s.posX = x < b.minX ? b.minX : (x > b.maxX ? b.maxX : x);
+		s.posY = y < b.minY ? b.minY : (y > b.maxY ? b.maxY : y);
+
+		s.animTimer += dt;
+		if (s.animTimer >= s.frameTime)
+		{
+			s.animTimer -= s.frameTime;
+			s.frame = s.frame + 1 == s.frameCount ? 0 : s.frame + 1;
+		}
+	}
+}
+
+template <typename F>
+double timeTicks(F step)
+{
+	auto t0 = chrono::high_resolution_clock::now();
+	for (int t = 0; t < N_TICKS; t++)
+		step();
+	return msSince(t0) / N_TICKS;
+}
+
+bool sameState(const SpriteEntities &a, const SpriteEntities &b)
+{
+	for (int i = 0; i < a.size(); i++)
+	{
+		if (fabsf(a.posX[i] - b.posX[i]) > 1e-3f || fabsf(a.posY[i] - b.posY[i]) > 1e-3f ||
+			a.velX[i] != b.velX[i] || a.velY[i] != b.velY[i] || a.frame[i] != b.frame[i])
+			return false;
+	}
+	return true;
+}
+
+int main()
+{
+	const SpriteBounds bounds = {0.0f, 0.0f, 1920.0f, 1080.0f};
+
+	mt19937 rng(42);
+	uniform_real_distribution<float> posX(bounds.minX, bounds.maxX), posY(bounds.minY, bounds.maxY);
+	uniform_real_distribution<float> vel(-200.0f, 200.0f);
+	uniform_real_distribution<float> frameTime(0.08f, 0.25f);
+	uniform_int_distribution<int> anim(0, 11);
+
+	SpriteEntities base;
+	base.reserve(N_SPRITES);
+	vector<SpriteAoS> aos(N_SPRITES);
+	for (int i = 0; i < N_SPRITES; i++)
+	{
+		base.add(posX(rng), posY(rng), vel(rng), vel(rng), anim(rng), 2, frameTime(rng));
+		SpriteAoS &s = aos[i];
+		s = SpriteAoS();
+		s.posX = base.posX[i];
+		s.posY = base.posY[i];
+		s.velX = base.velX[i];
+		s.velY = base.velY[i];
+		s.frameTime = base.frameTime[i];
+		s.frameCount = 2;
+		s.animation = base.animation[i];
+	}
+
+	SpriteEntities scalar = base, simd = base, parallel = base;
+	ThreadPool pool;
+
+	double aosMs = timeTicks([&] { updateAoS(aos, DT, bounds); });
+	double scalarMs = timeTicks([&] { scalar.updateRangeScalar(0, scalar.size(), DT, bounds); });
+	double simdMs = timeTicks([&] { simd.update(DT, bounds); });
+	double parallelMs = timeTicks([&] { parallel.update(DT, bounds, &pool); });
+
+	bool iguais = sameState(scalar, simd) && sameState(scalar, parallel);
+
+	cout << "Sprites: " << N_SPRITES << ", passos: " << N_TICKS << ", threads: " << pool.size() << endl;
+#ifdef SPRITE_ENTITIES_SSE2
+	cout << "SIMD: SSE2" << endl;
+#else
+	cout << "SIMD: indisponivel (laco escalar)" << endl;
+#endif
+	cout << "AoS escalar:        " << aosMs << " ms/passo" << endl;
+	cout << "SoA escalar:        " << scalarMs << " ms/passo" << endl;
+	cout << "SoA SIMD:           " << simdMs << " ms/passo" << endl;
+	cout << "SoA SIMD + threads: " << parallelMs << " ms/passo" << endl;
+	cout << "Estado final " << (iguais ? "igual" : "DIFERENTE") << " entre as versoes SoA" << endl;
+
+	return iguais ? 0 : 1;
+}
@@ -0,0 +1,158 @@
+/*
+ * BenchTileCollision - mede o controlador de personagem sobre tilemaps (Common/TileCollision.h)
+ *
+ * Para mapas de 64x64, 512x512 e 4096x4096 tiles (cerca de 25% sólidos, em trechos de
+ * tamanhos variados), move 10k caixas por 120 passos com velocidades aleatórias e, de vez
+ * em quando, um "dash" de 20 tiles na horizontal. O tempo por movimento deve ficar igual
+ * nos três mapas. Para comparação, a versão ingênua testa a caixa contra todos os tiles
+ * do mapa (só nos mapas menores). Ao final confere que nenhuma caixa entrou numa parede.
+ * Não precisa de OpenGL.
+ */
+
+#include <iostream>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <cmath>
+
+#include "TileCollision.h"
+
+using namespace std;
+
+const float TILE = 16.0f;
+const float HALF = 6.0f;
+const int N_BOXES = 10000;
+const int N_TICKS = 120;
+
+// IDs: 0 chão, 1 parede
+const uint8_t FLAGS_BY_ID[2] = {0, TILE_SOLID};
+
+vector<int> makeMap(int n, mt19937 &rng)
+{
+	vector<int> tiles((size_t)n * n, 0);
+	uniform_int_distribution<int> runLen(1, 12), gap(1, 36);
+	for (int r = 0; r < n; r++)
+	{
+		int c = gap(rng);
+		while (c < n)
+		{
+			int len = runLen(rng);
+			for (int k = 0; k < len && c < n; k++, c++)
+				tiles[(size_t)r * n + c] = 1;
+			c += gap(rng);
+		}
+	}
+	return tiles;
+}
+
+bool overlapsWall(const TileCollisionLayer &layer, float x, float y)
+{
+	const float eps = 0.05f; // maior que o arredondamento nas coordenadas do mapa de 4096 tiles
+	int c0 = layer.colAt(x - HALF + eps), c1 = layer.colAt(x + HALF - eps);
+	int r0 = layer.rowAt(y + HALF - eps), r1 = layer.rowAt(y - HALF + eps);
+	for (int r = r0; r <= r1; r++)
+		for (int c = c0; c <= c1; c++)
+			if (layer.solidAt(c, r))
+				return true;
+	return false;
+}
+
+// Versão ingênua: desloca e, se a caixa cruzar qualquer tile sólido do mapa, desfaz
+void naiveMove(const vector<int> &tiles, int n, float &x, float &y, float dx, float dy)
+{
+	for (int axis = 0; axis < 2; axis++)
+	{
+		float nx = x + (axis == 0 ? dx : 0.0f), ny = y + (axis == 1 ? dy : 0.0f);
+		bool hit = false;
+		for (int r = 0; r < n && !hit; r++)
+		{
+			for (int c = 0; c < n; c++)
+			{
+				if (!tiles[(size_t)r * n + c])
+					continue;
+				float tx0 = c * TILE, tx1 = tx0 + TILE;
+				float ty1 = n * TILE - r * TILE, ty0 = ty1 - TILE;
+				if (nx + HALF > tx0 && nx - HALF < tx1 && ny + HALF > ty0 && ny - HALF < ty1)
+				{
+					hit = true;
+					break;
+				}
+			}
+		}
+		if (!hit)
+		{
+			x = nx;
+			y = ny;
+		}
+	}
+}
+
+int main()
+{
+	mt19937 rng(11);
+	bool correto = true;
+
+	const int sizes[] = {64, 512, 4096};
+	for (int n : sizes)
+	{
+		vector<int> tiles = makeMap(n, rng);
+		TileCollisionLayer layer;
+		layer.build(tiles.data(), n, n, FLAGS_BY_ID, 2, TILE, TILE, 0.0f, n * TILE);
+
+		// Caixas começam no centro de células livres
+		uniform_int_distribution<int> cell(0, n - 1);
+		vector<float> x(N_BOXES), y(N_BOXES);
+		for (int i = 0; i < N_BOXES; i++)
+		{
+			int c, r;
+			do
+			{
+				c = cell(rng);
+				r = cell(rng);
+			} while (layer.solidAt(c, r));
+			x[i] = layer.colLeft(c) + TILE / 2;
+			y[i] = layer.rowTop(r) - TILE / 2;
+		}
+		vector<float> nx = x, ny = y;
+
+		// Deslocamentos sorteados antes, iguais para as duas versões
+		uniform_real_distribution<float> vel(-4.0f, 4.0f);
+		uniform_int_distribution<int> dash(0, 49);
+		vector<float> dxs((size_t)N_BOXES * N_TICKS), dys(dxs.size());
+		for (size_t k = 0; k < dxs.size(); k++)
+		{
+			dxs[k] = dash(rng) == 0 ? (vel(rng) > 0.0f ? 20.0f : -20.0f) * TILE : vel(rng);
+			dys[k] = vel(rng);
+		}
+
+		CharacterController controller(HALF, HALF);
+		auto t0 = chrono::high_resolution_clock::now();
+		for (int t = 0; t < N_TICKS; t++)
+			for (int i = 0; i < N_BOXES; i++)
+			{
+				size_t k = (size_t)t * N_BOXES + i;
+				controller.move(layer, x[i], y[i], dxs[k], dys[k]);
+			}
+		double ns = chrono::duration<double, nano>(chrono::high_resolution_clock::now() - t0).count() /
+					((double)N_BOXES * N_TICKS);
+
+		for (int i = 0; i < N_BOXES && correto; i++)
+			if (overlapsWall(layer, x[i], y[i]))
+				correto = false;
+
+		cout << "Mapa " << n << "x" << n << ": controlador " << ns << " ns/movimento";
+		if (n <= 64)
+		{
+			// A ingênua é lenta demais para muitos movimentos: mede só 200
+			auto t1 = chrono::high_resolution_clock::now();
+			for (int i = 0; i < 200; i++)
+				naiveMove(tiles, n, nx[i], ny[i], dxs[i], dys[i]);
+			double naiveNs = chrono::duration<double, nano>(chrono::high_resolution_clock::now() - t1).count() / 200;
+			cout << ", ingenua " << naiveNs << " ns/movimento";
+		}
+		cout << endl;
+	}
+
+	cout << "Caixas " << (correto ? "fora das paredes" : "DENTRO DE PAREDES") << " ao final" << endl;
+	return correto ? 0 : 1;
+}
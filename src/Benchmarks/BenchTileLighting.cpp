@@ -0,0 +1,165 @@
+/*
+ * BenchTileLighting - mede a luz de tochas no tilemap (Common/TileLighting.h)
+ *
+ * Num mapa de 2048x2048 tiles com 15% de paredes espalhadas, acende 2000 tochas fixas
+ * e mede a latência de update() quando uma luz se move uma célula (o jogador andando com
+ * a tocha), quando 50 luzes se movem no mesmo passo e quando tiles abrem e fecham,
+ * comparando com refazer o mapa de luz inteiro.
+ *
+ * Confere que o mapa mantido incrementalmente é igual ao refeito do zero e que, num mapa
+ * sem paredes, uma luz sozinha cai 1 nível por passo (distância de Manhattan). Não
+ * precisa de OpenGL.
+ */
+
+#include <iostream>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <algorithm>
+
+#include "TileLighting.h"
+#include "BenchCommon.h"
+
+using namespace std;
+
+const int N = 2048;
+const int N_TORCHES = 2000;
+
+// Tile 0 = chão, tile 1 = parede
+const uint8_t TILE_FLAGS[2] = {0, TILE_SOLID};
+
+bool sameLight(const TileLightMap &a, const TileLightMap &b)
+{
+	return a.data() == b.data();
+}
+
+int main()
+{
+	mt19937 rng(48);
+	bool correto = true;
+
+	vector<int> tiles((size_t)N * N);
+	uniform_real_distribution<float> u(0.0f, 1.0f);
+	for (size_t i = 0; i < tiles.size(); i++)
+		tiles[i] = u(rng) < 0.15f ? 1 : 0;
+	TileCollisionLayer layer;
+	layer.build(tiles.data(), N, N, TILE_FLAGS, 2, 1.0f, 1.0f, 0.0f, (float)N);
+
+	uniform_int_distribution<int> cell(0, N - 1), level(6, LIGHT_MAX);
+	TileLightMap light;
+	light.init(layer);
+	for (int i = 0; i < N_TORCHES; i++)
+		light.addLight(cell(rng), cell(rng), level(rng));
+	auto t0 = chrono::high_resolution_clock::now();
+	light.update();
+	double firstUs = usSince(t0);
+
+	const int FULL_REPS = 5;
+	t0 = chrono::high_resolution_clock::now();
+	for (int k = 0; k < FULL_REPS; k++)
+		light.rebuild();
+	double fullUs = usSince(t0) / FULL_REPS;
+
+	// O jogador anda com uma luz de nível máximo, uma célula por passo
+	const int N_MOVES = 2000;
+	int pc = N / 2, pr = N / 2;
+	int player = light.addLight(pc, pr, LIGHT_MAX);
+	light.update();
+	uniform_int_distribution<int> dir(0, 3);
+	const int DC[4] = {1, -1, 0, 0}, DR[4] = {0, 0, 1, -1};
+	vector<double> moveUs;
+	long visited = 0;
+	for (int m = 0; m < N_MOVES; m++)
+	{
+		int d = dir(rng);
+		int c = pc + DC[d], r = pr + DR[d];
+		if (layer.solidAt(c, r))
+			continue;
+		pc = c;
+		pr = r;
+		auto t1 = chrono::high_resolution_clock::now();
+		light.moveLight(player, pc, pr);
+		visited += light.update();
+		moveUs.push_back(usSince(t1));
+	}
+	sort(moveUs.begin(), moveUs.end());
+	double meanUs = 0.0;
+	for (double us : moveUs)
+		meanUs += us;
+	meanUs /= moveUs.size();
+
+	// 50 tochas movendo no mesmo passo
+	const int N_MOVING = 50, N_TICKS = 200;
+	vector<int> ids(N_MOVING), mc(N_MOVING), mr(N_MOVING);
+	for (int i = 0; i < N_MOVING; i++)
+	{
+		mc[i] = cell(rng);
+		mr[i] = cell(rng);
+		ids[i] = light.addLight(mc[i], mr[i], level(rng));
+	}
+	light.update();
+	double tickUs = 0.0;
+	for (int t = 0; t < N_TICKS; t++)
+	{
+		auto t1 = chrono::high_resolution_clock::now();
+		for (int i = 0; i < N_MOVING; i++)
+		{
+			int d = dir(rng);
+			mc[i] = min(max(mc[i] + DC[d], 0), N - 1);
+			mr[i] = min(max(mr[i] + DR[d], 0), N - 1);
+			light.moveLight(ids[i], mc[i], mr[i]);
+		}
+		light.update();
+		tickUs += usSince(t1);
+	}
+
+	// Tiles abrindo e fechando perto das luzes
+	const int N_CHANGES = 2000;
+	uniform_int_distribution<int> near(-8, 8);
+	double changeUs = 0.0;
+	for (int k = 0; k < N_CHANGES; k++)
+	{
+		int i = k % N_MOVING;
+		int c = min(max(mc[i] + near(rng), 0), N - 1), r = min(max(mr[i] + near(rng), 0), N - 1);
+		int &tile = tiles[(size_t)r * N + c];
+		tile = 1 - tile;
+		layer.setTile(c, r, tile);
+		auto t1 = chrono::high_resolution_clock::now();
+		light.tileChanged(c, r);
+		light.update();
+		changeUs += usSince(t1);
+	}
+
+	cout << "Mapa " << N << "x" << N << ", " << N_TORCHES << " tochas" << endl;
+	cout << "  Mapa de luz inteiro: " << firstUs / 1000.0 << " ms na primeira vez, " << fullUs / 1000.0
+		 << " ms para refazer" << endl;
+	cout << "  Luz movendo 1 celula: " << meanUs << " us em media, " << moveUs[moveUs.size() / 2] << " us mediana, "
+		 << moveUs[moveUs.size() * 99 / 100] << " us p99 (" << visited / (long)moveUs.size() << " celulas visitadas)"
+		 << endl;
+	cout << "  " << N_MOVING << " luzes movendo no mesmo passo: " << tickUs / N_TICKS << " us por passo" << endl;
+	cout << "  Tile trocado perto de uma luz: " << changeUs / N_CHANGES << " us" << endl;
+
+	// Incremental tem que bater com o refeito do zero
+	vector<uint8_t> incremental = light.data();
+	light.rebuild();
+	if (incremental != light.data())
+		correto = false;
+
+	// Sem paredes: nível = fonte - distância de Manhattan
+	vector<int> open((size_t)64 * 64, 0);
+	TileCollisionLayer openLayer;
+	openLayer.build(open.data(), 64, 64, TILE_FLAGS, 2, 1.0f, 1.0f, 0.0f, 64.0f);
+	TileLightMap single;
+	single.init(openLayer);
+	int id = single.addLight(10, 10, LIGHT_MAX);
+	single.update();
+	single.moveLight(id, 30, 40); // o rastro da posição antiga tem que sumir
+	single.update();
+	for (int r = 0; r < 64; r++)
+		for (int c = 0; c < 64; c++)
+			if (single.level(c, r) != max(LIGHT_MAX - abs(c - 30) - abs(r - 40), 0))
+				correto = false;
+
+	cout << "Luz " << (correto ? "correta" : "INCORRETA") << endl;
+	return correto ? 0 : 1;
+}
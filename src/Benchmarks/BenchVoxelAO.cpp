@@ -0,0 +1,167 @@
+/*
+ * BenchVoxelAO - mede o custo da oclusão ambiente por vértice no ChunkMesher
+ *
+ * Gera o terreno de um mundo de 16x4x16 chunks (256x64x256 blocos), com cavernas
+ * escavadas para ter cantos côncavos, e monta a malha de todos os chunks com a oclusão
+ * desligada e ligada. Mostra o tempo por chunk e o acréscimo (a oclusão é calculada só
+ * aqui; no desenho ela é só mais um valor interpolado do vértice).
+ *
+ * Confere que as duas malhas têm o mesmo número de vértices e índices, que sem oclusão
+ * todo vértice sai com 3, que cada quad foi dividido pela diagonal mais clara e alguns
+ * cantos conhecidos (um bloco na diagonal, um canto fechado). Também confere que editar
+ * um bloco na quina de um chunk marca os 8 chunks que encostam nele. Não precisa de OpenGL.
+ */
+
+#include <iostream>
+#include <vector>
+#include <chrono>
+
+#include "ChunkMesher.h"
+#include "BenchCommon.h"
+
+using namespace std;
+
+int aoOf(const ChunkVertex &v) { return (v.a >> 20) & 3; }
+
+// Mede a malha de todos os chunks; devolve ms por chunk com malha
+double meshAll(const VoxelWorld &world, ChunkMesher &mesher, long &vertexCount, long &indexCount, int &meshed)
+{
+	const int REPS = 3;
+	vertexCount = indexCount = 0;
+	meshed = 0;
+	auto t0 = chrono::high_resolution_clock::now();
+	for (int rep = 0; rep < REPS; rep++)
+		for (int i = 0; i < world.chunkCount(); i++)
+		{
+			mesher.mesh(world, i);
+			if (rep > 0)
+				continue;
+			vertexCount += mesher.vertices.size();
+			indexCount += mesher.indices.size();
+			if (!mesher.indices.empty())
+				meshed++;
+		}
+	return msSince(t0) / REPS / meshed;
+}
+
+// Em cada quad, a diagonal usada (o vértice repetido nos 2 triângulos) liga os cantos mais claros
+bool quadsSplitCorrectly(const ChunkMesher &mesher)
+{
+	for (size_t q = 0; q < mesher.indices.size() / 6; q++)
+	{
+		const ChunkIndex *idx = &mesher.indices[q * 6];
+		int base = idx[0] - (idx[0] % 4); // os 4 vértices de uma face são consecutivos
+		int ao[4];
+		for (int c = 0; c < 4; c++)
+			ao[c] = aoOf(mesher.vertices[base + c]);
+		int first = aoFlipQuad(ao) ? 1 : 0;
+		if (idx[0] != base + first || idx[2] != base + (first + 2) % 4 || idx[3] != idx[0] || idx[4] != idx[2])
+			return false;
+	}
+	return true;
+}
+
+// Oclusão do canto (cx, cz) da face de cima do bloco (x, y, z) na malha atual
+int topCornerAO(const ChunkMesher &mesher, int x, int y, int z, int cx, int cz)
+{
+	for (const ChunkVertex &v : mesher.vertices)
+	{
+		int vx = v.a & 31, vy = (v.a >> 5) & 31, vz = (v.a >> 10) & 31, face = (v.a >> 15) & 7;
+		if (face == 2 && vx == x + cx && vy == y + 1 && vz == z + cz)
+		{
+			// O mesmo ponto é canto de até 4 faces de cima; a do bloco pedido é a que fica
+			// do lado oposto ao canto
+			int corner = (v.a >> 18) & 3;
+			const int *off = FACE_CORNERS[2][corner];
+			if (off[0] == cx && off[2] == cz)
+				return aoOf(v);
+		}
+	}
+	return -1;
+}
+
+int main()
+{
+	bool correto = true;
+
+	VoxelWorld world;
+	world.init(16, 4, 16);
+	world.generateTerrain();
+	// Cavernas: túneis de 3x3 blocos cruzando o terreno
+	for (int t = 0; t < 40; t++)
+	{
+		int y = 6 + (t * 7) % 10, fixed = 8 + (t * 37) % 240;
+		for (int i = 0; i < world.sizeX(); i++)
+			for (int a = -1; a <= 1; a++)
+				for (int b = -1; b <= 1; b++)
+				{
+					if (t % 2 == 0)
+						world.setBlock(i, y + a, fixed + b, BLOCK_AIR);
+					else
+						world.setBlock(fixed + b, y + a, i, BLOCK_AIR);
+				}
+	}
+	world.takeDirty();
+
+	ChunkMesher mesher;
+	long flatV, flatI, aoV, aoI;
+	int meshedFlat, meshedAO;
+	mesher.ambientOcclusion = false;
+	double flatMs = meshAll(world, mesher, flatV, flatI, meshedFlat);
+	for (const ChunkVertex &v : mesher.vertices)
+		if (aoOf(v) != 3)
+			correto = false;
+	mesher.ambientOcclusion = true;
+	double aoMs = meshAll(world, mesher, aoV, aoI, meshedAO);
+	if (flatV != aoV || flatI != aoI || meshedFlat != meshedAO)
+		correto = false;
+
+	// Divisão dos quads e distribuição dos valores em todos os chunks
+	long histogram[4] = {0, 0, 0, 0}, flipped = 0;
+	for (int i = 0; i < world.chunkCount(); i++)
+	{
+		mesher.mesh(world, i);
+		if (!quadsSplitCorrectly(mesher))
+			correto = false;
+		for (const ChunkVertex &v : mesher.vertices)
+			histogram[aoOf(v)]++;
+		for (size_t q = 0; q < mesher.indices.size(); q += 6)
+			flipped += mesher.indices[q] % 4 == 1;
+	}
+
+	cout << "Mundo " << world.sizeX() << "x" << world.sizeY() << "x" << world.sizeZ() << ", " << meshedAO
+		 << " chunks com malha, " << aoV / 4 << " faces" << endl;
+	cout << "  Sem oclusao: " << flatMs << " ms por chunk" << endl;
+	cout << "  Com oclusao: " << aoMs << " ms por chunk (+" << (aoMs / flatMs - 1.0) * 100.0 << "%)" << endl;
+	cout << "  Vertices com oclusao 0/1/2/3: " << histogram[0] << " / " << histogram[1] << " / " << histogram[2]
+		 << " / " << histogram[3] << "; " << flipped << " quads com a diagonal trocada" << endl;
+
+	// Cantos conhecidos num chunk só: chão de pedra em y = 0
+	VoxelWorld small;
+	small.init(1, 1, 1);
+	for (int x = 0; x < CHUNK_SIZE; x++)
+		for (int z = 0; z < CHUNK_SIZE; z++)
+			small.setBlock(x, 0, z, BLOCK_STONE);
+	small.setBlock(5, 1, 5, BLOCK_STONE); // bloco na diagonal do canto (5, 5) do bloco (4, 0, 4)
+	mesher.mesh(small, 0);
+	if (topCornerAO(mesher, 4, 0, 4, 1, 1) != 2 || topCornerAO(mesher, 4, 0, 4, 0, 0) != 3)
+		correto = false;
+	small.setBlock(4, 1, 5, BLOCK_STONE);
+	small.setBlock(5, 1, 4, BLOCK_STONE); // agora os dois lados: canto fechado
+	mesher.mesh(small, 0);
+	if (topCornerAO(mesher, 4, 0, 4, 1, 1) != 0 || topCornerAO(mesher, 4, 0, 4, 0, 1) != 2)
+		correto = false;
+	if (!quadsSplitCorrectly(mesher))
+		correto = false;
+
+	// Editar a quina de um chunk marca os 8 chunks em volta dela
+	VoxelWorld cube;
+	cube.init(2, 2, 2);
+	cube.takeDirty();
+	cube.setBlock(CHUNK_SIZE - 1, CHUNK_SIZE - 1, CHUNK_SIZE - 1, BLOCK_STONE);
+	if (cube.takeDirty().size() != 8)
+		correto = false;
+
+	cout << "Oclusao " << (correto ? "correta" : "INCORRETA") << endl;
+	return correto ? 0 : 1;
+}
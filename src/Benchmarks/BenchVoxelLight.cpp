@@ -0,0 +1,226 @@
+/*
+ * BenchVoxelLight - mede a luz do sol e de blocos nos voxels (Common/VoxelLight.h)
+ *
+ * Gera um mundo de 16x16x16 chunks (256x256x256 blocos) com terreno, cavernas e blocos de
+ * mel espalhados nelas, mede computeAll() e depois a latência de edições de um bloco só:
+ * cavar e repor blocos da superfície, abrir e fechar blocos nas cavernas e acender e
+ * apagar blocos de mel (blockChanged + update, o que o key_callback do HelloVoxelWorld faz).
+ *
+ * Confere que a luz mantida incrementalmente é igual à de um computeAll() do zero, que um
+ * bloco de mel sozinho cai 1 nível por passo (distância de Manhattan) e some ao ser
+ * retirado e que um teto tira o sol de baixo dele e o devolve ao ser retirado. Não
+ * precisa de OpenGL.
+ */
+
+#include <iostream>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <algorithm>
+#include <cstring>
+
+#include "VoxelLight.h"
+#include "BenchCommon.h"
+
+using namespace std;
+
+bool sameLight(const VoxelWorld &a, const VoxelWorld &b)
+{
+	for (int i = 0; i < a.chunkCount(); i++)
+		if (memcmp(a.chunk(i).light, b.chunk(i).light, CHUNK_VOLUME) != 0)
+			return false;
+	return true;
+}
+
+int topBlock(const VoxelWorld &world, int x, int z)
+{
+	int y = world.sizeY() - 1;
+	while (y > 0 && world.getBlock(x, y, z) == BLOCK_AIR)
+		y--;
+	return y;
+}
+
+// Edição como no HelloVoxelWorld: troca o bloco e refaz a luz em volta
+double edit(VoxelWorld &world, VoxelLighting &lighting, int x, int y, int z, uint8_t type, long &visited)
+{
+	auto t0 = chrono::high_resolution_clock::now();
+	world.setBlock(x, y, z, type);
+	lighting.blockChanged(x, y, z);
+	visited += lighting.update();
+	return usSince(t0);
+}
+
+void printTimes(const char *label, vector<double> &us, long visited)
+{
+	sort(us.begin(), us.end());
+	double mean = 0.0;
+	for (double t : us)
+		mean += t;
+	mean /= us.size();
+	cout << "  " << label << ": " << mean << " us em media, " << us[us.size() / 2] << " us mediana, "
+		 << us[us.size() * 99 / 100] << " us p99, " << us.back() << " us pior (" << visited / (long)us.size()
+		 << " celulas visitadas)" << endl;
+}
+
+int main()
+{
+	mt19937 rng(50);
+	bool correto = true;
+
+	VoxelWorld world;
+	world.init(16, 16, 16);
+	world.generateTerrain();
+	// Cavernas: túneis de 3x3 blocos cruzando o terreno, com mel a cada 24 blocos
+	vector<glm::ivec3> caves;
+	for (int t = 0; t < 40; t++)
+	{
+		int y = 20 + (t * 7) % 40, fixed = 8 + (t * 37) % 240;
+		for (int i = 0; i < world.sizeX(); i++)
+		{
+			for (int a = -1; a <= 1; a++)
+				for (int b = -1; b <= 1; b++)
+				{
+					if (t % 2 == 0)
+						world.setBlock(i, y + a, fixed + b, BLOCK_AIR);
+					else
+						world.setBlock(fixed + b, y + a, i, BLOCK_AIR);
+				}
+			glm::ivec3 p = t % 2 == 0 ? glm::ivec3(i, y, fixed) : glm::ivec3(fixed, y, i);
+			caves.push_back(p);
+			if (i % 24 == 12)
+				world.setBlock(p.x, p.y - 1, p.z, BLOCK_HONEY);
+		}
+	}
+	world.takeDirty();
+
+	VoxelLighting lighting;
+	lighting.init(world);
+	auto t0 = chrono::high_resolution_clock::now();
+	lighting.computeAll();
+	double fullUs = usSince(t0);
+	if (!world.takeDirty().empty())
+		correto = false; // computeAll não marca chunks
+
+	// Superfície: cava o bloco do topo e depois põe de volta
+	const int N_EDITS = 1000;
+	uniform_int_distribution<int> coord(1, world.sizeX() - 2);
+	vector<double> surfaceUs;
+	long surfaceVisited = 0;
+	for (int k = 0; k < N_EDITS; k++)
+	{
+		int x = coord(rng), z = coord(rng), y = topBlock(world, x, z);
+		uint8_t old = world.getBlock(x, y, z);
+		surfaceUs.push_back(edit(world, lighting, x, y, z, BLOCK_AIR, surfaceVisited));
+		surfaceUs.push_back(edit(world, lighting, x, y, z, old, surfaceVisited));
+	}
+
+	// Cavernas: fecha uma célula do túnel e abre de novo
+	uniform_int_distribution<int> caveCell(0, (int)caves.size() - 1);
+	vector<double> caveUs;
+	long caveVisited = 0;
+	for (int k = 0; k < N_EDITS; k++)
+	{
+		glm::ivec3 p = caves[caveCell(rng)];
+		if (world.getBlock(p.x, p.y, p.z) != BLOCK_AIR)
+			continue;
+		caveUs.push_back(edit(world, lighting, p.x, p.y, p.z, BLOCK_STONE, caveVisited));
+		caveUs.push_back(edit(world, lighting, p.x, p.y, p.z, BLOCK_AIR, caveVisited));
+	}
+
+	// Mel: acende no chão da caverna e apaga
+	vector<double> lampUs;
+	long lampVisited = 0;
+	for (int k = 0; k < N_EDITS; k++)
+	{
+		glm::ivec3 p = caves[caveCell(rng)];
+		p.y += 1;
+		if (world.getBlock(p.x, p.y, p.z) != BLOCK_AIR)
+			continue;
+		lampUs.push_back(edit(world, lighting, p.x, p.y, p.z, BLOCK_HONEY, lampVisited));
+		lampUs.push_back(edit(world, lighting, p.x, p.y, p.z, BLOCK_AIR, lampVisited));
+	}
+
+	// Algumas edições que ficam no mundo, para a conferência não ser só "tudo voltou"
+	for (int k = 0; k < 200; k++)
+	{
+		int x = coord(rng), z = coord(rng);
+		long unused = 0;
+		if (k % 2 == 0)
+			edit(world, lighting, x, topBlock(world, x, z), z, BLOCK_AIR, unused);
+		else
+		{
+			glm::ivec3 p = caves[caveCell(rng)];
+			edit(world, lighting, p.x, p.y, p.z, k % 4 == 1 ? BLOCK_HONEY : BLOCK_STONE, unused);
+		}
+	}
+
+	cout << "Mundo " << world.sizeX() << "x" << world.sizeY() << "x" << world.sizeZ() << endl;
+	cout << "  Luz do mundo inteiro: " << fullUs / 1000.0 << " ms" << endl;
+	printTimes("Bloco da superficie", surfaceUs, surfaceVisited);
+	printTimes("Bloco na caverna", caveUs, caveVisited);
+	printTimes("Bloco de mel", lampUs, lampVisited);
+
+	// Incremental tem que bater com o refeito do zero
+	VoxelWorld fresh = world;
+	VoxelLighting freshLighting;
+	freshLighting.init(fresh);
+	freshLighting.computeAll();
+	if (!sameLight(world, fresh))
+		correto = false;
+
+	// Mel sozinho no meio do ar, numa caixa de pedra (sem sol)
+	VoxelWorld box;
+	box.init(2, 2, 2);
+	for (int x = 0; x < box.sizeX(); x++)
+		for (int z = 0; z < box.sizeZ(); z++)
+			box.setBlock(x, box.sizeY() - 1, z, BLOCK_STONE);
+	VoxelLighting boxLighting;
+	boxLighting.init(box);
+	boxLighting.computeAll();
+	long unused = 0;
+	edit(box, boxLighting, 16, 16, 16, BLOCK_HONEY, unused);
+	for (int y = 0; y < box.sizeY() - 1; y++)
+		for (int z = 0; z < box.sizeZ(); z++)
+			for (int x = 0; x < box.sizeX(); x++)
+			{
+				int d = abs(x - 16) + abs(y - 16) + abs(z - 16);
+				int expected = d == 0 ? 14 : max(14 - d, 0);
+				if (boxLighting.blockLight(x, y, z) != expected || boxLighting.sunLight(x, y, z) != 0)
+					correto = false;
+			}
+	edit(box, boxLighting, 16, 16, 16, BLOCK_AIR, unused);
+	for (int i = 0; i < box.chunkCount(); i++)
+		for (int k = 0; k < CHUNK_VOLUME; k++)
+			if (box.chunk(i).light[k] != 0)
+				correto = false;
+
+	// Teto de 3x3 sobre um chão: debaixo do centro o sol chega de lado, 2 passos
+	VoxelWorld open;
+	open.init(1, 2, 1);
+	for (int x = 0; x < CHUNK_SIZE; x++)
+		for (int z = 0; z < CHUNK_SIZE; z++)
+			open.setBlock(x, 0, z, BLOCK_STONE);
+	VoxelLighting openLighting;
+	openLighting.init(open);
+	openLighting.computeAll();
+	for (int x = 7; x <= 9; x++)
+		for (int z = 7; z <= 9; z++)
+			edit(open, openLighting, x, 20, z, BLOCK_STONE, unused);
+	if (openLighting.sunLight(8, 10, 8) != 13 || openLighting.sunLight(7, 10, 8) != 14 ||
+		openLighting.sunLight(8, 21, 8) != 15 || openLighting.sunLight(8, 20, 8) != 0)
+		correto = false;
+	open.takeDirty();
+	for (int x = 7; x <= 9; x++)
+		for (int z = 7; z <= 9; z++)
+			edit(open, openLighting, x, 20, z, BLOCK_AIR, unused);
+	if (open.takeDirty().empty())
+		correto = false;
+	for (int y = 1; y < open.sizeY(); y++)
+		for (int z = 0; z < CHUNK_SIZE; z++)
+			for (int x = 0; x < CHUNK_SIZE; x++)
+				if (openLighting.sunLight(x, y, z) != VOXEL_LIGHT_MAX)
+					correto = false;
+
+	cout << "Luz " << (correto ? "correta" : "INCORRETA") << endl;
+	return correto ? 0 : 1;
+}
@@ -5,6 +5,9 @@
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
+// UBO compartilhado com as matrizes da câmera
+#include "CameraUBO.h"
+
 using namespace std;
 
 // Dimensões da janela
@@ -20,6 +23,7 @@ bool firstMouse = true;
 float lastX = WIDTH / 2.0f;
 float lastY = HEIGHT / 2.0f;
 float fov = 45.0f;
+const float zNear = 0.1f, zFar = 100.0f;
 
 // Controle de tempo entre frames
 float deltaTime = 0.0f;
@@ -29,14 +33,22 @@ float lastFrame = 0.0f;
 GLuint shaderID, VAO;
 GLFWwindow *window;
 
+// UBO com view e proj (bloco Camera nos shaders)
+CameraUBO cameraUBO;
+
 // Código do Vertex Shader
 const GLchar *vertexShaderSource = R"glsl(
     #version 450
     layout(location = 0) in vec3 position;
     layout(location = 1) in vec3 color;
     uniform mat4 model;
-    uniform mat4 view;
-    uniform mat4 proj;
+    layout (std140, binding = 0) uniform Camera
+    {
+        mat4 view;
+        mat4 proj;
+        mat4 viewProj;
+        vec4 cameraPos;
+    };
     out vec3 fragColor;
     void main() {
         fragColor = color;
@@ -123,20 +135,10 @@ void processInput(GLFWwindow *window)
         cameraPos += glm::normalize(glm::cross(cameraFront, cameraUp)) * cameraSpeed;
 }
 
-// Define a matriz de visualização usando a posição e direção da câmera
-void especificaVisualizacao()
+// Atualiza o UBO da câmera; se a câmera não se moveu, nada é enviado
+void especificaCamera()
 {
-    glm::mat4 view = glm::lookAt(cameraPos, cameraPos + cameraFront, cameraUp);
-    GLuint loc = glGetUniformLocation(shaderID, "view");
-    glUniformMatrix4fv(loc, 1, GL_FALSE, glm::value_ptr(view));
-}
-
-// Define a matriz de projeção perspectiva com base no FOV
-void especificaProjecao()
-{
-    glm::mat4 proj = glm::perspective(glm::radians(fov), (float)WIDTH / HEIGHT, 0.1f, 100.0f);
-    GLuint loc = glGetUniformLocation(shaderID, "proj");
-    glUniformMatrix4fv(loc, 1, GL_FALSE, glm::value_ptr(proj));
+    cameraUBO.update(cameraPos, cameraFront, cameraUp, fov, (float)WIDTH / HEIGHT, zNear, zFar);
 }
 
 // Matriz de transformação do objeto (identidade neste caso)
@@ -290,6 +292,9 @@ int main()
 
     gladLoadGLLoader((GLADloadproc)glfwGetProcAddress);
 
+    // Cria o UBO da câmera e o liga ao ponto fixo CAMERA_UBO_BINDING
+    cameraUBO.init();
+
     shaderID = setupShader();
     VAO = setupGeometry();
 
@@ -308,8 +313,7 @@ int main()
 
         glUseProgram(shaderID);
 
-        especificaVisualizacao();
-        especificaProjecao();
+        especificaCamera();
 
         // renderizar os objetos
         glBindVertexArray(VAO);
@@ -0,0 +1,844 @@
+/*
+ * Hello Isometric - tilemap isométrico (losangos) com blocos e sprites ordenados pelo depth buffer
+ *
+ * Adaptado de HelloTiles por: Rossana Baptista Queiroz
+ *
+ * Disciplinas:
+ *   - Processamento Gráfico (Ciência da Computação - Híbrido)
+ *   - Processamento Gráfico: Fundamentos (Ciência da Computação - Presencial)
+ *   - Fundamentos de Computação Gráfica (Jogos Digitais)
+ *
+ * Descrição:
+ *   Em HelloTiles o tile (i, j) fica em x0 + j*largura, HEIGHT - y0 - i*altura. Aqui o
+ *   mapa passa pela projeção isométrica de Common/IsoProjection.h: cada tile vira um
+ *   losango e os tiles de pedra viram blocos (topo e duas faces laterais).
+ *
+ *   Num mapa isométrico, o que está mais abaixo na tela fica na frente. Em vez de ordenar
+ *   tiles e sprites na CPU a cada frame, cada instância leva uma chave de profundidade
+ *   (u + v no mapa, IsoProjection::depthKey) que o vertex shader escreve em gl_Position.z;
+ *   o depth buffer resolve a ordem. O chão fica atrás de tudo; blocos e sprites são
+ *   comparados pela chave. Pixels transparentes dos sprites são descartados no fragment
+ *   shader (sem blending, que dependeria da ordem de desenho).
+ *
+ *   Chão, blocos e sprites vão todos para um único glDrawArraysInstanced. Só os tiles que
+ *   cruzam a tela (IsoProjection::forEachVisible) são escritos no StreamBuffer, e os
+ *   sprites vêm de uma SpatialGrid em coordenadas do mapa, consultada só na região
+ *   visível; o custo por frame acompanha o que está na tela e não o tamanho do mapa nem
+ *   o número total de sprites.
+ *
+ *   Os sprites andam pelo mapa com o CharacterController de Common/TileCollision.h
+ *   (pedra, lava e água funda bloqueiam), nas coordenadas do mapa, e são animados pelos
+ *   clipes de assets/sprites/enemies-spritesheet1.json.
+ *
+ *   Opções: --map N (mapa N x N, padrão 256), --sprites N (padrão 2000), além das do
+ *   modo benchmark e de ritmo.
+ *   Teclas: setas/WASD movem a câmera, Q/E (ou a roda do mouse) mudam o zoom, V troca o
+ *   ritmo dos frames, P grava o trace.
+ *
+ * Histórico:
+ *   - Versão inicial: 19/10/2026
+ *
+ */
+
+#include <iostream>
+#include <string>
+#include <assert.h>
+#include <cmath>
+#include <cstring>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+using namespace std;
+
+// GLAD
+#include <glad/glad.h>
+
+// GLFW
+#include <GLFW/glfw3.h>
+
+// GLM
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+using namespace glm;
+
+// STB_IMAGE
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb_image.h>
+
+// Buffer circular persistente para as instâncias de cada frame
+#include "StreamBuffer.h"
+// Medição de tempos de CPU/GPU e modo benchmark (--benchmark N)
+#include "FrameProfiler.h"
+#include "Benchmark.h"
+// Simulação em passo fixo
+#include "GameLoop.h"
+// Ritmo dos frames (vsync, adaptativo, limitado, sem limite)
+#include "FramePacer.h"
+// Clipes de animação da spritesheet
+#include "SpriteAnimation.h"
+// Projeção isométrica e colisão com os tiles
+#include "IsoProjection.h"
+#include "TileCollision.h"
+// Grade espacial dos sprites, para desenhar só os visíveis
+#include "SpatialGrid.h"
+// Câmera 2D com deslocamento e zoom
+#include "Camera2D.h"
+
+// Uma instância: um paralelogramo na tela (canto o e arestas e1, e2) com um retângulo
+// da textura. Losangos do chão, faces dos blocos e sprites são todos desse tipo.
+struct IsoInstance
+{
+	float ox, oy;	// canto correspondente a texc (0, 0)
+	float e1x, e1y; // aresta até texc (1, 0)
+	float e2x, e2y; // aresta até texc (0, 1)
+	float depth;	// chave de profundidade (0 atrás, 1 na frente)
+	float shade;	// multiplicador da cor (faces laterais mais escuras)
+	float s0, t0, s1, t1;
+	int32_t texture; // 0 tileset, 1 spritesheet
+};
+
+// Sprites andando pelo mapa, em coordenadas do mapa (u, v)
+struct Walkers
+{
+	vector<float> u, v, prevU, prevV, vu, vv;
+	vector<int> anim; // índice em animations
+};
+
+// Protótipo da função de callback de teclado
+void key_callback(GLFWwindow *window, int key, int scancode, int action, int mode);
+void scroll_callback(GLFWwindow *window, double xoffset, double yoffset);
+
+// Protótipos das funções
+int setupShader();
+int setupQuad();
+int loadTexture(string filePath);
+void generateMap(vector<int> &tiles, int n);
+bool spawnWalkers(Walkers &walkers, int n, const TileCollisionLayer &layer);
+void updateWalkers(Walkers &walkers, float dt, const TileCollisionLayer &layer);
+int drawScene(GLuint shaderID, GLuint VAO, float alpha);
+
+// Dimensões da janela (pode ser alterado em tempo de execução)
+const GLuint WIDTH = 800, HEIGHT = 600;
+
+// Tileset: 7 tiles lado a lado (0 areia, 1 grama, 2 pedra, 3 lava, 4 gelo, 5 água funda, 6 rosa),
+// seguidos de 4 quadros de animação da lava e da água (usados só no HelloTiles)
+const int N_TILES = 7;
+const int TILESET_COLUMNS = 11;
+const uint8_t tileFlags[N_TILES] = {0, 0, TILE_SOLID, TILE_SOLID, 0, TILE_SOLID, 0};
+const int ROCK = 2;
+
+// Losango de 64x32 pixels; os blocos de pedra sobem BLOCK_HEIGHT pixels
+const float TILE_W = 64.0, TILE_H = 32.0;
+const float BLOCK_HEIGHT = 32.0;
+
+// Sprites: 32x32 pixels na tela, caixa de colisão de 0,4 x 0,4 tile
+const float SPRITE_SIZE = 32.0;
+const float WALKER_HALF = 0.2;
+
+// Limite de instâncias por frame (chão e blocos visíveis + sprites visíveis)
+const int MAX_INSTANCES = 1 << 16;
+
+// Velocidade da câmera, em pixels de tela por segundo
+const float CAMERA_SPEED = 600.0;
+
+// Código fonte do Vertex Shader (em GLSL): ainda hardcoded
+// Cada instância é um paralelogramo; a chave de profundidade vai para o z do depth buffer
+const GLchar *vertexShaderSource = R"(
+ #version 400
+ layout (location = 0) in vec2 texc;
+ layout (location = 1) in vec4 inst_edges0; // (ox, oy, e1x, e1y)
+ layout (location = 2) in vec4 inst_edges1; // (e2x, e2y, depth, shade)
+ layout (location = 3) in vec4 inst_uv;
+ layout (location = 4) in int inst_texture;
+
+ uniform mat4 projection;
+ out vec2 tex_coord;
+ out float shade;
+ flat out int texture_index;
+ void main()
+ {
+	vec2 p = inst_edges0.xy + texc.x * inst_edges0.zw + texc.y * inst_edges1.xy;
+	tex_coord = mix(inst_uv.xy, inst_uv.zw, texc);
+	shade = inst_edges1.w;
+	texture_index = inst_texture;
+	gl_Position = projection * vec4(p, 0.0, 1.0);
+	// Chave 0 (chão) logo antes do plano de fundo; chave 1 no plano da frente
+	gl_Position.z = mix(0.999, -0.999, inst_edges1.z);
+ }
+ )";
+
+// Código fonte do Fragment Shader (em GLSL): ainda hardcoded
+const GLchar *fragmentShaderSource = R"(
+ #version 400
+in vec2 tex_coord;
+in float shade;
+flat in int texture_index;
+out vec4 color;
+uniform sampler2D tex_tiles;
+uniform sampler2D tex_sprites;
+void main()
+{
+	vec4 tile = texture(tex_tiles, tex_coord);
+	vec4 sprite = texture(tex_sprites, tex_coord);
+	vec4 c = texture_index == 0 ? tile : sprite;
+	if (c.a < 0.5)
+		discard; // recorte do sprite: quem está atrás aparece pelo depth buffer
+	color = vec4(c.rgb * shade, 1.0);
+}
+)";
+
+// Buffer de streaming (3 regiões) com as instâncias de cada frame
+StreamBuffer streamBuffer;
+
+// Medição de tempos por frame (P grava o trace em frame_trace.json)
+FrameProfiler profiler;
+
+// Modo de ritmo dos frames (V alterna entre os modos; --pacing/--fps na linha de comando)
+FramePacer pacer;
+BenchmarkHarness benchmark(profiler);
+
+bool keys[1024];
+
+// Mapa (IDs do tileset, linha após linha), colisão e projeção
+int mapSize = 256;
+vector<int> tiles;
+TileCollisionLayer collision;
+IsoProjection iso;
+
+// Câmera da cena (o zoom também muda pela roda do mouse, em scroll_callback)
+Camera2D camera(WIDTH, HEIGHT);
+
+// Sprites e seus clipes
+Walkers walkers;
+SpatialGrid walkerGrid(4.0); // células de 4x4 tiles, em (u, v)
+AnimationLibrary enemyClips;
+AnimationPlayers animations(enemyClips);
+
+// Função MAIN
+int main(int argc, char **argv)
+{
+	int nSprites = 2000;
+	for (int i = 1; i < argc - 1; i++)
+	{
+		if (strcmp(argv[i], "--map") == 0)
+			mapSize = atoi(argv[i + 1]);
+		if (strcmp(argv[i], "--sprites") == 0)
+			nSprites = atoi(argv[i + 1]);
+	}
+	if (mapSize < 4)
+		mapSize = 4;
+	if (nSprites < 0)
+		nSprites = 0;
+
+	for (int i = 0; i < 1024; i++)
+	{
+		keys[i] = false;
+	}
+
+	// Inicialização da GLFW (no modo benchmark sem display, com a plataforma nula)
+	if (!benchmark.parseArgs(argc, argv))
+	{
+		std::cout << "Opcoes de benchmark invalidas" << std::endl;
+		return 1;
+	}
+	if (!benchmark.initGLFW())
+		return -1;
+
+	// Criação da janela GLFW
+	GLFWwindow *window = benchmark.createWindow(WIDTH, HEIGHT, "Ola Isometrico! -- Rossana");
+	if (!window)
+	{
+		std::cerr << "Falha ao criar a janela GLFW" << std::endl;
+		glfwTerminate();
+		return -1;
+	}
+	glfwMakeContextCurrent(window);
+
+	// Fazendo o registro da função de callback para a janela GLFW
+	glfwSetKeyCallback(window, key_callback);
+	glfwSetScrollCallback(window, scroll_callback);
+
+	// GLAD: carrega todos os ponteiros d funções da OpenGL
+	if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+	{
+		std::cerr << "Falha ao inicializar GLAD" << std::endl;
+		return -1;
+	}
+
+	// Obtendo as informações de versão
+	const GLubyte *renderer = glGetString(GL_RENDERER); /* get renderer string */
+	const GLubyte *version = glGetString(GL_VERSION);	/* version as a string */
+	cout << "Renderer: " << renderer << endl;
+	cout << "OpenGL version supported " << version << endl;
+
+	// Definindo as dimensões da viewport com as mesmas dimensões da janela da aplicação
+	int width, height;
+	glfwGetFramebufferSize(window, &width, &height);
+	glViewport(0, 0, width, height);
+
+	// Carrega as funções posteriores ao OpenGL 4.0 (glBufferStorage)
+	loadGLExt();
+
+	// Compilando e buildando o programa de shader
+	GLuint shaderID = setupShader();
+	GLuint VAO = setupQuad();
+	streamBuffer.init(MAX_INSTANCES * sizeof(IsoInstance));
+
+	GLuint tilesTexID = loadTexture("../assets/tilesets/tileset.png");
+	if (!enemyClips.load("../assets/sprites/enemies-spritesheet1.json"))
+	{
+		glfwTerminate();
+		return -1;
+	}
+	GLuint spritesTexID = loadTexture(enemyClips.texturePath);
+
+	// Mapa sempre igual (semente fixa), para o benchmark e a imagem de referência.
+	// A colisão usa as coordenadas do mapa: tile de 1x1, linha 0 em y = 0 e y = -v.
+	generateMap(tiles, mapSize);
+	collision.build(tiles.data(), mapSize, mapSize, tileFlags, N_TILES, 1.0, 1.0, 0.0, 0.0);
+	if (!spawnWalkers(walkers, nSprites, collision))
+	{
+		glfwTerminate();
+		return -1;
+	}
+
+	iso.tileW = TILE_W;
+	iso.tileH = TILE_H;
+	iso.originX = 0.0;
+	iso.originY = 0.0;
+
+	// Câmera começa no centro do mapa
+	iso.toScreen(mapSize * 0.5f, mapSize * 0.5f, camera.center.x, camera.center.y);
+
+	cout << "Mapa " << mapSize << "x" << mapSize << ", " << walkers.u.size() << " sprites" << endl;
+
+	glUseProgram(shaderID);
+	glUniform1i(glGetUniformLocation(shaderID, "tex_tiles"), 0);
+	glUniform1i(glGetUniformLocation(shaderID, "tex_sprites"), 1);
+	glActiveTexture(GL_TEXTURE0);
+	glBindTexture(GL_TEXTURE_2D, tilesTexID);
+	glActiveTexture(GL_TEXTURE1);
+	glBindTexture(GL_TEXTURE_2D, spritesTexID);
+	glActiveTexture(GL_TEXTURE0);
+
+	// Queries de tempo da GPU e, no modo benchmark, o FBO de destino
+	benchmark.setup();
+
+	// Intervalo de swap conforme o modo de ritmo (o benchmark sempre roda sem limite)
+	pacer.parseArgs(argc, argv);
+	if (benchmark.enabled())
+		pacer.setMode(PACE_UNTHROTTLED);
+	else
+		pacer.apply();
+
+	double prev_s = glfwGetTime();	// Define o "tempo anterior" inicial.
+	double title_countdown_s = 0.5; // Intervalo para atualizar o título da janela com as estatísticas.
+
+	// Movimento e animação avançam em passos fixos de 1/60 s, independentes do FPS
+	FixedTimestep gameLoop(1.0 / 60.0, 5);
+	double sim_prev_s = glfwGetTime();
+
+	// Ordem de desenho decidida pelo depth buffer; sem blending
+	glEnable(GL_DEPTH_TEST);
+	glDepthFunc(GL_LESS);
+
+	int drawn = 0;
+
+	// Loop da aplicação - "game loop"
+	while (benchmark.running(window))
+	{
+		// Início da medição do frame (CPU e GPU)
+		benchmark.beginFrame();
+
+		// Mostra as estatísticas do profiler na barra de título, algumas vezes por segundo
+		{
+			double curr_s = glfwGetTime();
+			title_countdown_s -= curr_s - prev_s;
+			prev_s = curr_s;
+			if (title_countdown_s <= 0.0)
+			{
+				char pacing[128];
+				pacer.describe(pacing, sizeof(pacing));
+				string title = "Ola Isometrico! -- Rossana | " + to_string(drawn) + " instancias | " +
+							   profiler.summary() + " | " + pacing;
+				glfwSetWindowTitle(window, title.c_str());
+				title_countdown_s = 0.5;
+			}
+		}
+
+		// Checa se houveram eventos de input (key pressed, mouse moved etc.) e chama as funções de callback correspondentes
+		glfwPollEvents();
+		pacer.markInput();
+
+		// Limpa o buffer de cor e o de profundidade
+		glClearColor(0.0f, 0.0f, 0.0f, 1.0f); // cor de fundo
+		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+		// Passa para a próxima região do buffer de streaming (espera a GPU só se necessário)
+		streamBuffer.beginFrame();
+
+		// Simulação em passos fixos. No benchmark cada frame vale exatamente um passo,
+		// para que o frame capturado seja sempre o mesmo
+		double sim_curr_s = glfwGetTime();
+		double sim_elapsed_s = benchmark.enabled() ? gameLoop.step() : sim_curr_s - sim_prev_s;
+		sim_prev_s = sim_curr_s;
+		int steps = gameLoop.advance(sim_elapsed_s);
+		{
+			ProfileScope cpu(profiler, "update");
+			for (int i = 0; i < steps; i++)
+			{
+				float dt = (float)gameLoop.step();
+				if (keys[GLFW_KEY_LEFT] || keys[GLFW_KEY_A])
+					camera.pan(vec2(-CAMERA_SPEED * dt, 0.0));
+				if (keys[GLFW_KEY_RIGHT] || keys[GLFW_KEY_D])
+					camera.pan(vec2(CAMERA_SPEED * dt, 0.0));
+				if (keys[GLFW_KEY_UP] || keys[GLFW_KEY_W])
+					camera.pan(vec2(0.0, CAMERA_SPEED * dt));
+				if (keys[GLFW_KEY_DOWN] || keys[GLFW_KEY_S])
+					camera.pan(vec2(0.0, -CAMERA_SPEED * dt));
+				if (keys[GLFW_KEY_Q])
+					camera.zoomAt(camera.viewport * 0.5f, exp2f(-dt));
+				if (keys[GLFW_KEY_E])
+					camera.zoomAt(camera.viewport * 0.5f, exp2f(dt));
+				updateWalkers(walkers, dt, collision);
+				animations.update(dt);
+			}
+		}
+
+		// Roteiro do benchmark: a câmera dá uma volta sobre o mapa, passando por tiles e
+		// sprites diferentes a cada frame
+		if (benchmark.enabled())
+		{
+			float angle = benchmark.progress() * 6.2831853f;
+			iso.toScreen(mapSize * (0.5f + 0.3f * cosf(angle)), mapSize * (0.5f + 0.3f * sinf(angle)), camera.center.x,
+						 camera.center.y);
+		}
+
+		// Projeção ortográfica do que a câmera enxerga
+		glUniformMatrix4fv(glGetUniformLocation(shaderID, "projection"), 1, GL_FALSE, value_ptr(camera.projection()));
+
+		{
+			ProfileScope cpu(profiler, "tilemap");
+			GpuProfileScope gpu(profiler, "tilemap");
+			drawn = drawScene(shaderID, VAO, gameLoop.alpha());
+		}
+
+		// Marca o fim do uso da região deste frame
+		streamBuffer.endFrame();
+		benchmark.endFrame();
+
+		// Troca os buffers da tela (com a espera do modo de ritmo) e mede a latência
+		pacer.present(window);
+	}
+	profiler.printStats();
+	// Relatório do benchmark e, se pedida, comparação com a imagem de referência
+	bool passed = benchmark.finish("iso");
+	profiler.destroy();
+	streamBuffer.destroy();
+	glDeleteVertexArrays(1, &VAO);
+	// Finaliza a execução da GLFW, limpando os recursos alocados por ela
+	glfwTerminate();
+	return passed ? 0 : 1;
+}
+
+// Função de callback de teclado - só pode ter uma instância (deve ser estática se
+// estiver dentro de uma classe) - É chamada sempre que uma tecla for pressionada
+// ou solta via GLFW
+void key_callback(GLFWwindow *window, int key, int scancode, int action, int mode)
+{
+	if (key == GLFW_KEY_ESCAPE && action == GLFW_PRESS)
+		glfwSetWindowShouldClose(window, GL_TRUE);
+
+	if (key == GLFW_KEY_P && action == GLFW_PRESS)
+	{
+		if (profiler.exportChromeTrace("frame_trace.json"))
+			cout << "Trace gravado em frame_trace.json (abrir em ui.perfetto.dev)" << endl;
+	}
+
+	if (key == GLFW_KEY_V && action == GLFW_PRESS)
+	{
+		pacer.cycleMode();
+		cout << "Ritmo dos frames: " << FramePacer::modeName(pacer.currentMode()) << endl;
+	}
+
+	if (key >= 0 && key < 1024)
+	{
+		if (action == GLFW_PRESS)
+			keys[key] = true;
+		else if (action == GLFW_RELEASE)
+			keys[key] = false;
+	}
+}
+
+// Roda do mouse: zoom em torno do ponto sob o cursor
+void scroll_callback(GLFWwindow *window, double xoffset, double yoffset)
+{
+	double mx, my;
+	int winW, winH;
+	glfwGetCursorPos(window, &mx, &my);
+	glfwGetWindowSize(window, &winW, &winH);
+	camera.zoomAt(vec2(mx * WIDTH / winW, HEIGHT - my * HEIGHT / winH), powf(1.1f, (float)yoffset));
+}
+
+// Esta função está bastante hardcoded - objetivo é compilar e "buildar" um programa de
+//  shader simples e único neste exemplo de código
+//  O código fonte do vertex e fragment shader está nos arrays vertexShaderSource e
+//  fragmentShader source no iniçio deste arquivo
+//  A função retorna o identificador do programa de shader
+int setupShader()
+{
+	// Vertex shader
+	GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
+	glShaderSource(vertexShader, 1, &vertexShaderSource, NULL);
+	glCompileShader(vertexShader);
+	// Checando erros de compilação (exibição via log no terminal)
+	GLint success;
+	GLchar infoLog[512];
+	glGetShaderiv(vertexShader, GL_COMPILE_STATUS, &success);
+	if (!success)
+	{
+		glGetShaderInfoLog(vertexShader, 512, NULL, infoLog);
+		std::cout << "ERROR::SHADER::VERTEX::COMPILATION_FAILED\n"
+				  << infoLog << std::endl;
+	}
+	// Fragment shader
+	GLuint fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
+	glShaderSource(fragmentShader, 1, &fragmentShaderSource, NULL);
+	glCompileShader(fragmentShader);
+	// Checando erros de compilação (exibição via log no terminal)
+	glGetShaderiv(fragmentShader, GL_COMPILE_STATUS, &success);
+	if (!success)
+	{
+		glGetShaderInfoLog(fragmentShader, 512, NULL, infoLog);
+		std::cout << "ERROR::SHADER::FRAGMENT::COMPILATION_FAILED\n"
+				  << infoLog << std::endl;
+	}
+	// Linkando os shaders e criando o identificador do programa de shader
+	GLuint shaderProgram = glCreateProgram();
+	glAttachShader(shaderProgram, vertexShader);
+	glAttachShader(shaderProgram, fragmentShader);
+	glLinkProgram(shaderProgram);
+	// Checando por erros de linkagem
+	glGetProgramiv(shaderProgram, GL_LINK_STATUS, &success);
+	if (!success)
+	{
+		glGetProgramInfoLog(shaderProgram, 512, NULL, infoLog);
+		std::cout << "ERROR::SHADER::PROGRAM::LINKING_FAILED\n"
+				  << infoLog << std::endl;
+	}
+	glDeleteShader(vertexShader);
+	glDeleteShader(fragmentShader);
+
+	return shaderProgram;
+}
+
+// Quad unitário: só as coordenadas (0..1) de cada canto. A forma na tela vem das
+// arestas de cada instância. Os atributos por instância (1 a 4) ficam habilitados no
+// VAO; seus ponteiros são definidos a cada frame em drawScene.
+int setupQuad()
+{
+	GLfloat vertices[] = {
+		// s    t
+		0.0, 0.0,
+		0.0, 1.0,
+		1.0, 0.0,
+		0.0, 1.0,
+		1.0, 1.0,
+		1.0, 0.0,
+	};
+
+	GLuint VBO, VAO;
+	glGenBuffers(1, &VBO);
+	glBindBuffer(GL_ARRAY_BUFFER, VBO);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+
+	glGenVertexArrays(1, &VAO);
+	glBindVertexArray(VAO);
+
+	// Ponteiro pro atributo 0 - Coordenada no quad (e na textura) - s, t
+	glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(GLfloat), (GLvoid *)0);
+	glEnableVertexAttribArray(0);
+
+	// Atributos por instância: avançam um elemento a cada instância, não a cada vértice
+	for (GLuint loc = 1; loc <= 4; loc++)
+	{
+		glEnableVertexAttribArray(loc);
+		glVertexAttribDivisor(loc, 1);
+	}
+
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glBindVertexArray(0);
+
+	return VAO;
+}
+
+int loadTexture(string filePath)
+{
+	GLuint texID;
+
+	// Gera o identificador da textura na memória
+	glGenTextures(1, &texID);
+	glBindTexture(GL_TEXTURE_2D, texID);
+
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+	int width, height, nrChannels;
+
+	unsigned char *data = stbi_load(filePath.c_str(), &width, &height, &nrChannels, 0);
+
+	if (data)
+	{
+		if (nrChannels == 3) // jpg, bmp
+		{
+			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, data);
+		}
+		else // png
+		{
+			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
+		}
+		glGenerateMipmap(GL_TEXTURE_2D);
+	}
+	else
+	{
+		std::cout << "Failed to load texture" << std::endl;
+	}
+
+	stbi_image_free(data);
+
+	glBindTexture(GL_TEXTURE_2D, 0);
+
+	return texID;
+}
+
+// Grama e areia com lagos (gelo em volta de água funda), pedras e um pouco de lava
+void generateMap(vector<int> &tiles, int n)
+{
+	mt19937 rng(40);
+	uniform_real_distribution<float> unit(0.0, 1.0);
+	tiles.assign((size_t)n * n, 1);
+
+	for (size_t i = 0; i < tiles.size(); i++)
+	{
+		float r = unit(rng);
+		if (r < 0.15)
+			tiles[i] = 0;
+		else if (r < 0.21)
+			tiles[i] = ROCK;
+		else if (r < 0.215)
+			tiles[i] = 3;
+	}
+
+	int nLakes = n * n / 2048 + 1;
+	uniform_int_distribution<int> pos(0, n - 1), radius(2, 6);
+	for (int k = 0; k < nLakes; k++)
+	{
+		int cr = pos(rng), cc = pos(rng), rad = radius(rng);
+		for (int r = cr - rad - 1; r <= cr + rad + 1; r++)
+		{
+			for (int c = cc - rad - 1; c <= cc + rad + 1; c++)
+			{
+				if (r < 0 || c < 0 || r >= n || c >= n)
+					continue;
+				int d2 = (r - cr) * (r - cr) + (c - cc) * (c - cc);
+				if (d2 <= rad * rad)
+					tiles[(size_t)r * n + c] = 5;
+				else if (d2 <= (rad + 1) * (rad + 1))
+					tiles[(size_t)r * n + c] = 4;
+			}
+		}
+	}
+}
+
+// Sprites em células livres, com velocidade e clipe sorteados (false se faltar um clipe)
+bool spawnWalkers(Walkers &walkers, int n, const TileCollisionLayer &layer)
+{
+	mt19937 rng(2025);
+	uniform_int_distribution<int> cell(0, layer.cols - 1);
+	uniform_real_distribution<float> vel(-1.5, 1.5); // tiles por segundo
+	uniform_int_distribution<int> kind(0, 11);
+	const char *families[3] = {"blob", "voador", "andador"};
+	// Os 12 clipes são buscados uma vez; falta de um deles no .json impede o início
+	int clips[12];
+	for (int k = 0; k < 12; k++)
+	{
+		clips[k] = enemyClips.requireClip((string(families[k / 4]) + "_" + to_string(k % 4)).c_str());
+		if (clips[k] < 0)
+			return false;
+	}
+
+	for (int i = 0; i < n; i++)
+	{
+		int c, r, tries = 0;
+		do
+		{
+			c = cell(rng);
+			r = cell(rng);
+		} while (layer.solidAt(c, r) && ++tries < 100);
+		if (layer.solidAt(c, r))
+			continue;
+
+		int k = kind(rng);
+		walkers.u.push_back(c + 0.5f);
+		walkers.v.push_back(r + 0.5f);
+		walkers.vu.push_back(vel(rng));
+		walkers.vv.push_back(vel(rng));
+		walkers.anim.push_back(animations.add(clips[k]));
+		walkerGrid.insert((int)walkers.u.size() - 1, c + 0.5f, r + 0.5f, WALKER_HALF, WALKER_HALF);
+	}
+	walkers.prevU = walkers.u;
+	walkers.prevV = walkers.v;
+	return true;
+}
+
+// Um passo fixo: cada sprite anda pela sua velocidade e volta ao bater numa parede.
+// A camada de colisão tem y = -v (linha 0 no topo, y crescendo para cima).
+void updateWalkers(Walkers &walkers, float dt, const TileCollisionLayer &layer)
+{
+	CharacterController controller(WALKER_HALF, WALKER_HALF);
+	for (size_t i = 0; i < walkers.u.size(); i++)
+	{
+		walkers.prevU[i] = walkers.u[i];
+		walkers.prevV[i] = walkers.v[i];
+		float x = walkers.u[i], y = -walkers.v[i];
+		controller.move(layer, x, y, walkers.vu[i] * dt, -walkers.vv[i] * dt);
+		walkers.u[i] = x;
+		walkers.v[i] = -y;
+		if (controller.hitX)
+			walkers.vu[i] = -walkers.vu[i];
+		if (controller.hitY)
+			walkers.vv[i] = -walkers.vv[i];
+		walkerGrid.update((int)i, walkers.u[i], walkers.v[i]);
+	}
+}
+
+// Paralelogramo de um tile ou face, com o tile id do tileset
+static void tileInstance(IsoInstance &inst, float ox, float oy, float e1x, float e1y, float e2x, float e2y,
+						 int id, float depth, float shade)
+{
+	inst.ox = ox;
+	inst.oy = oy;
+	inst.e1x = e1x;
+	inst.e1y = e1y;
+	inst.e2x = e2x;
+	inst.e2y = e2y;
+	inst.depth = depth;
+	inst.shade = shade;
+	inst.s0 = id / (float)TILESET_COLUMNS;
+	inst.t0 = 0.0;
+	inst.s1 = (id + 1) / (float)TILESET_COLUMNS;
+	inst.t1 = 1.0;
+	inst.texture = 0;
+}
+
+// Monta e desenha o frame com uma única chamada instanciada: chão e blocos dos tiles
+// visíveis e os sprites visíveis, na ordem em que aparecem. Quem fica na frente é
+// decidido pelo depth buffer. Retorna o número de instâncias desenhadas.
+int drawScene(GLuint shaderID, GLuint VAO, float alpha)
+{
+	StreamAlloc alloc = streamBuffer.allocate(MAX_INSTANCES * sizeof(IsoInstance));
+	if (!alloc.ptr)
+	{
+		return 0;
+	}
+	IsoInstance *inst = (IsoInstance *)alloc.ptr;
+	int n = 0;
+
+	float hw = TILE_W / 2, hh = TILE_H / 2;
+
+	// Blocos e sprites sobem acima do próprio losango: a borda de baixo da tela é
+	// estendida para incluir os que estão logo abaixo dela
+	float reach = BLOCK_HEIGHT > SPRITE_SIZE ? BLOCK_HEIGHT : SPRITE_SIZE;
+	float minX, minY, maxX, maxY;
+	camera.visibleRect(minX, minY, maxX, maxY);
+	float screenBottom = minY;
+	minY -= reach;
+
+	iso.forEachVisible(mapSize, mapSize, minX, minY, maxX, maxY, [&](int c, int r) {
+		if (n + 3 > MAX_INSTANCES)
+			return;
+		int id = tiles[(size_t)r * mapSize + c];
+		float tx, ty; // canto superior do losango
+		iso.toScreen((float)c, (float)r, tx, ty);
+		if (id != ROCK)
+		{
+			// Chão: atrás de tudo
+			tileInstance(inst[n++], tx, ty, hw, -hh, -hw, -hh, id, 0.0, 1.0);
+			return;
+		}
+		// Bloco: topo elevado e as faces esquerda e direita, todos com a chave do centro do tile
+		float depth = IsoProjection::depthKey(c + 0.5f, r + 0.5f, mapSize, mapSize);
+		tileInstance(inst[n++], tx, ty + BLOCK_HEIGHT, hw, -hh, -hw, -hh, id, depth, 1.0);
+		tileInstance(inst[n++], tx - hw, ty - hh + BLOCK_HEIGHT, hw, -hh, 0.0, -BLOCK_HEIGHT, id, depth, 0.75);
+		tileInstance(inst[n++], tx, ty - TILE_H + BLOCK_HEIGHT, hw, hh, 0.0, -BLOCK_HEIGHT, id, depth, 0.55);
+	});
+
+	// Sprites: só os da grade em volta da região visível. O retângulo da tela vira um
+	// losango no mapa; a consulta usa a caixa dele, com 1 tile de folga para o sprite que
+	// sobe acima dos pés e para a interpolação
+	float u0 = 1e30f, v0 = 1e30f, u1 = -1e30f, v1 = -1e30f;
+	float cornerX[4] = {minX, maxX, minX, maxX}, cornerY[4] = {minY, minY, maxY, maxY};
+	for (int k = 0; k < 4; k++)
+	{
+		float cu, cv;
+		iso.toMap(cornerX[k], cornerY[k], cu, cv);
+		u0 = fminf(u0, cu);
+		v0 = fminf(v0, cv);
+		u1 = fmaxf(u1, cu);
+		v1 = fmaxf(v1, cv);
+	}
+	// (recortada ao mapa, para o zoom afastado não visitar células vazias)
+	u0 = fmaxf(u0 - 1.0f, 0.0f);
+	v0 = fmaxf(v0 - 1.0f, 0.0f);
+	u1 = fminf(u1 + 1.0f, (float)mapSize);
+	v1 = fminf(v1 + 1.0f, (float)mapSize);
+	walkerGrid.queryRect(u0, v0, u1, v1, [&](int i) {
+		if (n >= MAX_INSTANCES)
+			return;
+		float u = walkers.prevU[i] + (walkers.u[i] - walkers.prevU[i]) * alpha;
+		float v = walkers.prevV[i] + (walkers.v[i] - walkers.prevV[i]) * alpha;
+		float fx, fy;
+		iso.toScreen(u, v, fx, fy);
+		if (fx + SPRITE_SIZE / 2 < minX || fx - SPRITE_SIZE / 2 > maxX || fy > maxY || fy + SPRITE_SIZE < screenBottom)
+			return;
+		IsoInstance &s = inst[n++];
+		s.ox = fx - SPRITE_SIZE / 2;
+		s.oy = fy + SPRITE_SIZE;
+		s.e1x = SPRITE_SIZE;
+		s.e1y = 0.0;
+		s.e2x = 0.0;
+		s.e2y = -SPRITE_SIZE;
+		s.depth = IsoProjection::depthKey(u, v, mapSize, mapSize);
+		s.shade = 1.0;
+		UVRect uv = animations.uv(walkers.anim[i]);
+		s.s0 = uv.s0;
+		s.t0 = uv.t0;
+		s.s1 = uv.s1;
+		s.t1 = uv.t1;
+		s.texture = 1;
+	});
+	streamBuffer.flush(alloc);
+
+	glUseProgram(shaderID);
+	glBindVertexArray(VAO);
+
+	// Aponta os atributos de instância para o trecho reservado neste frame
+	glBindBuffer(GL_ARRAY_BUFFER, streamBuffer.buffer());
+	glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(IsoInstance), (GLvoid *)(alloc.offset));
+	glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(IsoInstance), (GLvoid *)(alloc.offset + 4 * sizeof(GLfloat)));
+	glVertexAttribPointer(3, 4, GL_FLOAT, GL_FALSE, sizeof(IsoInstance), (GLvoid *)(alloc.offset + 8 * sizeof(GLfloat)));
+	glVertexAttribIPointer(4, 1, GL_INT, sizeof(IsoInstance), (GLvoid *)(alloc.offset + 12 * sizeof(GLfloat)));
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	// Chamada de desenho - uma só para chão, blocos e sprites
+	glDrawArraysInstanced(GL_TRIANGLES, 0, 6, n);
+
+	glBindVertexArray(0);
+	return n;
+}
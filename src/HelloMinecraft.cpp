@@ -1,10 +1,25 @@
 #include <iostream>
+#include <vector>
+#include <cstring>
+#include <algorithm>
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
+// UBO compartilhado com as matrizes da câmera
+#include "CameraUBO.h"
+
+// Fila de desenho ordenada
+#include "RenderQueue.h"
+
+// Oclusão ambiente por vértice (3 vizinhos de cada canto)
+#include "VoxelAO.h"
+
+// Modo benchmark: --benchmark N roda N frames sem janela visível e grava os tempos em JSON
+#include "Benchmark.h"
+
 // STB_IMAGE
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb_image.h>
@@ -26,6 +41,7 @@ bool firstMouse = true;
 float lastX = WIDTH / 2.0f;
 float lastY = HEIGHT / 2.0f;
 float fov = 45.0f;
+const float zNear = 0.1f, zFar = 100.0f;
 
 // Controle de tempo entre frames
 float deltaTime = 0.0f;
@@ -35,6 +51,9 @@ float lastFrame = 0.0f;
 GLuint shaderID, VAO;
 GLFWwindow *window;
 
+// Matrizes da câmera compartilhadas entre os programas de shader
+CameraUBO cameraUBO;
+
 struct Voxel
 {
     glm::vec3 pos;
@@ -63,19 +82,36 @@ glm::vec4 colorList[] = {
 // "Paleta" de blocos -- IDs das texturas
 GLuint texIDList[10];
 
+// Índices da paleta cujas texturas têm transparência (empty e glass)
+bool texTransparente[10] = {true, false, true};
+
+// Fila de desenho: ordena os voxels por camada, opacidade, estado e profundidade
+RenderQueue renderQueue;
+
+FrameProfiler profiler;
+BenchmarkHarness benchmark(profiler);
+
 // Código do Vertex Shader
 const GLchar *vertexShaderSource = R"glsl(
  #version 450
  layout (location = 0) in vec3 position;
  layout (location = 1) in vec2 texc;
+ layout (location = 2) in float ao;
  
- uniform mat4 view;
- uniform mat4 proj;
+ layout (std140, binding = 0) uniform Camera
+ {
+     mat4 view;
+     mat4 proj;
+     mat4 viewProj;
+     vec4 cameraPos;
+ };
  uniform mat4 model;
  out vec2 tex_coord;
+ out float ao_factor;
  void main()
  {
 	tex_coord = vec2(texc.s,1.0-texc.t);
+	ao_factor = 0.4 + 0.6 * ao / 3.0;
 	gl_Position =  proj * view * model * vec4(position, 1.0);
  }
  )glsl";
@@ -84,16 +120,19 @@ const GLchar *vertexShaderSource = R"glsl(
 const GLchar *fragmentShaderSource = R"glsl(
  #version 450
 in vec2 tex_coord;
+in float ao_factor;
 out vec4 color;
 uniform sampler2D tex_buff;
 void main()
 {
 	 color = texture(tex_buff,tex_coord);
+	 color.rgb *= ao_factor;
 }
 )glsl";
 
 // Cabeçalhos de algumas função
-int loadTexture(string filePath); 
+int loadTexture(string filePath);
+void atualizaOclusao(int y, int x, int z);
 
 // Atualiza o viewport ao redimensionar a janela
 void framebuffer_size_callback(GLFWwindow *window, int width, int height)
@@ -261,6 +300,11 @@ void key_callback(GLFWwindow *window, int key, int scancode, int action, int mod
         grid[selecaoY][selecaoX][selecaoZ].texID = texID_atual;
     }
 
+    // Visibilidade ou textura mudou: a oclusão dos voxels em volta é refeita
+    bool mudouBloco = action == GLFW_PRESS && (key == GLFW_KEY_DELETE || key == GLFW_KEY_V || key == GLFW_KEY_SPACE);
+    if (mudouBloco || mudouCor)
+        atualizaOclusao(selecaoY, selecaoX, selecaoZ);
+
     // printf("\n\n\n");
 }
 
@@ -280,23 +324,15 @@ void processInput(GLFWwindow *window)
         cameraPos += glm::normalize(glm::cross(cameraFront, cameraUp)) * cameraSpeed;
 }
 
-// Define a matriz de visualização usando a posição e direção da câmera
-void especificaVisualizacao()
-{
-    glm::mat4 view = glm::lookAt(cameraPos, cameraPos + cameraFront, cameraUp);
-    GLuint loc = glGetUniformLocation(shaderID, "view");
-    glUniformMatrix4fv(loc, 1, GL_FALSE, glm::value_ptr(view));
-}
-
-// Define a matriz de projeção perspectiva com base no FOV
-void especificaProjecao()
+// Atualiza as matrizes de visualização e projeção no UBO da câmera.
+// Só recalcula e envia quando posição, direção ou FOV mudaram desde o último frame;
+// todos os programas que declaram o bloco Camera leem o mesmo buffer.
+void especificaCamera()
 {
-    glm::mat4 proj = glm::perspective(glm::radians(fov), (float)WIDTH / HEIGHT, 0.1f, 100.0f);
-    GLuint loc = glGetUniformLocation(shaderID, "proj");
-    glUniformMatrix4fv(loc, 1, GL_FALSE, glm::value_ptr(proj));
+    cameraUBO.update(cameraPos, cameraFront, cameraUp, fov, (float)WIDTH / HEIGHT, zNear, zFar);
 }
 
-void transformaObjeto(float xpos, float ypos, float zpos, float xrot, float yrot, float zrot, float sx, float sy, float sz)
+glm::mat4 calculaModelo(float xpos, float ypos, float zpos, float xrot, float yrot, float zrot, float sx, float sy, float sz)
 {
     glm::mat4 transform = glm::mat4(1.0f); // matriz identidade
 
@@ -309,6 +345,13 @@ void transformaObjeto(float xpos, float ypos, float zpos, float xrot, float yrot
 
     transform = glm::scale(transform, glm::vec3(sx, sy, sz));
 
+    return transform;
+}
+
+void transformaObjeto(float xpos, float ypos, float zpos, float xrot, float yrot, float zrot, float sx, float sy, float sz)
+{
+    glm::mat4 transform = calculaModelo(xpos, ypos, zpos, xrot, yrot, zrot, sx, sy, sz);
+
     // Envia os dados para o shader
     GLuint loc = glGetUniformLocation(shaderID, "model");
     glUniformMatrix4fv(loc, 1, GL_FALSE, glm::value_ptr(transform));
@@ -360,12 +403,9 @@ GLuint setupShader()
     return shaderProgram;
 }
 
-// Cria o VAO com os vértices e cores do cubo 3D
-GLuint setupGeometry()
-{
-
-   // Coords de texturas arrumadas!
-   GLfloat vertices[] = {
+// Cubo de referência, centrado na origem: 6 faces de 2 triângulos
+// Coords de texturas arrumadas!
+const GLfloat cubeVertices[] = {
     // Layout do vértice:
     // x   y     z    s    t
     // Face da frente (z = +0.5)
@@ -423,22 +463,108 @@ GLuint setupGeometry()
     -0.5,  0.5,  0.5, 0.0, 1.0   // frente esq
 };
 
-    GLuint VBO, vao;
+// Normal de cada face em cubeVertices (frente, trás, esquerda, direita, baixo, cima)
+const int normaisFaces[6][3] = {{0, 0, 1}, {0, 0, -1}, {-1, 0, 0}, {1, 0, 0}, {0, -1, 0}, {0, 1, 0}};
+
+// Cada voxel tem a sua cópia do cubo no VBO, com a oclusão ambiente em cada vértice:
+// x, y, z, s, t, ao
+const int FLOATS_VERTICE = 6;
+const int VERTICES_VOXEL = 36;
+GLuint VBO;
+
+int indiceVoxel(int y, int x, int z)
+{
+    return (y * TAM + x) * TAM + z;
+}
+
+// Um voxel faz sombra nos vizinhos se está visível e a textura dele é opaca
+bool voxelOpaco(int x, int y, int z)
+{
+    if (x < 0 || y < 0 || z < 0 || x >= TAM || y >= TAM || z >= TAM)
+        return false;
+    const Voxel &v = grid[y][x][z];
+    return v.visivel && !texTransparente[v.texID];
+}
+
+// Monta os 36 vértices do voxel (y, x, z): para cada face, os 4 cantos com a oclusão
+// dos 3 vizinhos de cada um, divididos em 2 triângulos pela diagonal mais clara
+void montaVerticesVoxel(int y, int x, int z, GLfloat *out)
+{
+    for (int f = 0; f < 6; f++)
+    {
+        // Cantos da face em ordem (topo dir, base dir, base esq, topo esq): os 3 primeiros
+        // vértices da face e o último (os outros 2 repetem cantos)
+        const GLfloat *cantos[4] = {&cubeVertices[(f * 6 + 0) * 5], &cubeVertices[(f * 6 + 1) * 5],
+                                    &cubeVertices[(f * 6 + 2) * 5], &cubeVertices[(f * 6 + 5) * 5]};
+        int ao[4];
+        for (int c = 0; c < 4; c++)
+        {
+            int offset[3] = {cantos[c][0] > 0.0f, cantos[c][1] > 0.0f, cantos[c][2] > 0.0f};
+            ao[c] = faceCornerAO(voxelOpaco, x, y, z, normaisFaces[f], offset);
+        }
+        int primeiro = aoFlipQuad(ao) ? 1 : 0;
+        const int ordem[6] = {0, 1, 2, 0, 2, 3};
+        for (int i = 0; i < 6; i++)
+        {
+            int c = (primeiro + ordem[i]) % 4;
+            memcpy(out, cantos[c], 5 * sizeof(GLfloat));
+            out[5] = (GLfloat)ao[c];
+            out += FLOATS_VERTICE;
+        }
+    }
+}
+
+// Refaz os vértices dos voxels em volta de (y, x, z), cuja oclusão depende dele.
+// No VBO, os vizinhos só são contíguos ao longo de z: um envio por (y, x)
+void atualizaOclusao(int y, int x, int z)
+{
+    GLfloat vertices[3 * VERTICES_VOXEL * FLOATS_VERTICE];
+    int z0 = max(z - 1, 0), z1 = min(z + 1, TAM - 1);
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    for (int vy = max(y - 1, 0); vy <= min(y + 1, TAM - 1); vy++)
+    {
+        for (int vx = max(x - 1, 0); vx <= min(x + 1, TAM - 1); vx++)
+        {
+            for (int vz = z0; vz <= z1; vz++)
+                montaVerticesVoxel(vy, vx, vz, &vertices[(vz - z0) * VERTICES_VOXEL * FLOATS_VERTICE]);
+            GLintptr offset = (GLintptr)indiceVoxel(vy, vx, z0) * VERTICES_VOXEL * FLOATS_VERTICE * sizeof(GLfloat);
+            glBufferSubData(GL_ARRAY_BUFFER, offset, (z1 - z0 + 1) * VERTICES_VOXEL * FLOATS_VERTICE * sizeof(GLfloat),
+                            vertices);
+        }
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+// Cria o VAO com os cubos de todos os voxels da grid (o voxel i usa os vértices
+// i * 36 .. i * 36 + 35, com a oclusão já calculada)
+GLuint setupGeometry()
+{
+    vector<GLfloat> vertices((size_t)TAM * TAM * TAM * VERTICES_VOXEL * FLOATS_VERTICE);
+    for (int y = 0; y < TAM; y++)
+        for (int x = 0; x < TAM; x++)
+            for (int z = 0; z < TAM; z++)
+                montaVerticesVoxel(y, x, z, &vertices[(size_t)indiceVoxel(y, x, z) * VERTICES_VOXEL * FLOATS_VERTICE]);
+
+    GLuint vao;
     glGenVertexArrays(1, &vao);
     glGenBuffers(1, &VBO);
 
     glBindVertexArray(vao);
     glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(GLfloat), vertices.data(), GL_DYNAMIC_DRAW);
 
     // 1 atributo - coordenadas x, y, z
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(GLfloat), (GLvoid *)0);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, FLOATS_VERTICE * sizeof(GLfloat), (GLvoid *)0);
     glEnableVertexAttribArray(0);
 
      // 2 atributo - coordenadas de textura s, t 
-    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(GLfloat), (GLvoid *)(3 * sizeof(GLfloat)));
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, FLOATS_VERTICE * sizeof(GLfloat), (GLvoid *)(3 * sizeof(GLfloat)));
     glEnableVertexAttribArray(1);
 
+    // 3 atributo - oclusão ambiente (0 = canto fechado, 3 = livre)
+    glVertexAttribPointer(2, 1, GL_FLOAT, GL_FALSE, FLOATS_VERTICE * sizeof(GLfloat), (GLvoid *)(5 * sizeof(GLfloat)));
+    glEnableVertexAttribArray(2);
+
     glBindBuffer(GL_ARRAY_BUFFER, 0);
     glBindVertexArray(0);
 
@@ -447,18 +573,34 @@ GLuint setupGeometry()
 
 
 // Função principal da aplicação
-int main()
+int main(int argc, char **argv)
 {
-    glfwInit();
-    window = glfwCreateWindow(WIDTH, HEIGHT, "Camera Cube", nullptr, nullptr);
+    if (!benchmark.parseArgs(argc, argv))
+    {
+        std::cout << "Opcoes de benchmark invalidas" << std::endl;
+        return 1;
+    }
+    if (!benchmark.initGLFW())
+        return -1;
+    window = benchmark.createWindow(WIDTH, HEIGHT, "Camera Cube");
+    if (!window)
+    {
+        glfwTerminate();
+        return -1;
+    }
     glfwMakeContextCurrent(window);
     glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
     glfwSetCursorPosCallback(window, mouse_callback);
     glfwSetScrollCallback(window, scroll_callback);
     glfwSetKeyCallback(window, key_callback);
-    glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+    if (!benchmark.enabled())
+        glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
 
     gladLoadGLLoader((GLADloadproc)glfwGetProcAddress);
+    benchmark.setup();
+
+    // Cria o UBO da câmera e o liga ao ponto fixo CAMERA_UBO_BINDING
+    cameraUBO.init();
 
     shaderID = setupShader();
     VAO = setupGeometry();
@@ -469,6 +611,10 @@ int main()
     glEnable(GL_BLEND);
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
+    // A camada de sobreposição (voxel selecionado) é desenhada sem teste de profundidade
+    renderQueue.setLayerDepthTest(LAYER_OVERLAY, false);
+    renderQueue.reserve(TAM * TAM * TAM + 1);
+
     //--------------------------
     texIDList[0] = loadTexture("../assets/block_tex/empty.png");
     texIDList[2] = loadTexture("../assets/block_tex/glass.png");
@@ -512,22 +658,29 @@ int main()
 	// Criando a variável uniform pra mandar a textura pro shader
 	glUniform1i(glGetUniformLocation(shaderID, "tex_buff"), 0);
 
-    while (!glfwWindowShouldClose(window))
+    while (benchmark.running(window))
     {
         float currentFrame = glfwGetTime();
         deltaTime = currentFrame - lastFrame;
         lastFrame = currentFrame;
 
-        processInput(window);
+        // Roteiro do benchmark: órbita em volta da grid; como a câmera muda de lado, a
+        // ordem dos voxels transparentes na fila muda a cada frame
+        if (benchmark.enabled())
+            benchmark.orbitCamera(glm::vec3(0.0f), 18.0f, 6.0f, cameraPos, cameraFront);
+        else
+            processInput(window);
+
+        benchmark.beginFrame();
 
         glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-        especificaVisualizacao();
-        especificaProjecao();
+        especificaCamera();
 
-        // renderizar os objetos
-        glBindVertexArray(VAO);
+        // Em vez de desenhar na ordem do laço, cada voxel é submetido à fila com sua chave;
+        // a fila separa opacos (frente para trás) de transparentes (trás para frente)
+        renderQueue.clear();
 
         // navega na grid tridimensional pelos seus índices
         for (int x = 0; x < TAM; x++)
@@ -536,53 +689,62 @@ int main()
             {
                 for (int z = 0; z < TAM; z++)
                 {
-                    
-                    //else{
-                    //    //setColor(shaderID, colorList[grid[y][x][z].corPos]);
-                    //    grid[selecaoY][selecaoX][selecaoZ].texID = 0;
-                    //}
                     //se for um voxel visivel
                     if (grid[y][x][z].visivel || grid[y][x][z].selecionado)
                     {
-                        float fatorEscala = grid[y][x][z].fatorEscala;
-                        transformaObjeto(grid[y][x][z].pos.x, grid[y][x][z].pos.y, grid[y][x][z].pos.z, 0.0f, 0.0f, 0.0f, fatorEscala, fatorEscala, fatorEscala);
-                        
-                        
                         GLuint texID = grid[y][x][z].texID;
                         if(grid[y][x][z].selecionado)
                         {
                             texID = 1; //usei moss como a cor do selecionado!
                         }
-                        glBindTexture(GL_TEXTURE_2D, texIDList[texID]); // Conectando ao buffer de textura
-                        
-                        if (texID == 0) //empty 
-                            glDisable(GL_DEPTH_TEST);
-
-                        glDrawArrays(GL_TRIANGLES, 0, 36);
-
-                        if (texID == 0) //empty 
-                        {
-                            glEnable(GL_DEPTH_TEST);
-                        }
 
+                        float fatorEscala = grid[y][x][z].fatorEscala;
+                        float dist = glm::length(grid[y][x][z].pos - cameraPos) / zFar;
+
+                        RenderCommand cmd;
+                        cmd.shaderID = shaderID;
+                        cmd.VAO = VAO;
+                        cmd.texID = texIDList[texID];
+                        cmd.mode = GL_TRIANGLES;
+                        cmd.first = indiceVoxel(y, x, z) * VERTICES_VOXEL;
+                        cmd.count = 36;
+                        cmd.model = calculaModelo(grid[y][x][z].pos.x, grid[y][x][z].pos.y, grid[y][x][z].pos.z, 0.0f, 0.0f, 0.0f, fatorEscala, fatorEscala, fatorEscala);
+                        cmd.offsetTex = glm::vec2(0.0f);
+                        cmd.key = RenderQueue::makeKey(LAYER_WORLD, texTransparente[texID], shaderID, cmd.texID, dist);
+                        renderQueue.submit(cmd);
                     }
                 }
             }
         }
 
-        //manda desenhar o selecionado de novo, para podermos enxergar sempre
+        //manda desenhar o selecionado de novo, na camada de sobreposição, para podermos enxergar sempre
         float fatorEscala = grid[selecaoY][selecaoX][selecaoZ].fatorEscala;
-        transformaObjeto(grid[selecaoY][selecaoX][selecaoZ].pos.x, grid[selecaoY][selecaoX][selecaoZ].pos.y, grid[selecaoY][selecaoX][selecaoZ].pos.z, 0.0f, 0.0f, 0.0f, fatorEscala, fatorEscala, fatorEscala);
-        glBindTexture(GL_TEXTURE_2D, texIDList[1]); // Conectando ao buffer de textura           
-        glDrawArrays(GL_TRIANGLES, 0, 36);
-
+        RenderCommand sel;
+        sel.shaderID = shaderID;
+        sel.VAO = VAO;
+        sel.texID = texIDList[1];
+        sel.mode = GL_TRIANGLES;
+        sel.first = indiceVoxel(selecaoY, selecaoX, selecaoZ) * VERTICES_VOXEL;
+        sel.count = 36;
+        sel.model = calculaModelo(grid[selecaoY][selecaoX][selecaoZ].pos.x, grid[selecaoY][selecaoX][selecaoZ].pos.y, grid[selecaoY][selecaoX][selecaoZ].pos.z, 0.0f, 0.0f, 0.0f, fatorEscala, fatorEscala, fatorEscala);
+        sel.offsetTex = glm::vec2(0.0f);
+        sel.key = RenderQueue::makeKey(LAYER_OVERLAY, false, shaderID, sel.texID, 0.0f);
+        renderQueue.submit(sel);
+
+        renderQueue.sort();
+        renderQueue.execute();
+
+        benchmark.endFrame();
         glfwSwapBuffers(window);
         glfwPollEvents();
     }
 
+    // Relatório do benchmark e, se pedida, comparação com a imagem de referência
+    bool passed = benchmark.finish("minecraft");
     glDeleteVertexArrays(1, &VAO);
+    glDeleteBuffers(1, &VBO);
     glfwTerminate();
-    return 0;
+    return passed ? 0 : 1;
 }
 
 int loadTexture(string filePath)
@@ -47,6 +47,13 @@ using namespace glm;
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb_image.h>
 
+// Modo benchmark (--benchmark N): roda N frames num FBO, sem janela visível
+#include "Benchmark.h"
+// Simulação em passo fixo
+#include "GameLoop.h"
+// Câmera 2D (deslocamento e zoom)
+#include "Camera2D.h"
+
 struct Sprite 
 {
 	GLuint VAO;
@@ -54,12 +61,13 @@ struct Sprite
 	vec3 pos;
 	vec3 dimensions;
 	float angle;
-	float vel; 
-
+	float vel; // pixels por passo de simulação
+	vec3 prevPos; // posição no passo anterior (para interpolar o desenho)
 };
 
 // Protótipo da função de callback de teclado
 void key_callback(GLFWwindow *window, int key, int scancode, int action, int mode);
+void scroll_callback(GLFWwindow *window, double xoffset, double yoffset);
 
 // Protótipos das funções
 int setupShader();
@@ -100,13 +108,25 @@ void main()
 
 bool keys[1024];
 
+// Câmera da cena: com zoom 1 mostra o fundo inteiro; Q/E ou a roda do mouse aproximam
+Camera2D camera(WIDTH, HEIGHT);
+
+FrameProfiler profiler;
+BenchmarkHarness benchmark(profiler);
+
 
 
 // Função MAIN
-int main()
+int main(int argc, char **argv)
 {
-	// Inicialização da GLFW
-	glfwInit();
+	// Inicialização da GLFW (no modo benchmark sem display, com a plataforma nula)
+	if (!benchmark.parseArgs(argc, argv))
+	{
+		std::cout << "Opcoes de benchmark invalidas" << std::endl;
+		return 1;
+	}
+	if (!benchmark.initGLFW())
+		return -1;
 
 	// Muita atenção aqui: alguns ambientes não aceitam essas configurações
 	// Você deve adaptar para a versão do OpenGL suportada por sua placa
@@ -128,7 +148,7 @@ int main()
 	for(int i=0; i<1024;i++) { keys[i] = false; }
 
 	// Criação da janela GLFW
-	GLFWwindow *window = glfwCreateWindow(WIDTH, HEIGHT, "Ola Triangulo! -- Rossana", nullptr, nullptr);
+	GLFWwindow *window = benchmark.createWindow(WIDTH, HEIGHT, "Ola Triangulo! -- Rossana");
 	if (!window)
 	{
 		std::cerr << "Falha ao criar a janela GLFW" << std::endl;
@@ -139,6 +159,7 @@ int main()
 
 	// Fazendo o registro da função de callback para a janela GLFW
 	glfwSetKeyCallback(window, key_callback);
+	glfwSetScrollCallback(window, scroll_callback);
 
 	// GLAD: carrega todos os ponteiros d funções da OpenGL
 	if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
@@ -158,6 +179,9 @@ int main()
 	glfwGetFramebufferSize(window, &width, &height);
 	glViewport(0, 0, width, height);
 
+	// FBO e queries de tempo do benchmark
+	benchmark.setup();
+
 	// Compilando e buildando o programa de shader
 	GLuint shaderID = setupShader();
 
@@ -177,6 +201,7 @@ int main()
 	spr1.pos = vec3(400,300,0);
 	spr1.dimensions = vec3(32 * 2, 26 * 2, 1);
 	spr1.vel = 1.5;
+	spr1.prevPos = spr1.pos;
 
 	spr2.VAO = VAO;
 	spr2.texID = loadTexture("../assets/sprites/microbio.png");
@@ -188,6 +213,10 @@ int main()
 	double prev_s = glfwGetTime();	// Define o "tempo anterior" inicial.
 	double title_countdown_s = 0.1; // Intervalo para atualizar o título da janela com o FPS.
 
+	// Movimento em passos fixos de 1/60 s (até 5 passos por frame para recuperar atrasos)
+	FixedTimestep gameLoop(1.0 / 60.0, 5);
+	double sim_prev_s = glfwGetTime();
+
 	float colorValue = 0.0;
 
 	// Ativando o primeiro buffer de textura do OpenGL
@@ -196,11 +225,9 @@ int main()
 	// Criando a variável uniform pra mandar a textura pro shader
 	glUniform1i(glGetUniformLocation(shaderID, "tex_buff"), 0);
 
-	// Criação da matriz de projeção paralela ortográfica
-	mat4 projection = mat4(1); // matriz identidade
-	projection = ortho(0.0, 800.0, 0.0, 600.0, -1.0, 1.0);
-	// Envio para o shader
-	glUniformMatrix4fv(glGetUniformLocation(shaderID, "projection"), 1, GL_FALSE, value_ptr(projection));
+	// A matriz de projeção ortográfica vem da câmera e é enviada a cada frame
+	camera.center = vec2(spr1.pos.x, spr1.pos.y);
+	camera.clampTo(0.0, 0.0, 800.0, 600.0);
 
 	//Habilitando transparência/função de mistura
 	glEnable(GL_BLEND);
@@ -211,7 +238,7 @@ int main()
 	glDepthFunc(GL_ALWAYS);
 
 	// Loop da aplicação - "game loop"
-	while (!glfwWindowShouldClose(window))
+	while (benchmark.running(window))
 	{
 		// Este trecho de código é totalmente opcional: calcula e mostra a contagem do FPS na barra de título
 		{
@@ -237,31 +264,67 @@ int main()
 		// Checa se houveram eventos de input (key pressed, mouse moved etc.) e chama as funções de callback correspondentes
 		glfwPollEvents();
 
+		benchmark.beginFrame();
+
 		// Limpa o buffer de cor
 		glClearColor(0.0f, 0.0f, 0.0f, 1.0f); // cor de fundo
 		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-		if (keys[GLFW_KEY_LEFT] == true || keys[GLFW_KEY_A] == true)
+		// Simulação: quantos passos fixos cabem no tempo decorrido. No benchmark, cada
+		// frame vale exatamente um passo (resultado independente da velocidade da máquina)
+		double sim_curr_s = glfwGetTime();
+		double sim_elapsed_s = benchmark.enabled() ? gameLoop.step() : sim_curr_s - sim_prev_s;
+		sim_prev_s = sim_curr_s;
+		int steps = gameLoop.advance(sim_elapsed_s);
+		for (int i = 0; i < steps; i++)
 		{
-			spr1.pos.x -= spr1.vel;		
+			spr1.prevPos = spr1.pos;
+			if (keys[GLFW_KEY_LEFT] == true || keys[GLFW_KEY_A] == true)
+			{
+				spr1.pos.x -= spr1.vel;
+			}
+			if (keys[GLFW_KEY_RIGHT] == true || keys[GLFW_KEY_D] == true)
+			{
+				spr1.pos.x += spr1.vel;
+			}
 		}
-		if (keys[GLFW_KEY_RIGHT] == true || keys[GLFW_KEY_D] == true)
+		// Roteiro do benchmark: o sprite atravessa a tela e volta
+		if (benchmark.enabled())
 		{
-			spr1.pos.x += spr1.vel;		
+			spr1.pos.x = 400.0 + 300.0 * sin(benchmark.progress() * 6.2831853);
+			spr1.prevPos = spr1.pos;
 		}
 
+		// Desenha o sprite entre a posição do passo anterior e a do atual
+		Sprite spr1Draw = spr1;
+		spr1Draw.pos = mix(spr1.prevPos, spr1.pos, gameLoop.alpha());
+
+		// Câmera: segue a posição desenhada do sprite (em frações de pixel), sem sair do fundo
+		float frame_dt = (float)sim_elapsed_s;
+		if (keys[GLFW_KEY_Q])
+			camera.zoomAt(camera.viewport * 0.5f, exp2f(-frame_dt));
+		if (keys[GLFW_KEY_E])
+			camera.zoomAt(camera.viewport * 0.5f, exp2f(frame_dt));
+		camera.follow(vec2(spr1Draw.pos.x, spr1Draw.pos.y), frame_dt, 0.12);
+		camera.clampTo(0.0, 0.0, 800.0, 600.0);
+		glUniformMatrix4fv(glGetUniformLocation(shaderID, "projection"), 1, GL_FALSE, value_ptr(camera.projection()));
+
 		drawSprite(shaderID,background);
-		drawSprite(shaderID,spr1);
+		drawSprite(shaderID,spr1Draw);
 		drawSprite(shaderID,spr2);
+
+		benchmark.endFrame();
 		
 		// Troca os buffers da tela
 		glfwSwapBuffers(window);
 	}
+	// Relatório do benchmark e, se pedida, comparação com a imagem de referência
+	bool passed = benchmark.finish("sprites");
 	// Pede pra OpenGL desalocar os buffers
 	glDeleteVertexArrays(1, &VAO);
 	// Finaliza a execução da GLFW, limpando os recursos alocados por ela
 	glfwTerminate();
-	return 0;
+	return passed ? 0 : 1;
 }
 
 // Função de callback de teclado - só pode ter uma instância (deve ser estática se
@@ -282,6 +345,16 @@ void key_callback(GLFWwindow *window, int key, int scancode, int action, int mod
 	}
 }
 
+// Roda do mouse: zoom em torno do ponto sob o cursor
+void scroll_callback(GLFWwindow *window, double xoffset, double yoffset)
+{
+	double mx, my;
+	int winW, winH;
+	glfwGetCursorPos(window, &mx, &my);
+	glfwGetWindowSize(window, &winW, &winH);
+	camera.zoomAt(vec2(mx * WIDTH / winW, HEIGHT - my * HEIGHT / winH), powf(1.1f, (float)yoffset));
+}
+
 // Esta função está bastante hardcoded - objetivo é compilar e "buildar" um programa de
 //  shader simples e único neste exemplo de código
 //  O código fonte do vertex e fragment shader está nos arrays vertexShaderSource e
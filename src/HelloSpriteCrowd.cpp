@@ -0,0 +1,812 @@
+/*
+ * Hello Sprite Crowd - multidão de sprites animados (até milhões) com uma só chamada de desenho
+ *
+ * Adaptado de HelloSpritesheet por: Rossana Baptista Queiroz
+ *
+ * Disciplinas:
+ *   - Processamento Gráfico (Ciência da Computação - Híbrido)
+ *   - Processamento Gráfico: Fundamentos (Ciência da Computação - Presencial)
+ *   - Fundamentos de Computação Gráfica (Jogos Digitais)
+ *
+ * Descrição:
+ *   Em vez de um struct Sprite por personagem, o estado de todos os sprites fica em
+ *   SpriteEntities (Common/SpriteEntities.h): um array para cada campo (posX, posY, velX,
+ *   velY, frame, animation...). A simulação atualiza 4 sprites por instrução (SSE2) e
+ *   divide o intervalo entre as threads do ThreadPool.
+ *
+ *   O desenho lê esses mesmos arrays: cada um é copiado inteiro para o StreamBuffer e vira
+ *   um atributo por instância (posX, posY, velX, velY, frame e animação), e o
+ *   vertex shader calcula o deslocamento na spritesheet. Não existe matriz model por sprite
+ *   nem glUniform por sprite: todos são desenhados com um glDrawArraysInstanced.
+ *
+ *   Uma SpatialGrid (Common/SpatialGrid.h) acompanha as posições a cada frame; segurar o
+ *   botão esquerdo do mouse apaga os sprites num raio em volta do cursor (consulta de raio).
+ *
+ *   O botão direito manda a multidão inteira para o ponto clicado: um campo de fluxo
+ *   (Common/FlowField.h) sobre uma grade de células do tamanho de um sprite dá, para cada
+ *   célula, a direção a seguir; a cada passo cada sprite só lê a direção da sua célula.
+ *   Os campos ficam guardados por destino, então voltar a um ponto já usado não custa nada.
+ *   A grade tem paredes (NAV_LAYOUT), contornadas pelo campo e nas quais os sprites
+ *   rebatem; perto do destino cada sprite para a uma distância própria dentro de
+ *   ARRIVE_RADIUS, e ao soltar o destino todos voltam a vagar.
+ *
+ *   Opções: --sprites N (padrão 100000), além das do modo benchmark e de ritmo.
+ *   Teclas: T liga/desliga as threads extras, V troca o ritmo dos frames, P grava o trace,
+ *   F solta a multidão do destino atual.
+ *
+ * Histórico:
+ *   - Versão inicial: 19/10/2026
+ *
+ */
+
+#include <iostream>
+#include <string>
+#include <assert.h>
+#include <cmath>
+#include <cstring>
+#include <cstdlib>
+#include <random>
+#include <vector>
+#include <algorithm>
+
+using namespace std;
+
+// GLAD
+#include <glad/glad.h>
+
+// GLFW
+#include <GLFW/glfw3.h>
+
+// GLM
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+using namespace glm;
+
+// STB_IMAGE
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb_image.h>
+
+// Buffer circular persistente para os atributos por instância de cada frame
+#include "StreamBuffer.h"
+// Medição de tempos de CPU/GPU e modo benchmark (--benchmark N)
+#include "FrameProfiler.h"
+#include "Benchmark.h"
+// Simulação em passo fixo
+#include "GameLoop.h"
+// Ritmo dos frames (vsync, adaptativo, limitado, sem limite)
+#include "FramePacer.h"
+// Estado dos sprites em estrutura de arrays e laço paralelo
+#include "SpriteEntities.h"
+#include "ThreadPool.h"
+// Grade espacial para as consultas por posição
+#include "SpatialGrid.h"
+// Campos de fluxo até um destino comum
+#include "FlowField.h"
+
+// Protótipo da função de callback de teclado
+void key_callback(GLFWwindow *window, int key, int scancode, int action, int mode);
+
+// Protótipos das funções
+int setupShader();
+int setupSprite(int nAnimations, int nFrames, float &ds, float &dt);
+int loadTexture(string filePath);
+void spawnCrowd(SpriteEntities &crowd, int n, const PathGrid &navGrid);
+void wanderCrowd(SpriteEntities &crowd, unsigned seed);
+void buildWalls(PathGrid &navGrid);
+bool openAt(const PathGrid &navGrid, float x, float y);
+void drawWalls(const PathGrid &navGrid);
+void drawCrowd(GLuint shaderID, GLuint VAO, GLuint texID, const SpriteEntities &crowd);
+void eraseAround(SpriteEntities &crowd, float x, float y, float radius);
+
+// Dimensões da janela (pode ser alterado em tempo de execução)
+const GLuint WIDTH = 800, HEIGHT = 600;
+
+// Tamanho de cada sprite na tela (a spritesheet tem quadros de 20x20 pixels)
+const float SPRITE_SIZE = 20.0;
+
+// Spritesheet dos inimigos: 12 animações (linhas) com 2 frames (colunas) cada
+const int N_ANIMATIONS = 12, N_FRAMES = 2;
+
+// Velocidade dos sprites indo ao destino, em pixels por segundo
+const float CROWD_SPEED = 80.0;
+
+// Raio da "borracha" do mouse, em pixels
+const float ERASE_RADIUS = 40.0;
+
+// Raio em volta do destino onde os sprites param, em pixels. Cada sprite para a uma
+// distância sua dentro dele, para a multidão ocupar um disco e não uma célula só
+const float ARRIVE_RADIUS = 120.0;
+
+// Paredes da grade de navegação ('#'), uma célula do tamanho de um sprite por caractere,
+// linha 0 no topo da tela
+const int NAV_COLS = 40, NAV_ROWS = 30;
+const char *NAV_LAYOUT[NAV_ROWS] = {
+	"........................................",
+	"........................................",
+	"........................................",
+	"....................#...................",
+	"....................#...................",
+	"....................#......#########....",
+	"....................#..............#....",
+	"...#############....#..............#....",
+	"...............#....#..............#....",
+	"...............#....#..............#....",
+	"...............#....#..............#....",
+	"...............#....#........#######....",
+	"...............#....#...................",
+	"........................................",
+	"........................................",
+	"........................................",
+	"........................................",
+	"....................#...#...............",
+	"....#...............#...#...............",
+	"....#...............#...#...............",
+	"....#...............#...#...............",
+	"....#...............#...#############...",
+	"....#...............#...................",
+	"....#...............#...................",
+	"....#########.......#...................",
+	"....................#...................",
+	"....................#...................",
+	"........................................",
+	"........................................",
+	"........................................",
+};
+
+// Código fonte do Vertex Shader (em GLSL): ainda hardcoded
+// A posição e o frame de cada sprite chegam como atributos por instância, um array por atributo
+const GLchar *vertexShaderSource = R"(
+ #version 400
+ layout (location = 0) in vec2 position;
+ layout (location = 1) in vec2 texc;
+ layout (location = 2) in float inst_x;
+ layout (location = 3) in float inst_y;
+ layout (location = 4) in float inst_vx;
+ layout (location = 5) in float inst_vy;
+ layout (location = 6) in int inst_frame;
+ layout (location = 7) in int inst_animation;
+
+ uniform mat4 projection;
+ uniform float sprite_size;
+ uniform vec2 cell;          // (ds, dt): tamanho de um quadro na spritesheet
+ uniform float extrapolate_s; // tempo desde o último passo de simulação
+ out vec2 tex_coord;
+ void main()
+ {
+	tex_coord = vec2(texc.s,1.0-texc.t) + vec2(inst_frame, inst_animation) * cell;
+	vec2 center = vec2(inst_x, inst_y) + vec2(inst_vx, inst_vy) * extrapolate_s;
+	gl_Position = projection * vec4(center + position * sprite_size, 0.0, 1.0);
+ }
+ )";
+
+// Código fonte do Fragment Shader (em GLSL): ainda hardcoded
+const GLchar *fragmentShaderSource = R"(
+ #version 400
+in vec2 tex_coord;
+out vec4 color;
+uniform sampler2D tex_buff;
+void main()
+{
+	 color = texture(tex_buff,tex_coord);
+}
+)";
+
+// Buffer de streaming (3 regiões) com os arrays copiados a cada frame
+StreamBuffer streamBuffer;
+
+// Medição de tempos por frame (P grava o trace em frame_trace.json)
+FrameProfiler profiler;
+
+// Modo de ritmo dos frames (V alterna entre os modos; --pacing/--fps na linha de comando)
+FramePacer pacer;
+BenchmarkHarness benchmark(profiler);
+
+// Threads da atualização (T alterna entre usar o pool e atualizar só na thread principal)
+bool useThreads = true;
+
+// Destino da multidão (F solta: cada sprite volta a vagar numa direção sorteada)
+bool hasGoal = false;
+
+// Grade com a posição de cada sprite (id na grade = índice em SpriteEntities)
+SpatialGrid grid(32.0);
+
+// Função MAIN
+int main(int argc, char **argv)
+{
+	int nSprites = 100000;
+	for (int i = 1; i < argc - 1; i++)
+	{
+		if (strcmp(argv[i], "--sprites") == 0)
+			nSprites = atoi(argv[i + 1]);
+	}
+	if (nSprites < 1)
+		nSprites = 1;
+
+	// Inicialização da GLFW (no modo benchmark sem display, com a plataforma nula)
+	if (!benchmark.parseArgs(argc, argv))
+	{
+		std::cout << "Opcoes de benchmark invalidas" << std::endl;
+		return 1;
+	}
+	if (!benchmark.initGLFW())
+		return -1;
+
+	// Criação da janela GLFW
+	GLFWwindow *window = benchmark.createWindow(WIDTH, HEIGHT, "Ola Multidao! -- Rossana");
+	if (!window)
+	{
+		std::cerr << "Falha ao criar a janela GLFW" << std::endl;
+		glfwTerminate();
+		return -1;
+	}
+	glfwMakeContextCurrent(window);
+
+	// Fazendo o registro da função de callback para a janela GLFW
+	glfwSetKeyCallback(window, key_callback);
+
+	// GLAD: carrega todos os ponteiros d funções da OpenGL
+	if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+	{
+		std::cerr << "Falha ao inicializar GLAD" << std::endl;
+		return -1;
+	}
+
+	// Obtendo as informações de versão
+	const GLubyte *renderer = glGetString(GL_RENDERER); /* get renderer string */
+	const GLubyte *version = glGetString(GL_VERSION);	/* version as a string */
+	cout << "Renderer: " << renderer << endl;
+	cout << "OpenGL version supported " << version << endl;
+
+	// Definindo as dimensões da viewport com as mesmas dimensões da janela da aplicação
+	int width, height;
+	glfwGetFramebufferSize(window, &width, &height);
+	glViewport(0, 0, width, height);
+
+	// Carrega as funções posteriores ao OpenGL 4.0 (glBufferStorage)
+	loadGLExt();
+
+	// Compilando e buildando o programa de shader
+	GLuint shaderID = setupShader();
+
+	// Por sprite e por frame: posX, posY, velX, velY, frame e animação (4 bytes cada)
+	// (+ folga para o alinhamento de cada array)
+	streamBuffer.init((GLsizeiptr)nSprites * 6 * sizeof(float) + 6 * 16);
+
+	float ds, dt;
+	GLuint VAO = setupSprite(N_ANIMATIONS, N_FRAMES, ds, dt);
+	GLuint texID = loadTexture("../assets/sprites/enemies-spritesheet1.png");
+
+	// Grade de navegação sobre a tela, em células do tamanho de um sprite, com as paredes
+	// de NAV_LAYOUT
+	PathGrid navGrid;
+	buildWalls(navGrid);
+
+	// Estado inicial sempre igual (semente fixa), para o benchmark e a imagem de referência
+	SpriteEntities crowd;
+	spawnCrowd(crowd, nSprites, navGrid);
+	for (int i = 0; i < crowd.size(); i++)
+	{
+		grid.insert(i, crowd.posX[i], crowd.posY[i], SPRITE_SIZE / 2, SPRITE_SIZE / 2);
+	}
+	SpriteBounds bounds = {SPRITE_SIZE / 2, SPRITE_SIZE / 2, WIDTH - SPRITE_SIZE / 2, HEIGHT - SPRITE_SIZE / 2};
+
+	// Uma thread por núcleo, contando a principal
+	ThreadPool pool;
+	cout << nSprites << " sprites, " << pool.size() << " threads" << endl;
+	// Campos de fluxo dos últimos destinos
+	FlowFieldCache flowFields(navGrid, 4, &pool);
+	GridPoint goal = {0, 0};
+	bool hadGoal = false;
+	unsigned wanderSeed = 2026;
+
+	glUseProgram(shaderID);
+
+	// Queries de tempo da GPU e, no modo benchmark, o FBO de destino
+	benchmark.setup();
+
+	// Intervalo de swap conforme o modo de ritmo (o benchmark sempre roda sem limite)
+	pacer.parseArgs(argc, argv);
+	if (benchmark.enabled())
+		pacer.setMode(PACE_UNTHROTTLED);
+	else
+		pacer.apply();
+
+	double prev_s = glfwGetTime();	// Define o "tempo anterior" inicial.
+	double title_countdown_s = 0.5; // Intervalo para atualizar o título da janela com as estatísticas.
+
+	// Movimento e animação avançam em passos fixos de 1/60 s, independentes do FPS
+	FixedTimestep gameLoop(1.0 / 60.0, 5);
+	double sim_prev_s = glfwGetTime();
+
+	// Ativando o primeiro buffer de textura do OpenGL
+	glActiveTexture(GL_TEXTURE0);
+	glUniform1i(glGetUniformLocation(shaderID, "tex_buff"), 0);
+
+	// Criação da matriz de projeção paralela ortográfica
+	mat4 projection = ortho(0.0, (double)WIDTH, 0.0, (double)HEIGHT, -1.0, 1.0);
+	glUniformMatrix4fv(glGetUniformLocation(shaderID, "projection"), 1, GL_FALSE, value_ptr(projection));
+	glUniform1f(glGetUniformLocation(shaderID, "sprite_size"), SPRITE_SIZE);
+	glUniform2f(glGetUniformLocation(shaderID, "cell"), ds, dt);
+
+	//Habilitando transparência/função de mistura
+	glEnable(GL_BLEND);
+	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+	// Loop da aplicação - "game loop"
+	while (benchmark.running(window))
+	{
+		// Início da medição do frame (CPU e GPU)
+		benchmark.beginFrame();
+
+		// Mostra as estatísticas do profiler na barra de título, algumas vezes por segundo
+		{
+			double curr_s = glfwGetTime();
+			title_countdown_s -= curr_s - prev_s;
+			prev_s = curr_s;
+			if (title_countdown_s <= 0.0)
+			{
+				char pacing[128];
+				pacer.describe(pacing, sizeof(pacing));
+				string title = "Ola Multidao! -- Rossana | " + to_string(crowd.size()) + " sprites | " +
+							   profiler.summary() + " | " + pacing;
+				glfwSetWindowTitle(window, title.c_str());
+				title_countdown_s = 0.5;
+			}
+		}
+
+		// Checa se houveram eventos de input (key pressed, mouse moved etc.) e chama as funções de callback correspondentes
+		glfwPollEvents();
+		pacer.markInput();
+
+		// Limpa o buffer de cor
+		glClearColor(0.0f, 0.0f, 0.0f, 1.0f); // cor de fundo
+		glClear(GL_COLOR_BUFFER_BIT);
+		drawWalls(navGrid);
+
+		// Passa para a próxima região do buffer de streaming (espera a GPU só se necessário)
+		streamBuffer.beginFrame();
+
+		// Simulação em passos fixos. No benchmark cada frame vale exatamente um passo,
+		// para que o frame capturado seja sempre o mesmo
+		double sim_curr_s = glfwGetTime();
+		double sim_elapsed_s = benchmark.enabled() ? gameLoop.step() : sim_curr_s - sim_prev_s;
+		sim_prev_s = sim_curr_s;
+		int steps = gameLoop.advance(sim_elapsed_s);
+
+		// Roteiro do benchmark: a multidão passa por 4 destinos (um campo de fluxo novo a
+		// cada um) e no último quinto é solta
+		if (benchmark.enabled())
+		{
+			const GridPoint SCRIPT_GOALS[4] = {{6, 3}, {30, 8}, {33, 26}, {10, 20}};
+			int leg = std::min((int)(benchmark.progress() * 5.0f), 4);
+			hasGoal = leg < 4;
+			if (hasGoal)
+				goal = SCRIPT_GOALS[leg];
+		}
+		{
+			ProfileScope cpu(profiler, "update");
+			// Destino solto: os sprites parados no disco de chegada voltam a vagar
+			if (hadGoal && !hasGoal)
+				wanderCrowd(crowd, wanderSeed++);
+			hadGoal = hasGoal;
+
+			// Com destino, a velocidade de cada sprite vem da direção da sua célula no campo
+			FlowField *flow = hasGoal ? &flowFields.get(goal, SPRITE_SIZE, SPRITE_SIZE, 0.0f, (float)HEIGHT) : nullptr;
+			float goalX = (goal.col + 0.5f) * SPRITE_SIZE, goalY = HEIGHT - (goal.row + 0.5f) * SPRITE_SIZE;
+			float step = (float)gameLoop.step();
+			auto steer = [&](int b, int e) {
+				if (flow)
+				{
+					flow->steer(crowd.posX.data(), crowd.posY.data(), crowd.velX.data(), crowd.velY.data(), b, e,
+								CROWD_SPEED);
+					// Chegada: cada sprite para dentro do seu raio, sorteado pelo índice de forma
+					// que as paradas cubram o disco por igual
+					for (int i = b; i < e; i++)
+					{
+						float u = (float)((uint32_t)i * 2654435761u >> 16) / 65536.0f;
+						float dx = crowd.posX[i] - goalX, dy = crowd.posY[i] - goalY;
+						if (dx * dx + dy * dy < ARRIVE_RADIUS * ARRIVE_RADIUS * u)
+							crowd.velX[i] = crowd.velY[i] = 0.0f;
+					}
+				}
+				// Paredes: o centro do sprite não entra numa célula fechada, ele rebate no
+				// eixo que bateria (nos dois, se só a diagonal estiver fechada)
+				for (int i = b; i < e; i++)
+				{
+					float x = crowd.posX[i], y = crowd.posY[i];
+					float nx = x + crowd.velX[i] * step, ny = y + crowd.velY[i] * step;
+					if (openAt(navGrid, nx, ny) || !openAt(navGrid, x, y))
+						continue;
+					bool hitX = !openAt(navGrid, nx, y), hitY = !openAt(navGrid, x, ny);
+					if (hitX || !hitY)
+						crowd.velX[i] = -crowd.velX[i];
+					if (hitY || !hitX)
+						crowd.velY[i] = -crowd.velY[i];
+				}
+			};
+			for (int i = 0; i < steps; i++)
+			{
+				if (useThreads)
+					pool.parallelFor(crowd.size(), 16384, steer);
+				else
+					steer(0, crowd.size());
+				crowd.update(step, bounds, useThreads ? &pool : nullptr);
+			}
+		}
+		{
+			// Atualização incremental: só quem trocou de célula mexe nas listas da grade
+			ProfileScope cpu(profiler, "grid");
+			for (int i = 0; i < crowd.size(); i++)
+			{
+				grid.update(i, crowd.posX[i], crowd.posY[i]);
+			}
+		}
+
+		// Botão esquerdo: apaga os sprites em volta do cursor
+		if (!benchmark.enabled() && glfwGetMouseButton(window, GLFW_MOUSE_BUTTON_LEFT) == GLFW_PRESS)
+		{
+			double mx, my;
+			int winW, winH;
+			glfwGetCursorPos(window, &mx, &my);
+			glfwGetWindowSize(window, &winW, &winH);
+			// Cursor em pixels da janela (y para baixo) -> coordenadas da projeção (y para cima)
+			float x = (float)(mx * WIDTH / winW);
+			float y = (float)(HEIGHT - my * HEIGHT / winH);
+			eraseAround(crowd, x, y, ERASE_RADIUS);
+		}
+
+		// Botão direito: novo destino para a multidão
+		if (!benchmark.enabled() && glfwGetMouseButton(window, GLFW_MOUSE_BUTTON_RIGHT) == GLFW_PRESS)
+		{
+			double mx, my;
+			int winW, winH;
+			glfwGetCursorPos(window, &mx, &my);
+			glfwGetWindowSize(window, &winW, &winH);
+			// Linha 0 da grade no topo da tela, como a coordenada y do cursor
+			int col = (int)(mx * WIDTH / winW / SPRITE_SIZE), row = (int)(my * HEIGHT / winH / SPRITE_SIZE);
+			if (navGrid.walkable(col, row))
+			{
+				goal = {col, row};
+				hasGoal = true;
+			}
+		}
+
+		// O passo seguinte ainda não foi simulado: o shader avança cada sprite pela sua
+		// velocidade durante a fração de passo que sobrou (no benchmark, zero)
+		glUniform1f(glGetUniformLocation(shaderID, "extrapolate_s"), gameLoop.alpha() * (float)gameLoop.step());
+
+		{
+			ProfileScope cpu(profiler, "sprites");
+			GpuProfileScope gpu(profiler, "sprites");
+			drawCrowd(shaderID, VAO, texID, crowd);
+		}
+
+		// Marca o fim do uso da região deste frame
+		streamBuffer.endFrame();
+		benchmark.endFrame();
+
+		// Troca os buffers da tela (com a espera do modo de ritmo) e mede a latência
+		pacer.present(window);
+	}
+	profiler.printStats();
+	// Relatório do benchmark e, se pedida, comparação com a imagem de referência
+	bool passed = benchmark.finish("crowd");
+	profiler.destroy();
+	streamBuffer.destroy();
+	glDeleteVertexArrays(1, &VAO);
+	// Finaliza a execução da GLFW, limpando os recursos alocados por ela
+	glfwTerminate();
+	return passed ? 0 : 1;
+}
+
+// Função de callback de teclado - só pode ter uma instância (deve ser estática se
+// estiver dentro de uma classe) - É chamada sempre que uma tecla for pressionada
+// ou solta via GLFW
+void key_callback(GLFWwindow *window, int key, int scancode, int action, int mode)
+{
+	if (key == GLFW_KEY_ESCAPE && action == GLFW_PRESS)
+		glfwSetWindowShouldClose(window, GL_TRUE);
+
+	if (key == GLFW_KEY_P && action == GLFW_PRESS)
+	{
+		if (profiler.exportChromeTrace("frame_trace.json"))
+			cout << "Trace gravado em frame_trace.json (abrir em ui.perfetto.dev)" << endl;
+	}
+
+	if (key == GLFW_KEY_V && action == GLFW_PRESS)
+	{
+		pacer.cycleMode();
+		cout << "Ritmo dos frames: " << FramePacer::modeName(pacer.currentMode()) << endl;
+	}
+
+	if (key == GLFW_KEY_F && action == GLFW_PRESS && hasGoal)
+	{
+		hasGoal = false;
+		cout << "Multidao sem destino" << endl;
+	}
+
+	if (key == GLFW_KEY_T && action == GLFW_PRESS)
+	{
+		useThreads = !useThreads;
+		cout << "Atualizacao " << (useThreads ? "com o pool de threads" : "so na thread principal") << endl;
+	}
+}
+
+// Esta função está bastante hardcoded - objetivo é compilar e "buildar" um programa de
+//  shader simples e único neste exemplo de código
+//  O código fonte do vertex e fragment shader está nos arrays vertexShaderSource e
+//  fragmentShader source no iniçio deste arquivo
+//  A função retorna o identificador do programa de shader
+int setupShader()
+{
+	// Vertex shader
+	GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
+	glShaderSource(vertexShader, 1, &vertexShaderSource, NULL);
+	glCompileShader(vertexShader);
+	// Checando erros de compilação (exibição via log no terminal)
+	GLint success;
+	GLchar infoLog[512];
+	glGetShaderiv(vertexShader, GL_COMPILE_STATUS, &success);
+	if (!success)
+	{
+		glGetShaderInfoLog(vertexShader, 512, NULL, infoLog);
+		std::cout << "ERROR::SHADER::VERTEX::COMPILATION_FAILED\n"
+				  << infoLog << std::endl;
+	}
+	// Fragment shader
+	GLuint fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
+	glShaderSource(fragmentShader, 1, &fragmentShaderSource, NULL);
+	glCompileShader(fragmentShader);
+	// Checando erros de compilação (exibição via log no terminal)
+	glGetShaderiv(fragmentShader, GL_COMPILE_STATUS, &success);
+	if (!success)
+	{
+		glGetShaderInfoLog(fragmentShader, 512, NULL, infoLog);
+		std::cout << "ERROR::SHADER::FRAGMENT::COMPILATION_FAILED\n"
+				  << infoLog << std::endl;
+	}
+	// Linkando os shaders e criando o identificador do programa de shader
+	GLuint shaderProgram = glCreateProgram();
+	glAttachShader(shaderProgram, vertexShader);
+	glAttachShader(shaderProgram, fragmentShader);
+	glLinkProgram(shaderProgram);
+	// Checando por erros de linkagem
+	glGetProgramiv(shaderProgram, GL_LINK_STATUS, &success);
+	if (!success)
+	{
+		glGetProgramInfoLog(shaderProgram, 512, NULL, infoLog);
+		std::cout << "ERROR::SHADER::PROGRAM::LINKING_FAILED\n"
+				  << infoLog << std::endl;
+	}
+	glDeleteShader(vertexShader);
+	glDeleteShader(fragmentShader);
+
+	return shaderProgram;
+}
+
+// Quad unitário centrado na origem com as coordenadas de textura de um quadro da
+// spritesheet, como em HelloSpritesheet. Os atributos por instância (2 a 7) ficam
+// habilitados no VAO; seus ponteiros são definidos a cada frame em drawCrowd.
+int setupSprite(int nAnimations, int nFrames, float &ds, float &dt)
+{
+	ds = 1.0 / (float) nFrames;
+	dt = 1.0 / (float) nAnimations;
+
+	GLfloat vertices[] = {
+		// x   y   s     t
+		-0.5, 0.5, 0.0, dt,
+		-0.5,-0.5, 0.0,	0.0,
+		 0.5, 0.5, ds, dt,
+		-0.5,-0.5, 0.0,	0.0,
+		 0.5,-0.5, ds, 0.0,
+		 0.5, 0.5, ds,	dt,
+	};
+
+	GLuint VBO, VAO;
+	glGenBuffers(1, &VBO);
+	glBindBuffer(GL_ARRAY_BUFFER, VBO);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+
+	glGenVertexArrays(1, &VAO);
+	glBindVertexArray(VAO);
+
+	// Ponteiro pro atributo 0 - Posição - coordenadas x, y
+	glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(GLfloat), (GLvoid *)0);
+	glEnableVertexAttribArray(0);
+
+	// Ponteiro pro atributo 1 - Coordenada de textura - coordenadas s,t
+	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(GLfloat), (GLvoid *)(2 * sizeof(GLfloat)));
+	glEnableVertexAttribArray(1);
+
+	// Atributos por instância: avançam um elemento a cada sprite, não a cada vértice
+	for (GLuint loc = 2; loc <= 7; loc++)
+	{
+		glEnableVertexAttribArray(loc);
+		glVertexAttribDivisor(loc, 1);
+	}
+
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glBindVertexArray(0);
+
+	return VAO;
+}
+
+int loadTexture(string filePath)
+{
+	GLuint texID;
+
+	// Gera o identificador da textura na memória
+	glGenTextures(1, &texID);
+	glBindTexture(GL_TEXTURE_2D, texID);
+
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+	int width, height, nrChannels;
+
+	unsigned char *data = stbi_load(filePath.c_str(), &width, &height, &nrChannels, 0);
+
+	if (data)
+	{
+		if (nrChannels == 3) // jpg, bmp
+		{
+			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, data);
+		}
+		else // png
+		{
+			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
+		}
+		glGenerateMipmap(GL_TEXTURE_2D);
+	}
+	else
+	{
+		std::cout << "Failed to load texture" << std::endl;
+	}
+
+	stbi_image_free(data);
+
+	glBindTexture(GL_TEXTURE_2D, 0);
+
+	return texID;
+}
+
+// Sprites espalhados pela tela, com velocidade, animação e ritmo de animação sorteados
+void spawnCrowd(SpriteEntities &crowd, int n, const PathGrid &navGrid)
+{
+	mt19937 rng(2025);
+	uniform_real_distribution<float> x(SPRITE_SIZE / 2, WIDTH - SPRITE_SIZE / 2);
+	uniform_real_distribution<float> y(SPRITE_SIZE / 2, HEIGHT - SPRITE_SIZE / 2);
+	uniform_real_distribution<float> vel(-120.0, 120.0);   // pixels por segundo
+	uniform_real_distribution<float> fps(6.0, 14.0);       // frames da animação por segundo
+	uniform_int_distribution<int> animation(0, N_ANIMATIONS - 1);
+
+	crowd.reserve(n);
+	for (int i = 0; i < n; i++)
+	{
+		float px = x(rng), py = y(rng), vx = vel(rng), vy = vel(rng);
+		while (!openAt(navGrid, px, py)) // fora das paredes
+		{
+			px = x(rng);
+			py = y(rng);
+		}
+		crowd.add(px, py, vx, vy, animation(rng), N_FRAMES, 1.0f / fps(rng));
+	}
+}
+
+// Sorteia de novo a velocidade de cada sprite, como no spawnCrowd
+void wanderCrowd(SpriteEntities &crowd, unsigned seed)
+{
+	mt19937 rng(seed);
+	uniform_real_distribution<float> vel(-120.0, 120.0); // pixels por segundo
+	for (int i = 0; i < crowd.size(); i++)
+	{
+		crowd.velX[i] = vel(rng);
+		crowd.velY[i] = vel(rng);
+	}
+}
+
+// Fecha na grade de navegação as células marcadas com '#' em NAV_LAYOUT
+void buildWalls(PathGrid &navGrid)
+{
+	navGrid.resize(NAV_COLS, NAV_ROWS);
+	for (int row = 0; row < NAV_ROWS; row++)
+		for (int col = 0; col < NAV_COLS; col++)
+			navGrid.setBlocked(col, row, NAV_LAYOUT[row][col] == '#');
+}
+
+// O ponto (x, y) da tela está numa célula aberta? (fora da grade conta como fechado)
+bool openAt(const PathGrid &navGrid, float x, float y)
+{
+	return navGrid.walkable((int)floorf(x / SPRITE_SIZE), (int)floorf((HEIGHT - y) / SPRITE_SIZE));
+}
+
+// Pinta as paredes limpando cada trecho de células fechadas de uma linha com o scissor,
+// sem precisar de outro shader ou VAO só para elas
+void drawWalls(const PathGrid &navGrid)
+{
+	GLint vp[4];
+	glGetIntegerv(GL_VIEWPORT, vp);
+	float sx = vp[2] / (float)WIDTH, sy = vp[3] / (float)HEIGHT;
+	glEnable(GL_SCISSOR_TEST);
+	glClearColor(0.3f, 0.3f, 0.35f, 1.0f);
+	for (int row = 0; row < navGrid.rows; row++)
+		for (int col = 0; col < navGrid.cols; col++)
+		{
+			if (navGrid.walkable(col, row))
+				continue;
+			int end = col;
+			while (end < navGrid.cols && !navGrid.walkable(end, row))
+				end++;
+			float x0 = col * SPRITE_SIZE, y0 = HEIGHT - (row + 1) * SPRITE_SIZE;
+			glScissor(vp[0] + (GLint)lroundf(x0 * sx), vp[1] + (GLint)lroundf(y0 * sy),
+					  (GLsizei)lroundf((end - col) * SPRITE_SIZE * sx), (GLsizei)lroundf(SPRITE_SIZE * sy));
+			glClear(GL_COLOR_BUFFER_BIT);
+			col = end;
+		}
+	glDisable(GL_SCISSOR_TEST);
+}
+
+// Copia um array inteiro de SpriteEntities para a região do frame e aponta um atributo para ele
+static bool uploadAttribute(GLuint loc, const void *data, GLsizeiptr bytes, GLint size, GLenum type)
+{
+	StreamAlloc alloc = streamBuffer.allocate(bytes);
+	if (!alloc.ptr)
+		return false;
+	memcpy(alloc.ptr, data, bytes);
+	streamBuffer.flush(alloc);
+	if (type == GL_INT)
+		glVertexAttribIPointer(loc, size, type, 0, (GLvoid *)(alloc.offset));
+	else
+		glVertexAttribPointer(loc, size, type, GL_FALSE, 0, (GLvoid *)(alloc.offset));
+	return true;
+}
+
+// Desenha todos os sprites com uma única chamada instanciada. Os atributos de instância
+// vêm direto dos arrays da simulação: uma cópia contígua por array, sem montar um
+// struct por sprite nem intercalar campos.
+void drawCrowd(GLuint shaderID, GLuint VAO, GLuint texID, const SpriteEntities &crowd)
+{
+	int n = crowd.size();
+	GLsizeiptr bytes = (GLsizeiptr)n * 4; // float e int32_t têm 4 bytes
+
+	glUseProgram(shaderID);
+	glBindVertexArray(VAO);
+	glBindTexture(GL_TEXTURE_2D, texID);
+	glBindBuffer(GL_ARRAY_BUFFER, streamBuffer.buffer());
+
+	bool ok = uploadAttribute(2, crowd.posX.data(), bytes, 1, GL_FLOAT) &&
+			  uploadAttribute(3, crowd.posY.data(), bytes, 1, GL_FLOAT) &&
+			  uploadAttribute(4, crowd.velX.data(), bytes, 1, GL_FLOAT) &&
+			  uploadAttribute(5, crowd.velY.data(), bytes, 1, GL_FLOAT) &&
+			  uploadAttribute(6, crowd.frame.data(), bytes, 1, GL_INT) &&
+			  uploadAttribute(7, crowd.animation.data(), bytes, 1, GL_INT);
+
+	// Chamada de desenho - uma só para todos os sprites
+	if (ok)
+		glDrawArraysInstanced(GL_TRIANGLES, 0, 6, n);
+
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glBindVertexArray(0);
+}
+
+// Remove os sprites cuja caixa cruza o círculo. SpriteEntities::remove traz o último
+// sprite para o lugar do removido; a grade acompanha com rename. Removendo do maior
+// índice para o menor, o último nunca é um dos que ainda faltam remover.
+void eraseAround(SpriteEntities &crowd, float x, float y, float radius)
+{
+	vector<int> hits;
+	grid.queryRadius(x, y, radius, [&](int id) { hits.push_back(id); });
+	sort(hits.begin(), hits.end(), greater<int>());
+	for (int id : hits)
+	{
+		int last = crowd.size() - 1;
+		grid.remove(id);
+		grid.rename(last, id);
+		crowd.remove(id);
+	}
+}
@@ -47,6 +47,15 @@ using namespace glm;
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb_image.h>
 
+// Medição de tempos de CPU/GPU
+#include "FrameProfiler.h"
+// Simulação em passo fixo
+#include "GameLoop.h"
+// Ritmo dos frames (vsync, adaptativo, limitado, sem limite)
+#include "FramePacer.h"
+// Clipes de animação lidos de arquivo e reprodução por entidade
+#include "SpriteAnimation.h"
+
 struct Sprite 
 {
 	GLuint VAO;
@@ -54,10 +63,9 @@ struct Sprite
 	vec3 pos;
 	vec3 dimensions;
 	float angle;
-	float vel; 
-	int nAnimations, nFrames;
-	int iFrame, iAnimation;
-	float ds, dt;
+	float vel;	  // pixels por segundo
+	int anim;	  // índice em animations (-1: textura inteira, sem animação)
+	vec3 prevPos; // posição no passo de simulação anterior (para interpolar o desenho)
 };
 
 // Protótipo da função de callback de teclado
@@ -65,9 +73,10 @@ void key_callback(GLFWwindow *window, int key, int scancode, int action, int mod
 
 // Protótipos das funções
 int setupShader();
-int setupSprite(int nAnimations, int nFrames, float &ds, float &dt);
+int setupSprite();
 int loadTexture(string filePath);
 void drawSprite(GLuint shaderID, Sprite spr);
+void updateSprite(Sprite &spr, float dt);
 
 // Dimensões da janela (pode ser alterado em tempo de execução)
 const GLuint WIDTH = 800, HEIGHT = 600;
@@ -80,10 +89,11 @@ const GLchar *vertexShaderSource = R"(
  
  uniform mat4 projection;
  uniform mat4 model;
+ uniform vec4 uv_rect; // quadro na spritesheet: (s0, t0) superior esquerdo, (s1, t1) inferior direito
  out vec2 tex_coord;
  void main()
  {
-	tex_coord = vec2(texc.s,1.0-texc.t);
+	tex_coord = mix(uv_rect.xy, uv_rect.zw, texc);
 	gl_Position = projection * model * vec4(position, 0.0, 1.0);
  }
  )";
@@ -94,21 +104,30 @@ const GLchar *fragmentShaderSource = R"(
 in vec2 tex_coord;
 out vec4 color;
 uniform sampler2D tex_buff;
-uniform vec2 offset_tex;
 void main()
 {
-	 color = texture(tex_buff,tex_coord + offset_tex);
+	 color = texture(tex_buff,tex_coord);
 }
 )";
 
+// Medição de tempos por frame (P grava o trace em frame_trace.json)
+FrameProfiler profiler;
+
+// Modo de ritmo dos frames (V alterna entre os modos; --pacing/--fps na linha de comando)
+FramePacer pacer;
+
 bool keys[1024];
-float FPS = 12.0;
-float lastTime = 0.0;
+
+// Clipes da spritesheet dos inimigos (assets/sprites/enemies-spritesheet1.json) e o
+// estado de reprodução de cada sprite animado; N troca o clipe do sprite
+AnimationLibrary enemyClips;
+AnimationPlayers animations(enemyClips);
+Sprite *player = nullptr;
 
 
 
 // Função MAIN
-int main()
+int main(int argc, char **argv)
 {
 	// Inicialização da GLFW
 	glfwInit();
@@ -169,23 +188,33 @@ int main()
 	Sprite background, spr1, spr2;
 
 	// Gerando um buffer simples, com a geometria de um triângulo
-	background.VAO = setupSprite(1,1,background.ds,background.dt);
+	background.VAO = setupSprite();
 	background.texID = loadTexture("../assets/tex/1.png");
 	background.pos = vec3(400,300,0);
 	background.dimensions = vec3(800, 600, 1);
 	background.angle = 0.0;
+	background.anim = -1;
 
-	// Carregando uma textura
-	spr1.VAO = setupSprite(12,2,spr1.ds,spr1.dt);
-	spr1.texID = loadTexture("../assets/sprites/enemies-spritesheet1.png");
+	// Carregando a descrição dos clipes e a textura indicada nela
+	if (!enemyClips.load("../assets/sprites/enemies-spritesheet1.json"))
+	{
+		glfwTerminate();
+		return -1;
+	}
+	spr1.VAO = setupSprite();
+	spr1.texID = loadTexture(enemyClips.texturePath);
 	spr1.pos = vec3(400,300,0);
 	spr1.dimensions = vec3(20 * 4, 20 * 4, 1);
-	spr1.vel = 1.5;
-	spr1.nAnimations = 12;
-	spr1.nFrames = 2;
+	spr1.vel = 90.0;
 	spr1.angle = 0.0;
-	spr1.iAnimation = 9;
-	spr1.iFrame = 0;
+	spr1.anim = animations.add(enemyClips.requireClip("andador_0"));
+	if (spr1.anim < 0)
+	{
+		glfwTerminate();
+		return -1;
+	}
+	spr1.prevPos = spr1.pos;
+	player = &spr1;
 
 	//spr2.VAO = VAO;
 	//spr2.texID = loadTexture("../assets/sprites/microbio.png");
@@ -194,8 +223,19 @@ int main()
 
 	glUseProgram(shaderID); // Reseta o estado do shader para evitar problemas futuros
 
+	// Queries de tempo da GPU
+	profiler.init();
+
+	// Intervalo de swap conforme o modo de ritmo escolhido (padrão: vsync)
+	pacer.parseArgs(argc, argv);
+	pacer.apply();
+
 	double prev_s = glfwGetTime();	// Define o "tempo anterior" inicial.
-	double title_countdown_s = 0.1; // Intervalo para atualizar o título da janela com o FPS.
+	double title_countdown_s = 0.5; // Intervalo para atualizar o título da janela com as estatísticas.
+
+	// Movimento e animação avançam em passos fixos de 1/60 s, independentes do FPS
+	FixedTimestep gameLoop(1.0 / 60.0, 5);
+	double sim_prev_s = glfwGetTime();
 
 	float colorValue = 0.0;
 
@@ -222,63 +262,62 @@ int main()
 	// Loop da aplicação - "game loop"
 	while (!glfwWindowShouldClose(window))
 	{
-		// Este trecho de código é totalmente opcional: calcula e mostra a contagem do FPS na barra de título
-		{
-			double curr_s = glfwGetTime();		// Obtém o tempo atual.
-			double elapsed_s = curr_s - prev_s; // Calcula o tempo decorrido desde o último frame.
-			prev_s = curr_s;					// Atualiza o "tempo anterior" para o próximo frame.
+		// Início da medição do frame (CPU e GPU)
+		profiler.beginFrame();
 
-			// Exibe o FPS, mas não a cada frame, para evitar oscilações excessivas.
-			title_countdown_s -= elapsed_s;
-			if (title_countdown_s <= 0.0 && elapsed_s > 0.0)
+		// Mostra as estatísticas do profiler na barra de título, algumas vezes por segundo
+		{
+			double curr_s = glfwGetTime();
+			title_countdown_s -= curr_s - prev_s;
+			prev_s = curr_s;
+			if (title_countdown_s <= 0.0)
 			{
-				double fps = 1.0 / elapsed_s; // Calcula o FPS com base no tempo decorrido.
-
-				// Cria uma string e define o FPS como título da janela.
-				char tmp[256];
-				sprintf(tmp, "Ola Triangulo! -- Rossana\tFPS %.2lf", fps);
-				glfwSetWindowTitle(window, tmp);
-
-				title_countdown_s = 0.1; // Reinicia o temporizador para atualizar o título periodicamente.
+				char pacing[128];
+				pacer.describe(pacing, sizeof(pacing));
+				string title = "Ola Spritesheet! -- Rossana | " + profiler.summary() + " | " + pacing;
+				glfwSetWindowTitle(window, title.c_str());
+				title_countdown_s = 0.5;
 			}
 		}
 
 		// Checa se houveram eventos de input (key pressed, mouse moved etc.) e chama as funções de callback correspondentes
 		glfwPollEvents();
+		pacer.markInput();
 
 		// Limpa o buffer de cor
 		glClearColor(0.0f, 0.0f, 0.0f, 1.0f); // cor de fundo
 		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-		if (keys[GLFW_KEY_LEFT] == true || keys[GLFW_KEY_A] == true)
+		// Simulação em passos fixos: tantos passos quanto couberem no tempo decorrido
+		double sim_curr_s = glfwGetTime();
+		double sim_elapsed_s = sim_curr_s - sim_prev_s;
+		sim_prev_s = sim_curr_s;
+		int steps = gameLoop.advance(sim_elapsed_s);
+		for (int i = 0; i < steps; i++)
 		{
-			spr1.pos.x -= spr1.vel;		
+			updateSprite(spr1, gameLoop.step());
+			// Animação de todos os sprites de uma vez, no mesmo passo
+			animations.update(gameLoop.step());
 		}
-		if (keys[GLFW_KEY_RIGHT] == true || keys[GLFW_KEY_D] == true)
 		{
-			spr1.pos.x += spr1.vel;		
+			ProfileScope cpu(profiler, "sprites");
+			GpuProfileScope gpu(profiler, "sprites");
+			drawSprite(shaderID,background);
+
+			// Desenha na posição interpolada entre os dois últimos passos
+			Sprite spr1Draw = spr1;
+			spr1Draw.pos = mix(spr1.prevPos, spr1.pos, gameLoop.alpha());
+			drawSprite(shaderID,spr1Draw);
 		}
-		glUniform2f(glGetUniformLocation(shaderID, "offset_tex"),0.0,0.0);
-
-		drawSprite(shaderID,background);
+		//drawSprite(shaderID,spr2);
 
-		float offsetS = spr1.iFrame * spr1.ds;
-		float offsetT = spr1.iAnimation * spr1.dt;
-		glUniform2f(glGetUniformLocation(shaderID, "offset_tex"),offsetS,offsetT);
-		drawSprite(shaderID,spr1);
+		profiler.endFrame();
 
-		float now = glfwGetTime();
-		float deltaTime = now - lastTime;
-		if (deltaTime >= 1/FPS)
-		{
-			spr1.iFrame = (spr1.iFrame + 1) % spr1.nFrames;
-			lastTime = now;
-		}
-		//drawSprite(shaderID,spr2);
-		
-		// Troca os buffers da tela
-		glfwSwapBuffers(window);
+		// Troca os buffers da tela (com a espera do modo de ritmo) e mede a latência
+		pacer.present(window);
 	}
+	profiler.printStats();
+	profiler.destroy();
 	// Finaliza a execução da GLFW, limpando os recursos alocados por ela
 	glfwTerminate();
 	return 0;
@@ -292,6 +331,25 @@ void key_callback(GLFWwindow *window, int key, int scancode, int action, int mod
 	if (key == GLFW_KEY_ESCAPE && action == GLFW_PRESS)
 		glfwSetWindowShouldClose(window, GL_TRUE);
 
+	if (key == GLFW_KEY_P && action == GLFW_PRESS)
+	{
+		if (profiler.exportChromeTrace("frame_trace.json"))
+			cout << "Trace gravado em frame_trace.json (abrir em ui.perfetto.dev)" << endl;
+	}
+
+	if (key == GLFW_KEY_V && action == GLFW_PRESS)
+	{
+		pacer.cycleMode();
+		cout << "Ritmo dos frames: " << FramePacer::modeName(pacer.currentMode()) << endl;
+	}
+
+	if (key == GLFW_KEY_N && action == GLFW_PRESS && player)
+	{
+		int next = (animations.clip[player->anim] + 1) % (int)enemyClips.clips.size();
+		animations.play(player->anim, next);
+		cout << "Clipe: " << enemyClips.clips[next].name << endl;
+	}
+
 	if (action == GLFW_PRESS)
 	{
 		keys[key] = true;
@@ -359,24 +417,22 @@ int setupShader()
 // Apenas atributo coordenada nos vértices
 // 1 VBO com as coordenadas, VAO com apenas 1 ponteiro para atributo
 // A função retorna o identificador do VAO
-int setupSprite(int nAnimations, int nFrames, float &ds, float &dt)
+// As coordenadas de textura vão de (0,0) no canto superior esquerdo a (1,1) no inferior
+// direito; o shader as mapeia para o retângulo do quadro atual (uv_rect)
+int setupSprite()
 {
-
-	ds = 1.0 / (float) nFrames;
-	dt = 1.0 / (float) nAnimations;
-
 	// Aqui setamos as coordenadas x, y e z do triângulo e as armazenamos de forma
 	// sequencial, já visando mandar para o VBO (Vertex Buffer Objects)
 	// Cada atributo do vértice (coordenada, cores, coordenadas de textura, normal, etc)
 	// Pode ser arazenado em um VBO único ou em VBOs separados
 	GLfloat vertices[] = {
 		// x   y   s     t
-		-0.5, 0.5, 0.0, dt,
-		-0.5,-0.5, 0.0,	0.0,
-		 0.5, 0.5, ds, dt,
-		-0.5,-0.5, 0.0,	0.0,
-		 0.5,-0.5, ds, 0.0,
-		 0.5, 0.5, ds,	dt,
+		-0.5, 0.5, 0.0, 0.0,
+		-0.5,-0.5, 0.0,	1.0,
+		 0.5, 0.5, 1.0, 0.0,
+		-0.5,-0.5, 0.0,	1.0,
+		 0.5,-0.5, 1.0, 1.0,
+		 0.5, 0.5, 1.0,	0.0,
 	};
 
 	GLuint VBO, VAO;
@@ -425,6 +481,9 @@ void drawSprite(GLuint shaderID, Sprite spr)
 		
 	// Desenhar o sprite 1
 	glBindTexture(GL_TEXTURE_2D, spr.texID); // Conectando ao buffer de textura
+	// Retângulo do quadro atual, calculado na carga dos clipes
+	UVRect uv = spr.anim >= 0 ? animations.uv(spr.anim) : UVRect{0.0, 0.0, 1.0, 1.0};
+	glUniform4f(glGetUniformLocation(shaderID, "uv_rect"), uv.s0, uv.t0, uv.s1, uv.t1);
 	// Criação da  matriz de transformações do objeto
 	mat4 model = mat4(1);  // matriz identidade
 	model = translate(model, spr.pos);
@@ -479,3 +538,18 @@ int loadTexture(string filePath)
 
 	return texID;
 }
+
+// Um passo fixo de simulação do sprite: movimento pelas teclas (a animação avança
+// em animations.update, para todos os sprites juntos)
+void updateSprite(Sprite &spr, float dt)
+{
+	spr.prevPos = spr.pos;
+	if (keys[GLFW_KEY_LEFT] == true || keys[GLFW_KEY_A] == true)
+	{
+		spr.pos.x -= spr.vel * dt;
+	}
+	if (keys[GLFW_KEY_RIGHT] == true || keys[GLFW_KEY_D] == true)
+	{
+		spr.pos.x += spr.vel * dt;
+	}
+}
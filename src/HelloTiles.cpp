@@ -27,6 +27,7 @@
 #include <string>
 #include <assert.h>
 #include <cmath>
+#include <cstring>
 
 using namespace std;
 
@@ -47,6 +48,27 @@ using namespace glm;
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb_image.h>
 
+// Medição de tempos de CPU/GPU e modo benchmark (--benchmark N)
+#include "FrameProfiler.h"
+#include "Benchmark.h"
+// Simulação em passo fixo
+#include "GameLoop.h"
+// Ritmo dos frames (vsync, adaptativo, limitado, sem limite)
+#include "FramePacer.h"
+// Clipes de animação lidos de arquivo e reprodução por entidade
+#include "SpriteAnimation.h"
+
+// Colisão do sprite com os tiles sólidos do mapa
+#include "TileCollision.h"
+// Tabela de tiles animados (água, lava) num UBO, resolvida no shader
+#include "TileAnimation.h"
+// Câmera 2D com deslocamento e zoom
+#include "Camera2D.h"
+// Campo de visão por shadowcasting e névoa de guerra
+#include "FieldOfView.h"
+// Luz de tochas espalhada pelos tiles
+#include "TileLighting.h"
+
 struct Sprite
 {
 	GLuint VAO;
@@ -54,10 +76,9 @@ struct Sprite
 	vec3 pos;
 	vec3 dimensions;
 	float angle;
-	float vel;
-	int nAnimations, nFrames;
-	int iFrame, iAnimation;
-	float ds, dt;
+	float vel;	  // pixels por segundo
+	int anim;	  // índice em animations (-1: textura inteira, sem animação)
+	vec3 prevPos; // posição no passo de simulação anterior (para interpolar o desenho)
 };
 
 struct Tileset
@@ -66,51 +87,125 @@ struct Tileset
 	GLuint texID;
 	vec3 pos;
 	vec3 dimensions;
-	int nTiles;
+	int nTiles; // colunas da textura do tileset (tiles do mapa e quadros de animação)
 	float ds;
+	GLuint layersTexID; // IDs de todas as camadas: textura 2D array R16UI, uma fatia por camada
+	GLuint fogTexID;	// névoa de guerra: textura R8, um texel por célula
+	GLuint lightTexID;	// luz das tochas: textura R8, um texel por célula
+};
+
+#define MAP_WIDTH 32
+#define MAP_HEIGHT 20
+
+// Camadas do mapa, de trás para a frente. A de colisão só aparece quando ligada (tecla C);
+// a de sobreposição é desenhada depois dos sprites, na frente deles.
+enum LayerIndex
+{
+	LAYER_BACK,
+	LAYER_GROUND,
+	LAYER_DECOR,
+	LAYER_COLLISION,
+	LAYER_OVERLAY,
+	N_LAYERS
+};
+
+// Célula vazia numa camada (não desenha; deixa ver as camadas de trás)
+const int EMPTY_TILE = 0xFFFF;
+
+struct TileLayer
+{
+	const char *name;
+	vec2 parallax; // quanto a camada anda com a câmera (1 = junto com o chão)
+	vec4 tint;	   // cor e opacidade multiplicadas no tile (alfa 0 = camada desligada)
+	int ids[MAP_HEIGHT][MAP_WIDTH];
 };
 
-#define MAP_WIDTH 5
-#define MAP_HEIGHT 5
-
-int tilemap[MAP_HEIGHT][MAP_WIDTH] = {
-	1,
-	1,
-	1,
-	1,
-	1,
-	0,
-	1,
-	1,
-	1,
-	0,
-	4,
-	0,
-	0,
-	0,
-	4,
-	5,
-	4,
-	4,
-	4,
-	5,
-	5,
-	5,
-	5,
-	5,
-	5,
+TileLayer layers[N_LAYERS];
+
+// Quadros dos tiles animados (lava e água funda), lidos de assets/tilesets/tileset.json
+TileAnimationTable tileAnimations;
+
+// Chão: um dígito por tile (ID no tileset); '.' é um buraco, onde aparece o fundo
+const char *groundRows[MAP_HEIGHT] = {
+	"11111111111011111111111010111011",
+	"01110101011011010111111111111110",
+	"40004000100100011000001100010000",
+	"54445444401000001000101101000000",
+	"55555555500110000101000011100110",
+	"11001111411101140111110111214411",
+	"01140100111110241114111111214014",
+	"04401111114101144001140101014141",
+	"10011422010141011011011441114441",
+	"10004020104111010010114011110010",
+	"01114410011140441110410133334101",
+	"40401014410110111144101433331411",
+	"10101101014100011011221133331404",
+	"0111110011114...1010021111101101",
+	"011010011141.....040440010140111",
+	"001011111211.....111400401110441",
+	"010111110211.....101111110100111",
+	"141000041211.....100104111041010",
+	"010401401111.....000104101110140",
+	"141101141101.....101000101101011",
 };
 
+// Flags de cada tile do tileset, pelo ID: 0 areia, 1 grama, 2 pedra, 3 lava,
+// 4 gelo, 5 água funda, 6 rosa. Pedra, lava e água funda bloqueiam a passagem.
+// Depois deles o tileset tem os quadros de animação (7 e 8 da lava, 9 e 10 da água),
+// que nunca aparecem no mapa: o mapa guarda o ID base e o shader troca o quadro.
+const int N_MAP_TILES = 7;
+const int N_TILESET_COLUMNS = 11;
+const uint8_t tileFlags[N_MAP_TILES] = {0, 0, TILE_SOLID, TILE_SOLID, 0, TILE_SOLID, 0};
+
+// Na camada de colisão, as células sólidas guardam este ID (lava, que tem a flag)
+const int COLLISION_TILE = 3;
+
+TileCollisionLayer collision;
+CharacterController controller(12.0, 12.0); // caixa de colisão menor que o desenho do sprite
+
+// Visão do sprite: só a pedra bloqueia a visão (lava e água funda barram a passagem,
+// mas dá para ver por cima delas). Células fora do raio ou atrás de pedra ficam na névoa.
+const uint8_t sightFlags[N_MAP_TILES] = {0, 0, TILE_SOLID, 0, 0, 0, 0};
+const int SIGHT_RADIUS = 7;
+
+TileCollisionLayer sightBlockers;
+FogOfWar fog;
+int fogViewer;
+bool fogEnabled = true;
+
+// Luz: a lava brilha sozinha, o sprite carrega uma tocha e T acende/apaga uma tocha no
+// chão onde ele está. A luz passa por onde a visão passa (só a pedra bloqueia).
+const int LAVA_TILE = 3;
+const int LAVA_LIGHT = 6, TORCH_LIGHT = 9, CARRIED_LIGHT = 7;
+const float AMBIENT = 0.3; // luz mínima, longe das fontes
+
+TileLightMap lighting;
+int carriedLight;
+int cellLight[MAP_HEIGHT][MAP_WIDTH]; // fonte própria de cada célula (-1: nenhuma)
+bool lightingEnabled = true;
+
 // Protótipo da função de callback de teclado
 void key_callback(GLFWwindow *window, int key, int scancode, int action, int mode);
+void scroll_callback(GLFWwindow *window, double xoffset, double yoffset);
 
 // Protótipos das funções
 int setupShader();
-int setupSprite(int nAnimations, int nFrames, float &ds, float &dt);
+int setupShader(const GLchar *vsSource, const GLchar *fsSource);
+int setupSprite();
 int setupTileset(int nTiles, float &ds);
+void setupLayers();
+GLuint setupLayersTexture();
+GLuint setupCellTexture();
+void uploadCellRect(GLuint texID, int c0, int r0, int w, int h, const GLubyte *bytes);
+void uploadFog(Tileset &tileset);
+void uploadLight(Tileset &tileset);
+void setCellLight(int i, int j, int level);
+void uploadLayerParams(GLuint shaderID);
+void setTile(Tileset &tileset, int layer, int i, int j, int id);
 int loadTexture(string filePath);
 void drawSprite(GLuint shaderID, Sprite spr);
-void drawTilemap(GLuint shaderID, Tileset tileset);
+void updateSprite(Sprite &spr, float dt);
+void drawTileLayers(GLuint shaderID, Tileset tileset, int first, int last, float time);
 
 // Dimensões da janela (pode ser alterado em tempo de execução)
 const GLuint WIDTH = 800, HEIGHT = 600;
@@ -123,11 +218,14 @@ const GLchar *vertexShaderSource = R"(
  
  uniform mat4 projection;
  uniform mat4 model;
+ uniform vec4 uv_rect; // quadro na spritesheet: (s0, t0) superior esquerdo, (s1, t1) inferior direito
  out vec2 tex_coord;
+ out vec2 world_pos;
  void main()
  {
-	tex_coord = vec2(texc.s,1.0-texc.t);
-	gl_Position = projection * model * vec4(position, 0.0, 1.0);
+	tex_coord = mix(uv_rect.xy, uv_rect.zw, texc);
+	world_pos = (model * vec4(position, 0.0, 1.0)).xy;
+	gl_Position = projection * vec4(world_pos, 0.0, 1.0);
  }
  )";
 
@@ -135,24 +233,148 @@ const GLchar *vertexShaderSource = R"(
 const GLchar *fragmentShaderSource = R"(
  #version 400
 in vec2 tex_coord;
+in vec2 world_pos;
 out vec4 color;
 uniform sampler2D tex_buff;
-uniform vec2 offset_tex;
+uniform sampler2D light_map; // luz das tochas por célula do mapa (a mesma do tilemap)
+uniform vec4 map_rect;		 // (left, top, largura do tile, altura do tile)
+uniform float ambient;
+const vec3 TORCH_COLOR = vec3(1.0, 0.85, 0.6);
+void main()
+{
+	 color = texture(tex_buff,tex_coord);
+	 vec2 cell = vec2(world_pos.x - map_rect.x, map_rect.y - world_pos.y) / map_rect.zw;
+	 float light = texture(light_map, cell / vec2(textureSize(light_map, 0))).r;
+	 color.rgb *= vec3(ambient) + (1.0 - ambient) * light * TORCH_COLOR;
+}
+)";
+
+// Shader do tilemap: um único quad cobrindo a tela. Para cada pixel, o fragment shader
+// percorre as camadas pedidas de trás para a frente: acha a célula na camada (deslocada
+// pela câmera vezes o fator de parallax dela), lê o ID do tile na fatia da textura de
+// índices e compõe a cor do tileset sobre as camadas anteriores.
+const GLchar *tileVertexShaderSource = R"(
+ #version 400
+ layout (location = 0) in vec2 position;
+
+ uniform mat4 projection;
+ uniform vec4 view_rect; // (minX, minY, maxX, maxY): área da tela coberta pelo quad
+ out vec2 screen_pos;
+ void main()
+ {
+	screen_pos = mix(view_rect.xy, view_rect.zw, position + 0.5);
+	gl_Position = projection * vec4(screen_pos, 0.0, 1.0);
+ }
+ )";
+
+const GLchar *tileFragmentShaderSource = R"(
+ #version 400
+ #define MAX_LAYERS 8
+ #define TILE_ANIM_MAX_IDS 64
+ #define TILE_ANIM_MAX_FRAMES 256
+in vec2 screen_pos;
+out vec4 color;
+uniform sampler2D tex_buff;		// tileset
+uniform usampler2DArray tile_layers; // ID do tile de cada célula, uma fatia por camada (R16UI)
+uniform vec4 map_rect;			// (left, top, largura do tile, altura do tile)
+uniform float ds;				// largura de um tile no tileset
+uniform vec2 camera;			// ponto do mundo no centro da tela
+uniform float zoom;				// pixels de tela por unidade do mundo
+uniform vec2 view_size;			// tamanho da tela, em pixels
+uniform int layer_first, layer_last;
+uniform vec2 layer_parallax[MAX_LAYERS];
+uniform vec4 layer_tint[MAX_LAYERS];
+uniform float time;				// tempo de simulação, em segundos
+uniform sampler2D fog;			// névoa (R8): 1 visível, ~0.4 já visto, 0 nunca visto
+uniform bool fog_enabled;
+uniform sampler2D light_map;	// luz das tochas (R8), 1 = nível máximo
+uniform float ambient;			// luz mínima (1 = iluminação desligada)
+
+const vec3 TORCH_COLOR = vec3(1.0, 0.85, 0.6);
+
+// Tabela de animação dos tiles (TileAnimation.h), enviada uma vez
+struct TileAnim { int first; int count; float frameDuration; float pad; };
+layout (std140) uniform TileAnimations
+{
+	TileAnim tile_anim[TILE_ANIM_MAX_IDS];
+	ivec4 tile_frames[TILE_ANIM_MAX_FRAMES / 4];
+};
+
+// Quadro atual de um tile animado; os outros IDs passam direto
+uint animatedTile(uint id)
+{
+	if (id >= uint(TILE_ANIM_MAX_IDS) || tile_anim[id].count == 0)
+		return id;
+	TileAnim a = tile_anim[id];
+	int f = a.first + int(floor(time / a.frameDuration)) % a.count;
+	return uint(tile_frames[f / 4][f % 4]);
+}
+
 void main()
 {
-	 color = texture(tex_buff,tex_coord + offset_tex);
+	ivec2 size = textureSize(tile_layers, 0).xy;
+	vec3 premul = vec3(0.0); // cor acumulada, pré-multiplicada pelo alfa
+	float alpha = 0.0;
+	for (int l = layer_first; l <= layer_last; l++)
+	{
+		if (layer_tint[l].a <= 0.0)
+			continue;
+		// Posição do pixel na camada, com a linha 0 no topo
+		vec2 p = camera * layer_parallax[l] + (screen_pos - 0.5 * view_size) / zoom;
+		vec2 cell = vec2(p.x - map_rect.x, map_rect.y - p.y) / map_rect.zw;
+		ivec2 ij = ivec2(floor(cell));
+		if (any(lessThan(ij, ivec2(0))) || any(greaterThanEqual(ij, size)))
+			continue; // fora desta camada
+		uint id = texelFetch(tile_layers, ivec3(ij, l), 0).r;
+		if (id == 0xFFFFu)
+			continue; // célula vazia
+		id = animatedTile(id);
+		vec2 f = fract(cell);
+		vec4 c = texture(tex_buff, vec2((float(id) + f.x) * ds, f.y)) * layer_tint[l];
+		premul = c.rgb * c.a + premul * (1.0 - c.a);
+		alpha = c.a + alpha * (1.0 - c.a);
+	}
+	if (alpha <= 0.0)
+		discard;
+	// Névoa pela célula do chão sob o pixel; o filtro linear suaviza a borda entre células
+	vec2 g = camera + (screen_pos - 0.5 * view_size) / zoom;
+	vec2 ground = vec2(g.x - map_rect.x, map_rect.y - g.y) / map_rect.zw;
+	float visibility = fog_enabled ? texture(fog, ground / vec2(size)).r : 1.0;
+	float light = texture(light_map, ground / vec2(size)).r;
+	vec3 lit = vec3(ambient) + (1.0 - ambient) * light * TORCH_COLOR;
+	color = vec4(premul / alpha * lit * visibility, alpha);
 }
 )";
 
+GLuint tileShaderID;
+
+// Medição de tempos por frame (P grava o trace em frame_trace.json)
+FrameProfiler profiler;
+
+// Modo de ritmo dos frames (V alterna entre os modos; --pacing/--fps na linha de comando)
+FramePacer pacer;
+BenchmarkHarness benchmark(profiler);
+
 bool keys[1024];
-float FPS = 12.0;
-float lastTime = 0.0;
+
+// Câmera da cena (o zoom também muda pela roda do mouse, em scroll_callback)
+Camera2D camera(WIDTH, HEIGHT);
+
+// Clipes da spritesheet dos inimigos e o estado de reprodução de cada sprite animado
+AnimationLibrary enemyClips;
+AnimationPlayers animations(enemyClips);
 
 // Função MAIN
-int main()
+int main(int argc, char **argv)
 {
-	// Inicialização da GLFW
-	glfwInit();
+	// Inicialização da GLFW (no modo benchmark sem display, com a plataforma nula)
+	if (!benchmark.parseArgs(argc, argv))
+	{
+		std::cout << "Opcoes de benchmark invalidas" << std::endl;
+		return 1;
+	}
+	if (!benchmark.initGLFW())
+		return -1;
 
 	// Muita atenção aqui: alguns ambientes não aceitam essas configurações
 	// Você deve adaptar para a versão do OpenGL suportada por sua placa
@@ -177,7 +399,7 @@ int main()
 	}
 
 	// Criação da janela GLFW
-	GLFWwindow *window = glfwCreateWindow(WIDTH, HEIGHT, "Ola Tilemap! -- Rossana", nullptr, nullptr);
+	GLFWwindow *window = benchmark.createWindow(WIDTH, HEIGHT, "Ola Tilemap! -- Rossana");
 	if (!window)
 	{
 		std::cerr << "Falha ao criar a janela GLFW" << std::endl;
@@ -188,6 +410,7 @@ int main()
 
 	// Fazendo o registro da função de callback para a janela GLFW
 	glfwSetKeyCallback(window, key_callback);
+	glfwSetScrollCallback(window, scroll_callback);
 
 	// GLAD: carrega todos os ponteiros d funções da OpenGL
 	if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
@@ -209,27 +432,37 @@ int main()
 
 	// Compilando e buildando o programa de shader
 	GLuint shaderID = setupShader();
+	tileShaderID = setupShader(tileVertexShaderSource, tileFragmentShaderSource);
 
 	Sprite background, spr1, spr2;
 
 	// Gerando um buffer simples, com a geometria de um triângulo
-	background.VAO = setupSprite(1, 1, background.ds, background.dt);
+	background.VAO = setupSprite();
 	background.texID = loadTexture("../assets/tex/1.png");
 	background.pos = vec3(400, 300, 0);
 	background.dimensions = vec3(800, 600, 1);
 	background.angle = 0.0;
+	background.anim = -1;
 
-	// Carregando uma textura
-	spr1.VAO = setupSprite(12, 2, spr1.ds, spr1.dt);
-	spr1.texID = loadTexture("../assets/sprites/enemies-spritesheet1.png");
+	// Carregando a descrição dos clipes e a textura indicada nela
+	if (!enemyClips.load("../assets/sprites/enemies-spritesheet1.json"))
+	{
+		glfwTerminate();
+		return -1;
+	}
+	spr1.VAO = setupSprite();
+	spr1.texID = loadTexture(enemyClips.texturePath);
 	spr1.pos = vec3(400, 300, 0);
 	spr1.dimensions = vec3(20 * 2, 20 * 2, 1);
-	spr1.vel = 1.5;
-	spr1.nAnimations = 12;
-	spr1.nFrames = 2;
+	spr1.vel = 90.0;
 	spr1.angle = 0.0;
-	spr1.iAnimation = 9;
-	spr1.iFrame = 0;
+	spr1.anim = animations.add(enemyClips.requireClip("andador_0"));
+	if (spr1.anim < 0)
+	{
+		glfwTerminate();
+		return -1;
+	}
+	spr1.prevPos = spr1.pos;
 
 	// spr2.VAO = VAO;
 	// spr2.texID = loadTexture("../assets/sprites/microbio.png");
@@ -237,30 +470,113 @@ int main()
 	// spr2.dimensions = vec3(32 * 4, 26 * 4, 1);
 
 	Tileset tileset;
-	tileset.nTiles = 7;
+	tileset.nTiles = N_TILESET_COLUMNS;
 	tileset.VAO = setupTileset(tileset.nTiles, tileset.ds);
 	tileset.pos = vec3(0.0, 0.0, 0.0);
 	tileset.dimensions = vec3(39, 39, 1);
 	tileset.texID = loadTexture("../assets/tilesets/tileset.png");
 
+	// Animações dos tiles: a tabela vai para o UBO uma vez e o shader faz o resto
+	if (!tileAnimations.load("../assets/tilesets/tileset.json", tileset.nTiles))
+	{
+		glfwTerminate();
+		return -1;
+	}
+	tileAnimations.upload();
+
+	// Camadas do mapa e a textura com os IDs de todas elas
+	setupLayers();
+	tileset.layersTexID = setupLayersTexture();
+
+	// Colisão montada a partir da camada de colisão (linha 0 no topo da tela)
+	collision.build(&layers[LAYER_COLLISION].ids[0][0], MAP_WIDTH, MAP_HEIGHT, tileFlags, N_MAP_TILES,
+					tileset.dimensions.x, tileset.dimensions.y, 0.0, HEIGHT);
+
+	// O sprite começa no centro do tile (i=3, j=2) e dali anda só por onde o mapa deixa
+	spr1.pos.x = collision.colLeft(2) + tileset.dimensions.x / 2.0;
+	spr1.pos.y = collision.rowTop(3) - tileset.dimensions.y / 2.0;
+	spr1.prevPos = spr1.pos;
+
+	// Campo de visão do sprite sobre o chão; a textura de névoa começa toda escura
+	sightBlockers.build(&layers[LAYER_GROUND].ids[0][0], MAP_WIDTH, MAP_HEIGHT, sightFlags, N_MAP_TILES,
+						tileset.dimensions.x, tileset.dimensions.y, 0.0, HEIGHT);
+	fog.init(sightBlockers);
+	fogViewer = fog.addViewer(collision.colAt(spr1.pos.x), collision.rowAt(spr1.pos.y), SIGHT_RADIUS);
+	tileset.fogTexID = setupCellTexture();
+	fog.update();
+	uploadFog(tileset);
+
+	// Luz: uma fonte em cada tile de lava, mais a tocha que o sprite carrega
+	lighting.init(sightBlockers);
+	for (int i = 0; i < MAP_HEIGHT; i++)
+		for (int j = 0; j < MAP_WIDTH; j++)
+		{
+			cellLight[i][j] = -1;
+			if (layers[LAYER_GROUND].ids[i][j] == LAVA_TILE)
+				setCellLight(i, j, LAVA_LIGHT);
+		}
+	carriedLight = lighting.addLight(collision.colAt(spr1.pos.x), collision.rowAt(spr1.pos.y), CARRIED_LIGHT);
+	tileset.lightTexID = setupCellTexture();
+	lighting.update();
+	uploadLight(tileset);
+
 	glUseProgram(shaderID); // Reseta o estado do shader para evitar problemas futuros
 
+	// Queries de tempo da GPU e, no modo benchmark, o FBO de destino
+	benchmark.setup();
+
+	// Intervalo de swap conforme o modo de ritmo (o benchmark sempre roda sem limite)
+	pacer.parseArgs(argc, argv);
+	if (benchmark.enabled())
+		pacer.setMode(PACE_UNTHROTTLED);
+	else
+		pacer.apply();
+
 	double prev_s = glfwGetTime();	// Define o "tempo anterior" inicial.
-	double title_countdown_s = 0.1; // Intervalo para atualizar o título da janela com o FPS.
+	double title_countdown_s = 0.5; // Intervalo para atualizar o título da janela com as estatísticas.
+
+	// Movimento e animação avançam em passos fixos de 1/60 s, independentes do FPS
+	FixedTimestep gameLoop(1.0 / 60.0, 5);
+	double sim_prev_s = glfwGetTime();
 
 	float colorValue = 0.0;
+	bool mouseWasDown = false;
+	bool torchKeyWasDown = false;
+
+	// Limites do mapa no mundo, para a câmera não mostrar o que está fora dele
+	float mapLeft = collision.colLeft(0), mapRight = collision.colLeft(MAP_WIDTH);
+	float mapTop = collision.rowTop(0), mapBottom = collision.rowTop(MAP_HEIGHT);
+	camera.center = vec2(spr1.pos.x, spr1.pos.y);
+	camera.clampTo(mapLeft, mapBottom, mapRight, mapTop);
 
 	// Ativando o primeiro buffer de textura do OpenGL
 	glActiveTexture(GL_TEXTURE0);
 
 	// Criando a variável uniform pra mandar a textura pro shader
 	glUniform1i(glGetUniformLocation(shaderID, "tex_buff"), 0);
+	// Os sprites leem a luz da mesma textura do tilemap, pela célula onde estão
+	glUniform1i(glGetUniformLocation(shaderID, "light_map"), 3);
+	glUniform4f(glGetUniformLocation(shaderID, "map_rect"), collision.left, collision.top, collision.tileW, collision.tileH);
 
-	// Criação da matriz de projeção paralela ortográfica
+	// Criação da matriz de projeção paralela ortográfica. O quad do tilemap é desenhado
+	// em coordenadas de tela; a dos sprites é deslocada pela câmera a cada frame
 	mat4 projection = mat4(1); // matriz identidade
 	projection = ortho(0.0, 800.0, 0.0, 600.0, -1.0, 1.0);
-	// Envio para o shader
-	glUniformMatrix4fv(glGetUniformLocation(shaderID, "projection"), 1, GL_FALSE, value_ptr(projection));
+
+	// Parâmetros fixos do tilemap e das camadas: a cada frame só muda a câmera
+	glUseProgram(tileShaderID);
+	glUniform1i(glGetUniformLocation(tileShaderID, "tex_buff"), 0);
+	glUniform1i(glGetUniformLocation(tileShaderID, "tile_layers"), 1);
+	glUniform1i(glGetUniformLocation(tileShaderID, "fog"), 2);
+	glUniform1i(glGetUniformLocation(tileShaderID, "fog_enabled"), fogEnabled);
+	glUniform1i(glGetUniformLocation(tileShaderID, "light_map"), 3);
+	glUniformMatrix4fv(glGetUniformLocation(tileShaderID, "projection"), 1, GL_FALSE, value_ptr(projection));
+	glUniform2f(glGetUniformLocation(tileShaderID, "view_size"), WIDTH, HEIGHT);
+	glUniform4f(glGetUniformLocation(tileShaderID, "map_rect"), collision.left, collision.top, collision.tileW, collision.tileH);
+	glUniform1f(glGetUniformLocation(tileShaderID, "ds"), tileset.ds);
+	uploadLayerParams(tileShaderID);
+	TileAnimationTable::bindProgram(tileShaderID);
+	glUseProgram(shaderID);
 
 	// Habilitando transparência/função de mistura
 	glEnable(GL_BLEND);
@@ -271,81 +587,164 @@ int main()
 	glDepthFunc(GL_ALWAYS);
 
 	// Loop da aplicação - "game loop"
-	while (!glfwWindowShouldClose(window))
+	while (benchmark.running(window))
 	{
-		// Este trecho de código é totalmente opcional: calcula e mostra a contagem do FPS na barra de título
-		{
-			double curr_s = glfwGetTime();		// Obtém o tempo atual.
-			double elapsed_s = curr_s - prev_s; // Calcula o tempo decorrido desde o último frame.
-			prev_s = curr_s;					// Atualiza o "tempo anterior" para o próximo frame.
+		// Início da medição do frame (CPU e GPU)
+		benchmark.beginFrame();
 
-			// Exibe o FPS, mas não a cada frame, para evitar oscilações excessivas.
-			title_countdown_s -= elapsed_s;
-			if (title_countdown_s <= 0.0 && elapsed_s > 0.0)
+		// Mostra as estatísticas do profiler na barra de título, algumas vezes por segundo
+		{
+			double curr_s = glfwGetTime();
+			title_countdown_s -= curr_s - prev_s;
+			prev_s = curr_s;
+			if (title_countdown_s <= 0.0)
 			{
-				double fps = 1.0 / elapsed_s; // Calcula o FPS com base no tempo decorrido.
-
-				// Cria uma string e define o FPS como título da janela.
-				char tmp[256];
-				sprintf(tmp, "Ola Triangulo! -- Rossana\tFPS %.2lf", fps);
-				glfwSetWindowTitle(window, tmp);
-
-				title_countdown_s = 0.1; // Reinicia o temporizador para atualizar o título periodicamente.
+				char pacing[128];
+				pacer.describe(pacing, sizeof(pacing));
+				string title = "Ola Tilemap! -- Rossana | " + profiler.summary() + " | " + pacing;
+				glfwSetWindowTitle(window, title.c_str());
+				title_countdown_s = 0.5;
 			}
 		}
 
 		// Checa se houveram eventos de input (key pressed, mouse moved etc.) e chama as funções de callback correspondentes
 		glfwPollEvents();
+		pacer.markInput();
 
 		// Limpa o buffer de cor
 		glClearColor(0.0f, 0.0f, 0.0f, 1.0f); // cor de fundo
 		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-		if (keys[GLFW_KEY_LEFT] == true || keys[GLFW_KEY_A] == true)
+		// Simulação em passos fixos. No benchmark cada frame vale exatamente um passo,
+		// para que o frame capturado seja sempre o mesmo
+		double sim_curr_s = glfwGetTime();
+		double sim_elapsed_s = benchmark.enabled() ? gameLoop.step() : sim_curr_s - sim_prev_s;
+		sim_prev_s = sim_curr_s;
+		int steps = gameLoop.advance(sim_elapsed_s);
+		for (int i = 0; i < steps; i++)
 		{
-			spr1.pos.x -= spr1.vel;
+			updateSprite(spr1, gameLoop.step());
+			// Animação de todos os sprites de uma vez, no mesmo passo
+			animations.update(gameLoop.step());
 		}
-		if (keys[GLFW_KEY_RIGHT] == true || keys[GLFW_KEY_D] == true)
+		// Clique esquerdo: o tile sob o cursor passa para o próximo ID do tileset
+		bool mouseDown = glfwGetMouseButton(window, GLFW_MOUSE_BUTTON_LEFT) == GLFW_PRESS;
+		if (!benchmark.enabled() && mouseDown && !mouseWasDown)
 		{
-			spr1.pos.x += spr1.vel;
+			double mx, my;
+			int winW, winH;
+			glfwGetCursorPos(window, &mx, &my);
+			glfwGetWindowSize(window, &winW, &winH);
+			vec2 world = camera.screenToWorld(vec2(mx * WIDTH / winW, HEIGHT - my * HEIGHT / winH));
+			int j = collision.colAt(world.x);
+			int i = collision.rowAt(world.y);
+			if (i >= 0 && i < MAP_HEIGHT && j >= 0 && j < MAP_WIDTH)
+			{
+				int id = layers[LAYER_GROUND].ids[i][j];
+				setTile(tileset, LAYER_GROUND, i, j, id == EMPTY_TILE ? 0 : (id + 1) % N_MAP_TILES);
+			}
 		}
-		// glUniform2f(glGetUniformLocation(shaderID, "offset_tex"),0.0,0.0);
+		mouseWasDown = mouseDown;
 
-		// drawSprite(shaderID,background);
+		// Roteiro do benchmark: o sprite dá uma volta em elipse sobre o mapa, e a câmera o
+		// segue como no jogo
+		if (benchmark.enabled())
+		{
+			float angle = benchmark.progress() * 6.2831853f;
+			spr1.pos.x = (mapLeft + mapRight) * 0.5f + (mapRight - mapLeft) * 0.35f * cosf(angle);
+			spr1.pos.y = (mapTop + mapBottom) * 0.5f + (mapTop - mapBottom) * 0.35f * sinf(angle);
+			spr1.prevPos = spr1.pos;
+		}
+
+		// Visão: só é refeita quando o sprite troca de célula ou um tile do chão muda,
+		// e só a parte alterada da névoa vai para a textura
+		fog.moveViewer(fogViewer, collision.colAt(spr1.pos.x), collision.rowAt(spr1.pos.y));
+		if (fog.update() > 0)
+			uploadFog(tileset);
+
+		// T acende/apaga uma tocha na célula do sprite (não mexe na lava)
+		int spriteCol = collision.colAt(spr1.pos.x), spriteRow = collision.rowAt(spr1.pos.y);
+		bool torchKeyDown = keys[GLFW_KEY_T];
+		if (!benchmark.enabled() && torchKeyDown && !torchKeyWasDown && spriteCol >= 0 && spriteCol < MAP_WIDTH &&
+			spriteRow >= 0 && spriteRow < MAP_HEIGHT && layers[LAYER_GROUND].ids[spriteRow][spriteCol] != LAVA_TILE)
+			setCellLight(spriteRow, spriteCol, cellLight[spriteRow][spriteCol] < 0 ? TORCH_LIGHT : 0);
+		torchKeyWasDown = torchKeyDown;
+
+		// Luz: a tocha do sprite só mexe no mapa de luz quando ele troca de célula, e só
+		// o retângulo alterado vai para a textura
+		lighting.moveLight(carriedLight, spriteCol, spriteRow);
+		if (lighting.update() > 0)
+			uploadLight(tileset);
+		float ambient = lightingEnabled ? AMBIENT : 1.0; // 1: sem iluminação
+		glUseProgram(tileShaderID);
+		glUniform1f(glGetUniformLocation(tileShaderID, "ambient"), ambient);
+		glUseProgram(shaderID);
+		glUniform1f(glGetUniformLocation(shaderID, "ambient"), ambient);
+
+		// Desenha o sprite entre a posição do passo anterior e a do atual
+		Sprite spr1Draw = spr1;
+		spr1Draw.pos = mix(spr1.prevPos, spr1.pos, gameLoop.alpha());
+
+		// Relógio das animações de tile: tempo simulado (no benchmark, sempre o mesmo por frame),
+		// mantido pequeno para não perder precisão no float do shader
+		float tileTime = (float)fmod(gameLoop.simulatedTime(), 3600.0);
+
+		// Câmera: Q/E aproximam e afastam (a roda do mouse também, no cursor); o centro
+		// segue o sprite suavemente, em frações de pixel, sem sair do mapa
+		float frame_dt = (float)sim_elapsed_s;
+		if (keys[GLFW_KEY_Q])
+			camera.zoomAt(camera.viewport * 0.5f, exp2f(-frame_dt));
+		if (keys[GLFW_KEY_E])
+			camera.zoomAt(camera.viewport * 0.5f, exp2f(frame_dt));
+		camera.follow(vec2(spr1Draw.pos.x, spr1Draw.pos.y), frame_dt, 0.12);
+		camera.clampTo(mapLeft, mapBottom, mapRight, mapTop);
+		glUseProgram(shaderID);
+		glUniformMatrix4fv(glGetUniformLocation(shaderID, "projection"), 1, GL_FALSE, value_ptr(camera.projection()));
 
-		drawTilemap(shaderID, tileset);
+		// glUniform2f(glGetUniformLocation(shaderID, "offset_tex"),0.0,0.0);
 
-		float x0 = tileset.dimensions.x/2.0;
-		float y0 = tileset.dimensions.y/2.0;
-		int i = 3;
-		int j = 2;
+		// drawSprite(shaderID,background);
 
-		spr1.pos.x = x0 + j * tileset.dimensions.x;
-		spr1.pos.y = HEIGHT - y0 - i * tileset.dimensions.y;
-		spr1.pos.z = 0.0;
+		{
+			// Camadas atrás dos sprites, compostas num único quad
+			ProfileScope cpu(profiler, "tilemap");
+			GpuProfileScope gpu(profiler, "tilemap");
+			drawTileLayers(tileShaderID, tileset, LAYER_BACK, LAYER_COLLISION, tileTime);
+		}
+		glUseProgram(shaderID);
 
-		float offsetS = spr1.iFrame * spr1.ds;
-		float offsetT = spr1.iAnimation * spr1.dt;
-		glUniform2f(glGetUniformLocation(shaderID, "offset_tex"),offsetS,offsetT);
-		drawSprite(shaderID,spr1);
+		{
+			ProfileScope cpu(profiler, "sprites");
+			GpuProfileScope gpu(profiler, "sprites");
+			drawSprite(shaderID,spr1Draw);
+		}
 
-		float now = glfwGetTime();
-		float deltaTime = now - lastTime;
-		if (deltaTime >= 1/FPS)
 		{
-			spr1.iFrame = (spr1.iFrame + 1) % spr1.nFrames;
-			lastTime = now;
+			ProfileScope cpu(profiler, "overlay");
+			GpuProfileScope gpu(profiler, "overlay");
+			drawTileLayers(tileShaderID, tileset, LAYER_OVERLAY, LAYER_OVERLAY, tileTime);
 		}
+
 		
 
 		
 
-		// Troca os buffers da tela
-		glfwSwapBuffers(window);
+		benchmark.endFrame();
+
+		// Troca os buffers da tela (com a espera do modo de ritmo) e mede a latência
+		pacer.present(window);
 	}
+	profiler.printStats();
+	// Relatório do benchmark e, se pedida, comparação com a imagem de referência
+	bool passed = benchmark.finish("tiles");
+	profiler.destroy();
+	glDeleteTextures(1, &tileset.layersTexID);
+	glDeleteTextures(1, &tileset.fogTexID);
+	glDeleteTextures(1, &tileset.lightTexID);
+	tileAnimations.destroy();
 	// Finaliza a execução da GLFW, limpando os recursos alocados por ela
 	glfwTerminate();
-	return 0;
+	return passed ? 0 : 1;
 }
 
 // Função de callback de teclado - só pode ter uma instância (deve ser estática se
@@ -356,6 +755,38 @@ void key_callback(GLFWwindow *window, int key, int scancode, int action, int mod
 	if (key == GLFW_KEY_ESCAPE && action == GLFW_PRESS)
 		glfwSetWindowShouldClose(window, GL_TRUE);
 
+	if (key == GLFW_KEY_P && action == GLFW_PRESS)
+	{
+		if (profiler.exportChromeTrace("frame_trace.json"))
+			cout << "Trace gravado em frame_trace.json (abrir em ui.perfetto.dev)" << endl;
+	}
+
+	if (key == GLFW_KEY_V && action == GLFW_PRESS)
+	{
+		pacer.cycleMode();
+		cout << "Ritmo dos frames: " << FramePacer::modeName(pacer.currentMode()) << endl;
+	}
+
+	// C mostra/esconde a camada de colisão por cima do chão
+	if (key == GLFW_KEY_C && action == GLFW_PRESS)
+	{
+		vec4 &tint = layers[LAYER_COLLISION].tint;
+		tint.a = tint.a > 0.0 ? 0.0 : 0.5;
+		uploadLayerParams(tileShaderID);
+	}
+
+	// L liga/desliga a iluminação (o ambiente vai para 1 no próximo frame)
+	if (key == GLFW_KEY_L && action == GLFW_PRESS)
+		lightingEnabled = !lightingEnabled;
+
+	// F liga/desliga a névoa de guerra
+	if (key == GLFW_KEY_F && action == GLFW_PRESS)
+	{
+		fogEnabled = !fogEnabled;
+		glUseProgram(tileShaderID);
+		glUniform1i(glGetUniformLocation(tileShaderID, "fog_enabled"), fogEnabled);
+	}
+
 	if (action == GLFW_PRESS)
 	{
 		keys[key] = true;
@@ -366,16 +797,32 @@ void key_callback(GLFWwindow *window, int key, int scancode, int action, int mod
 	}
 }
 
+// Roda do mouse: zoom em torno do ponto sob o cursor
+void scroll_callback(GLFWwindow *window, double xoffset, double yoffset)
+{
+	double mx, my;
+	int winW, winH;
+	glfwGetCursorPos(window, &mx, &my);
+	glfwGetWindowSize(window, &winW, &winH);
+	camera.zoomAt(vec2(mx * WIDTH / winW, HEIGHT - my * HEIGHT / winH), powf(1.1f, (float)yoffset));
+}
+
 // Esta função está bastante hardcoded - objetivo é compilar e "buildar" um programa de
 //  shader simples e único neste exemplo de código
 //  O código fonte do vertex e fragment shader está nos arrays vertexShaderSource e
 //  fragmentShader source no iniçio deste arquivo
 //  A função retorna o identificador do programa de shader
 int setupShader()
+{
+	return setupShader(vertexShaderSource, fragmentShaderSource);
+}
+
+// Versão que recebe os códigos fonte - usada para o shader do tilemap
+int setupShader(const GLchar *vsSource, const GLchar *fsSource)
 {
 	// Vertex shader
 	GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
-	glShaderSource(vertexShader, 1, &vertexShaderSource, NULL);
+	glShaderSource(vertexShader, 1, &vsSource, NULL);
 	glCompileShader(vertexShader);
 	// Checando erros de compilação (exibição via log no terminal)
 	GLint success;
@@ -389,7 +836,7 @@ int setupShader()
 	}
 	// Fragment shader
 	GLuint fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-	glShaderSource(fragmentShader, 1, &fragmentShaderSource, NULL);
+	glShaderSource(fragmentShader, 1, &fsSource, NULL);
 	glCompileShader(fragmentShader);
 	// Checando erros de compilação (exibição via log no terminal)
 	glGetShaderiv(fragmentShader, GL_COMPILE_STATUS, &success);
@@ -423,12 +870,10 @@ int setupShader()
 // Apenas atributo coordenada nos vértices
 // 1 VBO com as coordenadas, VAO com apenas 1 ponteiro para atributo
 // A função retorna o identificador do VAO
-int setupSprite(int nAnimations, int nFrames, float &ds, float &dt)
+// As coordenadas de textura vão de (0,0) no canto superior esquerdo a (1,1) no inferior
+// direito; o shader as mapeia para o retângulo do quadro atual (uv_rect)
+int setupSprite()
 {
-
-	ds = 1.0 / (float)nFrames;
-	dt = 1.0 / (float)nAnimations;
-
 	// Aqui setamos as coordenadas x, y e z do triângulo e as armazenamos de forma
 	// sequencial, já visando mandar para o VBO (Vertex Buffer Objects)
 	// Cada atributo do vértice (coordenada, cores, coordenadas de textura, normal, etc)
@@ -438,27 +883,27 @@ int setupSprite(int nAnimations, int nFrames, float &ds, float &dt)
 		-0.5,
 		0.5,
 		0.0,
-		dt,
+		0.0,
 		-0.5,
 		-0.5,
 		0.0,
-		0.0,
+		1.0,
 		0.5,
 		0.5,
-		ds,
-		dt,
+		1.0,
+		0.0,
 		-0.5,
 		-0.5,
 		0.0,
-		0.0,
+		1.0,
 		0.5,
 		-0.5,
-		ds,
-		0.0,
+		1.0,
+		1.0,
 		0.5,
 		0.5,
-		ds,
-		dt,
+		1.0,
+		0.0,
 	};
 
 	GLuint VBO, VAO;
@@ -507,6 +952,9 @@ void drawSprite(GLuint shaderID, Sprite spr)
 
 	// Desenhar o sprite 1
 	glBindTexture(GL_TEXTURE_2D, spr.texID); // Conectando ao buffer de textura
+	// Retângulo do quadro atual, calculado na carga dos clipes
+	UVRect uv = spr.anim >= 0 ? animations.uv(spr.anim) : UVRect{0.0, 0.0, 1.0, 1.0};
+	glUniform4f(glGetUniformLocation(shaderID, "uv_rect"), uv.s0, uv.t0, uv.s1, uv.t1);
 	// Criação da  matriz de transformações do objeto
 	mat4 model = mat4(1); // matriz identidade
 	model = translate(model, spr.pos);
@@ -637,38 +1085,264 @@ int setupTileset(int nTiles, float &ds)
 	return VAO;
 }
 
-void drawTilemap(GLuint shaderID, Tileset tileset)
+// Nome, parallax e tinta de uma camada; os IDs são preenchidos em setupLayers
+static void setLayerParams(TileLayer &layer, const char *name, vec2 parallax, vec4 tint)
+{
+	layer.name = name;
+	layer.parallax = parallax;
+	layer.tint = tint;
+}
+
+// Preenche as camadas. O chão vem de groundRows; o fundo é um padrão de água e gelo;
+// decoração e sobreposição são tiles esparsos. A camada de colisão marca com
+// COLLISION_TILE as células de chão sólidas (pelas flags) e os buracos.
+void setupLayers()
 {
-	float x0 = tileset.dimensions.x/2.0;
-	float y0 = tileset.dimensions.y/2.0;
+	setLayerParams(layers[LAYER_BACK], "fundo", vec2(0.5, 0.5), vec4(0.7, 0.7, 0.8, 1.0));
+	setLayerParams(layers[LAYER_GROUND], "chao", vec2(1.0, 1.0), vec4(1.0, 1.0, 1.0, 1.0));
+	setLayerParams(layers[LAYER_DECOR], "decoracao", vec2(1.0, 1.0), vec4(1.0, 1.0, 1.0, 0.5));
+	setLayerParams(layers[LAYER_COLLISION], "colisao", vec2(1.0, 1.0), vec4(1.0, 0.3, 0.3, 0.0));
+	setLayerParams(layers[LAYER_OVERLAY], "sobreposicao", vec2(1.3, 1.3), vec4(1.0, 1.0, 1.0, 0.45));
 
+	for (int i = 0; i < MAP_HEIGHT; i++)
+	{
+		for (int j = 0; j < MAP_WIDTH; j++)
+		{
+			char c = groundRows[i][j];
+			int ground = c == '.' ? EMPTY_TILE : c - '0';
+			bool solid = ground == EMPTY_TILE || (tileFlags[ground] & TILE_SOLID);
+			layers[LAYER_BACK].ids[i][j] = ((i / 2) + (j / 3)) % 2 ? 4 : 5;
+			layers[LAYER_GROUND].ids[i][j] = ground;
+			layers[LAYER_DECOR].ids[i][j] = !solid && (i * 7 + j * 13) % 23 == 0 ? 6 : EMPTY_TILE;
+			layers[LAYER_COLLISION].ids[i][j] = solid ? COLLISION_TILE : EMPTY_TILE;
+			layers[LAYER_OVERLAY].ids[i][j] = (i * 5 + j * 11) % 17 == 0 ? 1 : EMPTY_TILE;
+		}
+	}
+}
 
-	for (int i = 0; i < MAP_HEIGHT; i++) // percorre as linhas do mapa
+// Cria a textura de índices: um texel R16UI por tile, uma fatia de um GL_TEXTURE_2D_ARRAY
+// por camada. Sem filtragem nem mipmaps: o shader lê o valor exato com texelFetch.
+GLuint setupLayersTexture()
+{
+	static GLushort ids[N_LAYERS][MAP_HEIGHT][MAP_WIDTH];
+	for (int l = 0; l < N_LAYERS; l++)
 	{
-		for (int j = 0; j < MAP_WIDTH; j++) // percorre as colunas do mapa
+		for (int i = 0; i < MAP_HEIGHT; i++)
 		{
-			int iTile = tilemap[i][j];
-			float offsetS = iTile * tileset.ds;
-			glUniform2f(glGetUniformLocation(shaderID, "offset_tex"), offsetS, 0.0);
-
-			vec3 tilePos;
-			tilePos.x = x0 + j * tileset.dimensions.x;
-			tilePos.y = HEIGHT - y0 - i * tileset.dimensions.y;
-			tilePos.z = 0.0;
-
-			// Neste código, usamos o mesmo buffer de geomtria para todos os sprites
-			glBindVertexArray(tileset.VAO); // Conectando ao buffer de geometria
-
-			// Desenhar o sprite 1
-			glBindTexture(GL_TEXTURE_2D, tileset.texID); // Conectando ao buffer de textura
-			// Criação da  matriz de transformações do objeto
-			mat4 model = mat4(1); // matriz identidade
-			model = translate(model, tilePos);
-			model = scale(model, tileset.dimensions);
-			glUniformMatrix4fv(glGetUniformLocation(shaderID, "model"), 1, GL_FALSE, value_ptr(model));
-			// Chamada de desenho - drawcall
-			// Poligono Preenchido - GL_TRIANGLES
-			glDrawArrays(GL_TRIANGLES, 0, 6);
+			for (int j = 0; j < MAP_WIDTH; j++)
+			{
+				ids[l][i][j] = (GLushort)layers[l].ids[i][j];
+			}
 		}
 	}
+
+	GLuint texID;
+	glGenTextures(1, &texID);
+	glBindTexture(GL_TEXTURE_2D_ARRAY, texID);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+	// Linhas de MAP_WIDTH * 2 bytes não precisam ser múltiplas de 4 (o alinhamento padrão)
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_R16UI, MAP_WIDTH, MAP_HEIGHT, N_LAYERS, 0,
+				 GL_RED_INTEGER, GL_UNSIGNED_SHORT, ids);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+	glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+	return texID;
+}
+
+// Textura R8 com um byte por célula do mapa (névoa, luz), começando zerada: nada visto,
+// nada aceso. O filtro linear suaviza a passagem de uma célula para a outra.
+GLuint setupCellTexture()
+{
+	static GLubyte zeros[MAP_HEIGHT][MAP_WIDTH];
+	memset(zeros, 0, sizeof(zeros));
+
+	GLuint texID;
+	glGenTextures(1, &texID);
+	glBindTexture(GL_TEXTURE_2D, texID);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, MAP_WIDTH, MAP_HEIGHT, 0, GL_RED, GL_UNSIGNED_BYTE, zeros);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+	glBindTexture(GL_TEXTURE_2D, 0);
+	return texID;
+}
+
+// Envia um retângulo de w x h células, a partir de (c0, r0), para uma textura de células
+void uploadCellRect(GLuint texID, int c0, int r0, int w, int h, const GLubyte *bytes)
+{
+	glBindTexture(GL_TEXTURE_2D, texID);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	glTexSubImage2D(GL_TEXTURE_2D, 0, c0, r0, w, h, GL_RED, GL_UNSIGNED_BYTE, bytes);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+	glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+// Envia só o retângulo da névoa que mudou desde o último envio
+void uploadFog(Tileset &tileset)
+{
+	int c0, r0, c1, r1;
+	if (!fog.dirtyRect(c0, r0, c1, r1))
+		return;
+	static GLubyte levels[MAP_HEIGHT * MAP_WIDTH];
+	int w = c1 - c0 + 1, h = r1 - r0 + 1;
+	for (int i = 0; i < h; i++)
+		for (int j = 0; j < w; j++)
+			levels[i * w + j] = fog.fogLevel(c0 + j, r0 + i);
+	uploadCellRect(tileset.fogTexID, c0, r0, w, h, levels);
+}
+
+// Idem para a luz: nível 0..LIGHT_MAX vira 0..255
+void uploadLight(Tileset &tileset)
+{
+	int c0, r0, c1, r1;
+	if (!lighting.dirtyRect(c0, r0, c1, r1))
+		return;
+	static GLubyte levels[MAP_HEIGHT * MAP_WIDTH];
+	int w = c1 - c0 + 1, h = r1 - r0 + 1;
+	for (int i = 0; i < h; i++)
+		for (int j = 0; j < w; j++)
+			levels[i * w + j] = (GLubyte)(lighting.level(c0 + j, r0 + i) * 255 / LIGHT_MAX);
+	uploadCellRect(tileset.lightTexID, c0, r0, w, h, levels);
+}
+
+// Liga/desliga (ou muda) a fonte de luz própria de uma célula: lava, tocha
+void setCellLight(int i, int j, int level)
+{
+	int &id = cellLight[i][j];
+	if (id >= 0 && level <= 0)
+	{
+		lighting.removeLight(id);
+		id = -1;
+	}
+	else if (id < 0 && level > 0)
+		id = lighting.addLight(j, i, level);
+	else if (id >= 0)
+		lighting.setLightLevel(id, level);
+}
+
+// Parallax e cor de todas as camadas, num glUniform por array. Só precisa ser chamada
+// quando algum desses valores muda (ex.: a tecla C liga a camada de colisão).
+void uploadLayerParams(GLuint shaderID)
+{
+	GLfloat parallax[N_LAYERS * 2], tint[N_LAYERS * 4];
+	for (int l = 0; l < N_LAYERS; l++)
+	{
+		memcpy(&parallax[l * 2], value_ptr(layers[l].parallax), 2 * sizeof(GLfloat));
+		memcpy(&tint[l * 4], value_ptr(layers[l].tint), 4 * sizeof(GLfloat));
+	}
+	glUseProgram(shaderID);
+	glUniform2fv(glGetUniformLocation(shaderID, "layer_parallax"), N_LAYERS, parallax);
+	glUniform4fv(glGetUniformLocation(shaderID, "layer_tint"), N_LAYERS, tint);
+}
+
+// Troca o tile (i, j) de uma camada: atualiza a matriz e só o texel dele na textura.
+// Uma mudança no chão refaz a célula correspondente da camada de colisão, da visão e da luz.
+void setTile(Tileset &tileset, int layer, int i, int j, int id)
+{
+	int oldId = layers[layer].ids[i][j];
+	layers[layer].ids[i][j] = id;
+
+	GLushort texel = (GLushort)id;
+	glBindTexture(GL_TEXTURE_2D_ARRAY, tileset.layersTexID);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, j, i, layer, 1, 1, 1, GL_RED_INTEGER, GL_UNSIGNED_SHORT, &texel);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+	glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+	if (layer == LAYER_GROUND)
+	{
+		bool solid = id == EMPTY_TILE || (tileFlags[id] & TILE_SOLID);
+		setTile(tileset, LAYER_COLLISION, i, j, solid ? COLLISION_TILE : EMPTY_TILE);
+		sightBlockers.setTile(j, i, id);
+		fog.tileChanged(j, i);
+		lighting.tileChanged(j, i);
+		// A lava acende a célula; trocar a lava por outro tile apaga
+		if (id == LAVA_TILE)
+			setCellLight(i, j, LAVA_LIGHT);
+		else if (oldId == LAVA_TILE)
+			setCellLight(i, j, 0);
+	}
+	else if (layer == LAYER_COLLISION)
+	{
+		collision.setTile(j, i, id);
+	}
+}
+
+// Desenha as camadas first..last com um único quad. O custo na CPU é o mesmo para
+// qualquer número de tiles visíveis e de camadas: o fragment shader percorre as camadas,
+// e as que não cobrem o pixel (fora do mapa ou vazias) são puladas. O quad cobre só a
+// parte da tela onde alguma das camadas tem tiles (com o zoom afastado, o mapa pode não
+// ocupar a tela toda).
+void drawTileLayers(GLuint shaderID, Tileset tileset, int first, int last, float time)
+{
+	// Retângulo de cada camada na tela, com o deslocamento do seu parallax, como no shader
+	vec2 mapMin(collision.colLeft(0), collision.rowTop(MAP_HEIGHT));
+	vec2 mapMax(collision.colLeft(MAP_WIDTH), collision.rowTop(0));
+	vec2 lo = camera.viewport, hi(0.0);
+	for (int l = first; l <= last; l++)
+	{
+		if (layers[l].tint.a <= 0.0f)
+			continue;
+		vec2 offset = camera.center * layers[l].parallax;
+		lo = min(lo, (mapMin - offset) * camera.zoom + camera.viewport * 0.5f);
+		hi = max(hi, (mapMax - offset) * camera.zoom + camera.viewport * 0.5f);
+	}
+	lo = max(lo, vec2(0.0));
+	hi = min(hi, camera.viewport);
+	if (lo.x >= hi.x || lo.y >= hi.y)
+		return;
+
+	glUseProgram(shaderID);
+	glUniform4f(glGetUniformLocation(shaderID, "view_rect"), lo.x, lo.y, hi.x, hi.y);
+	glUniform2f(glGetUniformLocation(shaderID, "camera"), camera.center.x, camera.center.y);
+	glUniform1f(glGetUniformLocation(shaderID, "zoom"), camera.zoom);
+	glUniform1f(glGetUniformLocation(shaderID, "time"), time);
+	glUniform1i(glGetUniformLocation(shaderID, "layer_first"), first);
+	glUniform1i(glGetUniformLocation(shaderID, "layer_last"), last);
+
+	glBindVertexArray(tileset.VAO); // Conectando ao buffer de geometria
+	glActiveTexture(GL_TEXTURE1);
+	glBindTexture(GL_TEXTURE_2D_ARRAY, tileset.layersTexID); // IDs dos tiles
+	glActiveTexture(GL_TEXTURE2);
+	glBindTexture(GL_TEXTURE_2D, tileset.fogTexID); // Névoa
+	glActiveTexture(GL_TEXTURE3);
+	glBindTexture(GL_TEXTURE_2D, tileset.lightTexID); // Luz (também lida pelos sprites)
+	glActiveTexture(GL_TEXTURE0);
+	glBindTexture(GL_TEXTURE_2D, tileset.texID); // Tileset
+
+	glDrawArrays(GL_TRIANGLES, 0, 6);
+	glBindVertexArray(0);
+}
+
+// Um passo fixo de simulação do sprite: movimento pelas teclas, barrado pelos tiles
+// sólidos (a animação avança em animations.update, para todos os sprites juntos)
+void updateSprite(Sprite &spr, float dt)
+{
+	spr.prevPos = spr.pos;
+	float dx = 0.0, dy = 0.0;
+	if (keys[GLFW_KEY_LEFT] == true || keys[GLFW_KEY_A] == true)
+	{
+		dx -= spr.vel * dt;
+	}
+	if (keys[GLFW_KEY_RIGHT] == true || keys[GLFW_KEY_D] == true)
+	{
+		dx += spr.vel * dt;
+	}
+	if (keys[GLFW_KEY_UP] == true || keys[GLFW_KEY_W] == true)
+	{
+		dy += spr.vel * dt;
+	}
+	if (keys[GLFW_KEY_DOWN] == true || keys[GLFW_KEY_S] == true)
+	{
+		dy -= spr.vel * dt;
+	}
+	controller.move(collision, spr.pos.x, spr.pos.y, dx, dy);
 }
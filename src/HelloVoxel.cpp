@@ -5,6 +5,15 @@
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
+// STB_IMAGE (leitura das imagens de referência do modo benchmark)
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb_image.h>
+
+// UBO compartilhado com as matrizes da câmera
+#include "CameraUBO.h"
+// Modo benchmark (--benchmark N): execução sem janela visível com roteiro fixo
+#include "Benchmark.h"
+
 using namespace std;
 
 int count = 0;
@@ -22,6 +31,7 @@ bool firstMouse = true;
 float lastX = WIDTH / 2.0f;
 float lastY = HEIGHT / 2.0f;
 float fov = 45.0f;
+const float zNear = 0.1f, zFar = 100.0f;
 
 // Controle de tempo entre frames
 float deltaTime = 0.0f;
@@ -31,6 +41,12 @@ float lastFrame = 0.0f;
 GLuint shaderID, VAO;
 GLFWwindow *window;
 
+// UBO com view e proj (bloco Camera nos shaders)
+CameraUBO cameraUBO;
+
+FrameProfiler profiler;
+BenchmarkHarness benchmark(profiler);
+
 struct Voxel
 {
     glm::vec3 pos;
@@ -60,8 +76,13 @@ const GLchar *vertexShaderSource = R"glsl(
     #version 450
     layout(location = 0) in vec3 position;
     uniform mat4 model;
-    uniform mat4 view;
-    uniform mat4 proj;
+    layout (std140, binding = 0) uniform Camera
+    {
+        mat4 view;
+        mat4 proj;
+        mat4 viewProj;
+        vec4 cameraPos;
+    };
     void main() {
         gl_Position = proj * view * model * vec4(position, 1.0);
     }
@@ -253,20 +274,10 @@ void processInput(GLFWwindow *window)
         cameraPos += glm::normalize(glm::cross(cameraFront, cameraUp)) * cameraSpeed;
 }
 
-// Define a matriz de visualização usando a posição e direção da câmera
-void especificaVisualizacao()
-{
-    glm::mat4 view = glm::lookAt(cameraPos, cameraPos + cameraFront, cameraUp);
-    GLuint loc = glGetUniformLocation(shaderID, "view");
-    glUniformMatrix4fv(loc, 1, GL_FALSE, glm::value_ptr(view));
-}
-
-// Define a matriz de projeção perspectiva com base no FOV
-void especificaProjecao()
+// Envia view e proj para o UBO da câmera (somente se a câmera mudou)
+void especificaCamera()
 {
-    glm::mat4 proj = glm::perspective(glm::radians(fov), (float)WIDTH / HEIGHT, 0.1f, 100.0f);
-    GLuint loc = glGetUniformLocation(shaderID, "proj");
-    glUniformMatrix4fv(loc, 1, GL_FALSE, glm::value_ptr(proj));
+    cameraUBO.update(cameraPos, cameraFront, cameraUp, fov, (float)WIDTH / HEIGHT, zNear, zFar);
 }
 
 void transformaObjeto(float xpos, float ypos, float zpos, float xrot, float yrot, float zrot, float sx, float sy, float sz)
@@ -380,18 +391,34 @@ void setColor(GLuint shaderID, glm::vec4 cor)
 }
 
 // Função principal da aplicação
-int main()
+int main(int argc, char **argv)
 {
-    glfwInit();
-    window = glfwCreateWindow(WIDTH, HEIGHT, "Camera Cube", nullptr, nullptr);
+    if (!benchmark.parseArgs(argc, argv))
+    {
+        std::cout << "Opcoes de benchmark invalidas" << std::endl;
+        return 1;
+    }
+    if (!benchmark.initGLFW())
+        return -1;
+    window = benchmark.createWindow(WIDTH, HEIGHT, "Camera Cube");
+    if (!window)
+    {
+        glfwTerminate();
+        return -1;
+    }
     glfwMakeContextCurrent(window);
     glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
     glfwSetCursorPosCallback(window, mouse_callback);
     glfwSetScrollCallback(window, scroll_callback);
     glfwSetKeyCallback(window, key_callback);
-    glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+    if (!benchmark.enabled())
+        glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
 
     gladLoadGLLoader((GLADloadproc)glfwGetProcAddress);
+    benchmark.setup();
+
+    // Cria o UBO da câmera e o liga ao ponto fixo CAMERA_UBO_BINDING
+    cameraUBO.init();
 
     shaderID = setupShader();
     VAO = setupGeometry();
@@ -423,21 +450,26 @@ int main()
 
     grid[selecaoY][selecaoX][selecaoZ].selecionado = true;
 
-    while (!glfwWindowShouldClose(window))
+    while (benchmark.running(window))
     {
         float currentFrame = glfwGetTime();
         deltaTime = currentFrame - lastFrame;
         lastFrame = currentFrame;
 
-        processInput(window);
+        // No benchmark a câmera segue o roteiro (volta em torno da grid) em vez do teclado
+        if (benchmark.enabled())
+            benchmark.orbitCamera(glm::vec3(0.0f), 20.0f, 8.0f, cameraPos, cameraFront);
+        else
+            processInput(window);
+
+        benchmark.beginFrame();
 
         glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
         glUseProgram(shaderID);
 
-        especificaVisualizacao();
-        especificaProjecao();
+        especificaCamera();
 
         // renderizar os objetos
         glBindVertexArray(VAO);
@@ -465,11 +497,14 @@ int main()
                 }
             }
         }
+        benchmark.endFrame();
         glfwSwapBuffers(window);
         glfwPollEvents();
     }
 
+    // Relatório do benchmark e, se pedida, comparação com a imagem de referência
+    bool passed = benchmark.finish("voxel");
     glDeleteVertexArrays(1, &VAO);
     glfwTerminate();
-    return 0;
+    return passed ? 0 : 1;
 }
\ No newline at end of file
@@ -0,0 +1,472 @@
+/*
+ * HelloVoxelWorld - mundo de voxels em chunks desenhado com multi-draw indireto
+ *
+ * Diferente do HelloMinecraft (um draw por voxel), aqui o mundo é dividido em chunks de
+ * 16x16x16 blocos. Cada chunk vira uma malha só com as faces visíveis; todas as malhas
+ * moram em duas arenas (vértices e índices) e, depois do teste de frustum, o mundo inteiro
+ * é desenhado com um único glMultiDrawElementsIndirect (ver Common/ChunkRenderer.h).
+ *
+ * A luz do sol e dos blocos de mel (Common/VoxelLight.h) é calculada uma vez depois do
+ * terreno e refeita só em volta de cada bloco editado; o valor de cada canto vai no
+ * vértice, junto com a oclusão ambiente.
+ *
+ * Controles:
+ *   W/A/S/D + mouse: movimenta a câmera; scroll: zoom
+ *   DELETE: remove o bloco para onde a câmera aponta
+ *   V: coloca um bloco na frente do bloco apontado
+ *   L: coloca um bloco de mel, que brilha, na frente do bloco apontado
+ *   M: imprime o relatório de memória das malhas, chunk a chunk
+ *
+ * Requer OpenGL 4.3 (glMultiDrawElementsIndirect); com 4.2 cai para um draw por chunk.
+ */
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cmath>
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+// STB_IMAGE
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb_image.h>
+
+#include "CameraUBO.h"
+#include "ChunkRenderer.h"
+#include "VoxelLight.h"
+#include "Benchmark.h"
+
+using namespace std;
+
+// Dimensões da janela
+const GLuint WIDTH = 800, HEIGHT = 600;
+
+// Tamanho do mundo em chunks (40 x 8 x 40 = 12800 chunks de 16^3)
+const int WORLD_CHUNKS_X = 40, WORLD_CHUNKS_Y = 8, WORLD_CHUNKS_Z = 40;
+
+// Variáveis globais de controle da câmera (posição, direção e orientação)
+glm::vec3 cameraPos = glm::vec3(0.0f, 0.0f, 0.0f);
+glm::vec3 cameraFront = glm::vec3(0.0f, 0.0f, -1.0f);
+glm::vec3 cameraUp = glm::vec3(0.0f, 1.0f, 0.0f);
+float yaw = -90.0f;
+float pitch = 0.0f;
+bool firstMouse = true;
+float lastX = WIDTH / 2.0f;
+float lastY = HEIGHT / 2.0f;
+float fov = 60.0f;
+const float zNear = 0.1f, zFar = 1000.0f;
+
+// Controle de tempo entre frames
+float deltaTime = 0.0f;
+float lastFrame = 0.0f;
+
+GLuint shaderID;
+GLFWwindow *window;
+
+CameraUBO cameraUBO;
+VoxelWorld world;
+VoxelLighting lighting;
+ChunkRenderer chunkRenderer;
+
+FrameProfiler profiler;
+BenchmarkHarness benchmark(profiler);
+
+// Texturas dos blocos, na ordem de BlockType (camada = tipo - 1)
+const char *blockTextureFiles[] = {
+    "../assets/block_tex/grass_block_side.png",
+    "../assets/block_tex/packed_mud.png",
+    "../assets/block_tex/polished_blackstone_bricks.png",
+    "../assets/block_tex/moss_block.png",
+    "../assets/block_tex/gold_block.png",
+    "../assets/block_tex/sponge.png",
+    "../assets/block_tex/honey_block_top.png",
+    "../assets/block_tex/frosted_ice_0.png",
+    "../assets/block_tex/loom_bottom.png",
+    "../assets/block_tex/muddy_mangrove_roots_side.png",
+};
+
+// Código do Vertex Shader
+const GLchar *vertexShaderSource = R"glsl(
+ #version 450
+ layout (location = 0) in uvec2 packed_vertex;
+ layout (location = 3) in vec4 chunk_origin;
+ uniform vec4 chunk_offset; // origem do chunk quando o driver não tem baseInstance
+
+ layout (std140, binding = 0) uniform Camera
+ {
+     mat4 view;
+     mat4 proj;
+     mat4 viewProj;
+     vec4 cameraPos;
+ };
+ out vec3 tex_coord;
+ out float ao_factor;
+ out vec3 light_color;
+
+ // Cor da luz dos blocos (o mel brilha amarelado); o sol é branco
+ const vec3 BLOCK_LIGHT_COLOR = vec3(1.0, 0.8, 0.5);
+
+ const vec2 CORNER_UV[4] = vec2[](vec2(0.0, 0.0), vec2(1.0, 0.0), vec2(1.0, 1.0), vec2(0.0, 1.0));
+
+ void main()
+ {
+	// Decodifica o vértice de 8 bytes (layout em Common/ChunkMesher.h)
+	uint a = packed_vertex.x;
+	uint b = packed_vertex.y;
+	vec3 position = vec3(float(a & 31u), float((a >> 5) & 31u), float((a >> 10) & 31u));
+	uint corner = (a >> 18) & 3u;
+	float ao = float((a >> 20) & 3u) / 3.0;
+	float layer = float(b & 0xFFFFu);
+	float sun = float((b >> 16) & 15u);
+	float block_light = float((b >> 20) & 15u);
+
+	vec2 texc = CORNER_UV[corner];
+	tex_coord = vec3(texc.s, 1.0 - texc.t, layer);
+	ao_factor = 0.4 + 0.6 * ao;
+	// Cada nível a menos escurece 20%; um mínimo para as cavernas não ficarem pretas
+	vec3 sun_color = vec3(pow(0.8, 15.0 - sun));
+	vec3 block_color = BLOCK_LIGHT_COLOR * pow(0.8, 15.0 - block_light);
+	light_color = max(max(sun_color, block_color), vec3(0.05));
+	gl_Position = viewProj * vec4(chunk_origin.xyz + chunk_offset.xyz + position, 1.0);
+ }
+ )glsl";
+
+// Código do Fragment Shader
+const GLchar *fragmentShaderSource = R"glsl(
+ #version 450
+in vec3 tex_coord;
+in float ao_factor;
+in vec3 light_color;
+out vec4 color;
+uniform sampler2DArray tex_blocks;
+void main()
+{
+	 color = texture(tex_blocks, tex_coord);
+	 color.rgb *= ao_factor * light_color;
+}
+)glsl";
+
+// Cabeçalhos de algumas funções
+GLuint loadTextureArray(const char *files[], int count);
+bool raycastBlock(glm::ivec3 &hit, glm::ivec3 &before);
+
+// Atualiza o viewport ao redimensionar a janela
+void framebuffer_size_callback(GLFWwindow *window, int width, int height)
+{
+    glViewport(0, 0, width, height);
+}
+
+// Callback para movimentação do mouse — controla rotação da câmera
+void mouse_callback(GLFWwindow *window, double xpos, double ypos)
+{
+    if (firstMouse)
+    {
+        lastX = xpos;
+        lastY = ypos;
+        firstMouse = false;
+    }
+    float xoffset = xpos - lastX;
+    float yoffset = lastY - ypos;
+    lastX = xpos;
+    lastY = ypos;
+
+    float sensitivity = 0.05f;
+    xoffset *= sensitivity;
+    yoffset *= sensitivity;
+
+    yaw += xoffset;
+    pitch += yoffset;
+
+    if (pitch > 89.0f)
+        pitch = 89.0f;
+    if (pitch < -89.0f)
+        pitch = -89.0f;
+
+    glm::vec3 front;
+    front.x = cos(glm::radians(yaw)) * cos(glm::radians(pitch));
+    front.y = sin(glm::radians(pitch));
+    front.z = sin(glm::radians(yaw)) * cos(glm::radians(pitch));
+    cameraFront = glm::normalize(front);
+
+    glm::vec3 right = glm::normalize(glm::cross(cameraFront, glm::vec3(0.0, 1.0, 0.0)));
+    cameraUp = glm::normalize(glm::cross(right, cameraFront));
+}
+
+// Callback de scroll — altera o FOV (zoom)
+void scroll_callback(GLFWwindow *window, double xoffset, double yoffset)
+{
+    if (fov >= 1.0f && fov <= 120.0f)
+        fov -= yoffset;
+    if (fov <= 1.0f)
+        fov = 1.0f;
+    if (fov >= 120.0f)
+        fov = 120.0f;
+}
+
+// Troca um bloco e refaz a luz em volta dele. Só marca os chunks afetados (pelo bloco e
+// pela luz); a malha é refeita no próximo frame.
+void editBlock(const glm::ivec3 &p, uint8_t type)
+{
+    if (world.getBlock(p.x, p.y, p.z) == type)
+        return;
+    world.setBlock(p.x, p.y, p.z, type);
+    lighting.blockChanged(p.x, p.y, p.z);
+    lighting.update();
+}
+
+void key_callback(GLFWwindow *window, int key, int scancode, int action, int mode)
+{
+    glm::ivec3 hit, before;
+    if (key == GLFW_KEY_DELETE && action == GLFW_PRESS)
+    {
+        if (raycastBlock(hit, before))
+            editBlock(hit, BLOCK_AIR);
+    }
+    if (key == GLFW_KEY_V && action == GLFW_PRESS)
+    {
+        if (raycastBlock(hit, before))
+            editBlock(before, BLOCK_MOSS);
+    }
+    if (key == GLFW_KEY_L && action == GLFW_PRESS)
+    {
+        if (raycastBlock(hit, before))
+            editBlock(before, BLOCK_HONEY);
+    }
+    if (key == GLFW_KEY_M && action == GLFW_PRESS)
+    {
+        chunkRenderer.printMemoryReport(world, true);
+    }
+}
+
+// Processa as teclas pressionadas para movimentar a câmera no espaço 3D
+void processInput(GLFWwindow *window)
+{
+    float cameraSpeed = 20.0f * deltaTime;
+    if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
+        glfwSetWindowShouldClose(window, true);
+    if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS)
+        cameraPos += cameraSpeed * cameraFront;
+    if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS)
+        cameraPos -= cameraSpeed * cameraFront;
+    if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS)
+        cameraPos -= glm::normalize(glm::cross(cameraFront, cameraUp)) * cameraSpeed;
+    if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)
+        cameraPos += glm::normalize(glm::cross(cameraFront, cameraUp)) * cameraSpeed;
+}
+
+// Anda pelo raio da câmera em passos pequenos até achar um bloco sólido (alcance de 8 blocos).
+// "before" é a última célula vazia antes do bloco, onde um bloco novo seria colocado.
+bool raycastBlock(glm::ivec3 &hit, glm::ivec3 &before)
+{
+    glm::ivec3 last((int)floor(cameraPos.x), (int)floor(cameraPos.y), (int)floor(cameraPos.z));
+    for (float t = 0.0f; t < 8.0f; t += 0.05f)
+    {
+        glm::vec3 p = cameraPos + cameraFront * t;
+        glm::ivec3 cell((int)floor(p.x), (int)floor(p.y), (int)floor(p.z));
+        if (world.getBlock(cell.x, cell.y, cell.z) != BLOCK_AIR)
+        {
+            hit = cell;
+            before = last;
+            return true;
+        }
+        last = cell;
+    }
+    return false;
+}
+
+// Compila shaders e cria o programa de shader
+GLuint setupShader()
+{
+    GLint success;
+    GLchar infoLog[512];
+
+    GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
+    glShaderSource(vertexShader, 1, &vertexShaderSource, nullptr);
+    glCompileShader(vertexShader);
+    glGetShaderiv(vertexShader, GL_COMPILE_STATUS, &success);
+    if (!success)
+    {
+        glGetShaderInfoLog(vertexShader, 512, nullptr, infoLog);
+        cout << "Vertex Shader error:\n"
+             << infoLog << endl;
+    }
+
+    GLuint fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
+    glShaderSource(fragmentShader, 1, &fragmentShaderSource, nullptr);
+    glCompileShader(fragmentShader);
+    glGetShaderiv(fragmentShader, GL_COMPILE_STATUS, &success);
+    if (!success)
+    {
+        glGetShaderInfoLog(fragmentShader, 512, nullptr, infoLog);
+        cout << "Fragment Shader error:\n"
+             << infoLog << endl;
+    }
+
+    GLuint shaderProgram = glCreateProgram();
+    glAttachShader(shaderProgram, vertexShader);
+    glAttachShader(shaderProgram, fragmentShader);
+    glLinkProgram(shaderProgram);
+    glGetProgramiv(shaderProgram, GL_LINK_STATUS, &success);
+    if (!success)
+    {
+        glGetProgramInfoLog(shaderProgram, 512, nullptr, infoLog);
+        cout << "Shader Program Linking error:\n"
+             << infoLog << endl;
+    }
+
+    glDeleteShader(vertexShader);
+    glDeleteShader(fragmentShader);
+
+    return shaderProgram;
+}
+
+// Função principal da aplicação
+int main(int argc, char **argv)
+{
+    if (!benchmark.parseArgs(argc, argv))
+    {
+        std::cout << "Opcoes de benchmark invalidas" << std::endl;
+        return 1;
+    }
+    if (!benchmark.initGLFW())
+        return -1;
+    window = benchmark.createWindow(WIDTH, HEIGHT, "Voxel World -- Multi-Draw Indirect");
+    if (!window)
+    {
+        glfwTerminate();
+        return -1;
+    }
+    glfwMakeContextCurrent(window);
+    glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
+    glfwSetCursorPosCallback(window, mouse_callback);
+    glfwSetScrollCallback(window, scroll_callback);
+    glfwSetKeyCallback(window, key_callback);
+    if (!benchmark.enabled())
+        glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+
+    gladLoadGLLoader((GLADloadproc)glfwGetProcAddress);
+    benchmark.setup();
+
+    cameraUBO.init();
+    shaderID = setupShader();
+
+    glEnable(GL_DEPTH_TEST);
+    glDepthFunc(GL_LESS);
+    glEnable(GL_CULL_FACE);
+
+    GLuint texArray = loadTextureArray(blockTextureFiles, N_BLOCK_TYPES - 1);
+
+    // Gera o terreno e a malha inicial de todos os chunks
+    world.init(WORLD_CHUNKS_X, WORLD_CHUNKS_Y, WORLD_CHUNKS_Z);
+    world.generateTerrain();
+    lighting.init(world);
+    double tl = glfwGetTime();
+    lighting.computeAll();
+    cout << "Luz calculada em " << (glfwGetTime() - tl) * 1000.0 << " ms" << endl;
+
+    // Capacidade inicial das arenas (vértices, índices) suficiente para o terreno gerado
+    chunkRenderer.init(world, 6 * 1024 * 1024, 9 * 1024 * 1024);
+    double t0 = glfwGetTime();
+    int meshed = chunkRenderer.rebuildDirty(world);
+    double t1 = glfwGetTime();
+    cout << "Chunks: " << world.chunkCount() << ", malhas geradas: " << meshed
+         << " em " << (t1 - t0) * 1000.0 << " ms" << endl;
+    chunkRenderer.printMemoryReport(world, false);
+
+    cameraPos = glm::vec3(world.sizeX() * 0.5f, world.sizeY() * 0.3f + 30.0f, world.sizeZ() * 0.5f);
+
+    glUseProgram(shaderID);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, texArray);
+    glUniform1i(glGetUniformLocation(shaderID, "tex_blocks"), 0);
+    chunkRenderer.setOriginUniform(glGetUniformLocation(shaderID, "chunk_offset"));
+
+    double title_countdown_s = 0.5;
+
+    // Centro do roteiro do benchmark: a câmera sobrevoa o terreno em círculo
+    glm::vec3 worldCenter(world.sizeX() * 0.5f, world.sizeY() * 0.3f, world.sizeZ() * 0.5f);
+
+    while (benchmark.running(window))
+    {
+        float currentFrame = glfwGetTime();
+        deltaTime = currentFrame - lastFrame;
+        lastFrame = currentFrame;
+
+        if (benchmark.enabled())
+            benchmark.orbitCamera(worldCenter, world.sizeX() * 0.35f, 40.0f, cameraPos, cameraFront);
+        else
+            processInput(window);
+
+        benchmark.beginFrame();
+
+        // Refaz apenas os chunks alterados desde o último frame
+        chunkRenderer.rebuildDirty(world);
+
+        glClearColor(0.5f, 0.7f, 0.9f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+        cameraUBO.update(cameraPos, cameraFront, cameraUp, fov, (float)WIDTH / HEIGHT, zNear, zFar);
+
+        glUseProgram(shaderID);
+        chunkRenderer.draw(cameraUBO.data().viewProj);
+        benchmark.endFrame();
+
+        title_countdown_s -= deltaTime;
+        if (title_countdown_s <= 0.0 && deltaTime > 0.0f)
+        {
+            char tmp[256];
+            sprintf(tmp, "Voxel World -- FPS %.1f -- chunks visiveis %d de %d", 1.0 / deltaTime,
+                    chunkRenderer.visibleChunks, chunkRenderer.drawableChunks);
+            glfwSetWindowTitle(window, tmp);
+            title_countdown_s = 0.5;
+        }
+
+        glfwSwapBuffers(window);
+        glfwPollEvents();
+    }
+
+    // Relatório do benchmark e, se pedida, comparação com a imagem de referência
+    bool passed = benchmark.finish("voxel_world");
+    chunkRenderer.destroy();
+    glfwTerminate();
+    return passed ? 0 : 1;
+}
+
+// Carrega várias imagens do mesmo tamanho como camadas de uma GL_TEXTURE_2D_ARRAY
+GLuint loadTextureArray(const char *files[], int count)
+{
+    GLuint texID;
+    glGenTextures(1, &texID);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, texID);
+
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+    const int SIZE = 16; // todas as texturas de block_tex são 16x16
+    glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA8, SIZE, SIZE, count, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+
+    for (int i = 0; i < count; i++)
+    {
+        int width, height, nrChannels;
+        // Força 4 canais para que todas as camadas tenham o mesmo formato
+        unsigned char *data = stbi_load(files[i], &width, &height, &nrChannels, 4);
+        if (data && width == SIZE && height == SIZE)
+        {
+            glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, i, SIZE, SIZE, 1, GL_RGBA, GL_UNSIGNED_BYTE, data);
+        }
+        else
+        {
+            std::cout << "Failed to load texture " << files[i] << std::endl;
+        }
+        stbi_image_free(data);
+    }
+    glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+    return texID;
+}